@@ -129,10 +129,19 @@ local function StoreOriginalBounds(ent)
     originalBounds[ent] = {mins = mins, maxs = maxs}
 end
 
+-- Hands an entity's default render bounds to the native batch update, or
+-- takes them back for entities that get bounds of their own
+local function SetNativeBoundsManaged(ent, managed)
+    if EntityManager and EntityManager.SetEntityBoundsManaged then
+        EntityManager.SetEntityBoundsManaged(ent, managed)
+    end
+end
+
 -- RTX updater cache management functions
 local function AddToRTXCache(ent)
     if not IsValid(ent) or rtxUpdaterCache[ent] then return end
     if IsRTXUpdater(ent) then
+        SetNativeBoundsManaged(ent, false)
         rtxUpdaterCache[ent] = true
         rtxUpdaterCount = rtxUpdaterCount + 1
         
@@ -163,6 +172,8 @@ end
 -- Set bounds for a single entity
 local function SetEntityBounds(ent, useOriginal)
     if not IsValid(ent) then return end
+    -- Only the default branch below leaves the bounds to the batch update
+    SetNativeBoundsManaged(ent, false)
     
     if useOriginal then
         if originalBounds[ent] then
@@ -258,16 +269,47 @@ elseif ent:GetClass() == "hdri_cube_editor" then
             ent:SetColor(Color(255, 255, 255, 1))
         end
     else
-        -- Default bounds with native check
-        if RTXMath_IsWithinBounds(entPos, mins, maxs) then
-            ent:SetRenderBounds(mins, maxs)
-        end
+        -- Default bounds are applied by the batch update in FR_EntitySync,
+        -- which tests the synced position against them every frame
+        SetNativeBoundsManaged(ent, true)
     end
 end
 
-local function BatchUpdateEntities(entities)
-    -- Call our native implementation
-    EntityManager.BatchUpdateEntityBounds(entities, mins, maxs)
+-- Applies the default bounds to every handed-over entity inside them;
+-- positions come from the native entity table, so this costs no
+-- per-entity GetPos. Entities that already have these bounds are skipped.
+-- Returns the applied and skipped counts.
+local function BatchUpdateEntities()
+    return EntityManager.BatchUpdateEntityBounds(mins, maxs)
+end
+
+-- Mirror entity positions into the native table once per frame, then give
+-- default bounds to entities that have moved inside them
+hook.Add("Think", "FR_EntitySync", function()
+    if not cv_enabled:GetBool() or not EntityManager or not EntityManager.SyncEntities then return end
+    EntityManager.SyncEntities(ents.GetAll())
+    BatchUpdateEntities()
+end)
+
+-- NikNaks static props of the current map in the order they were indexed
+-- natively; nil until BuildStaticPropIndex has run for this map
+local staticPropList = nil
+
+-- Builds the native BVH over static prop origins, once per map
+local function BuildStaticPropIndex()
+    staticPropList = {}
+    -- The module outlives map changes, so drop the previous map's props first
+    EntityManager.ClearStaticPropIndex()
+    if not (NikNaks and NikNaks.CurrentMap) then return end
+
+    local positions = {}
+    for _, propData in pairs(NikNaks.CurrentMap:GetStaticProps()) do
+        local index = #staticPropList + 1
+        staticPropList[index] = propData
+        positions[index] = propData:GetPos()
+    end
+
+    EntityManager.BuildStaticPropIndex(positions)
 end
 
 -- Create clientside static props
@@ -283,29 +325,28 @@ local function CreateStaticProps()
     -- Disable engine props before creating our own
     RunConsoleCommand("r_drawstaticprops", "1")
 
-    local props = NikNaks.CurrentMap:GetStaticProps()
+    if not staticPropList then BuildStaticPropIndex() end
 
     local maxDistance = 16384
-    local maxDistSqr = maxDistance * maxDistance
     local playerPos = LocalPlayer():GetPos()
 
-    for _, propData in pairs(props) do
-        local propPos = propData:GetPos()
-        if RTXMath_DistToSqr(propPos, playerPos) <= maxDistSqr then
-            local prop = ClientsideModel(propData:GetModel())
-            if IsValid(prop) then
-                prop:SetPos(propPos)
-                prop:SetAngles(propData:GetAngles())
-                prop:SetRenderBounds(mins, maxs)
-                prop:SetColor(propData:GetColor())
-                prop:SetSkin(propData:GetSkin())
-                local scale = propData:GetScale()
-                if scale != 1 then
-                    prop:SetModelScale(scale)
-                end
-                prop:SetPredictable(false)
-                table.insert(staticProps, prop)
+    -- Only the props in range come back from the BVH
+    local inRange = EntityManager.QueryStaticPropsRadius(playerPos, maxDistance)
+    for _, index in ipairs(inRange) do
+        local propData = staticPropList[index]
+        local prop = ClientsideModel(propData:GetModel())
+        if IsValid(prop) then
+            prop:SetPos(propData:GetPos())
+            prop:SetAngles(propData:GetAngles())
+            prop:SetRenderBounds(mins, maxs)
+            prop:SetColor(propData:GetColor())
+            prop:SetSkin(propData:GetSkin())
+            local scale = propData:GetScale()
+            if scale != 1 then
+                prop:SetModelScale(scale)
             end
+            prop:SetPredictable(false)
+            table.insert(staticProps, prop)
         end
     end
 end
@@ -331,6 +372,7 @@ end)
 -- Initial setup
 hook.Add("InitPostEntity", "InitialBoundsSetup", function()
     timer.Simple(1, function()
+        BuildStaticPropIndex()
         if cv_enabled:GetBool() then
             UpdateAllEntities(false)
             CreateStaticProps()
@@ -369,6 +411,9 @@ cvars.AddChangeCallback("fr_enabled", function(_, _, new)
         RunConsoleCommand("r_drawstaticprops", "1")
     else
         UpdateAllEntities(true)
+        if EntityManager and EntityManager.ClearEntities then
+            EntityManager.ClearEntities()
+        end
         -- Remove static props
         for _, prop in pairs(staticProps) do
             if IsValid(prop) then
@@ -471,6 +516,10 @@ end)
 hook.Add("EntityRemoved", "CleanupRTXCache", function(ent)
     RemoveFromRTXCache(ent)
     originalBounds[ent] = nil
+    -- Drop it now; its index may be reused before the next sync
+    if EntityManager and EntityManager.RemoveEntity then
+        EntityManager.RemoveEntity(ent)
+    end
 end)
 
 -- Debug command
@@ -482,6 +531,15 @@ concommand.Add("fr_debug", function()
     print("Static Props Count:", #staticProps)
     print("Stored Original Bounds:", table.Count(originalBounds))
     print("RTX Updaters (Cached):", rtxUpdaterCount)
+
+    if EntityManager and EntityManager.GetEntityRegistryStats then
+        local stats = EntityManager.GetEntityRegistryStats()
+        print(string.format("Native Entity Table: %d entities, %d classes, last sync %.3f ms (+%d/-%d)",
+            stats.entities, stats.classes, stats.syncMs, stats.added, stats.removed))
+        print(string.format("Render Bounds Updates: last batch %d applied, %d skipped (%d/%d over %d batches)",
+            stats.boundsApplied, stats.boundsSkipped, stats.boundsAppliedTotal, stats.boundsSkippedTotal,
+            stats.boundsCalls))
+    end
     
     -- Special entities debug info
     print("\nSpecial Entity Classes:")
@@ -9,7 +9,17 @@ local CONVARS = {
     DEBUG = CreateClientConVar("rtx_force_render_debug", "0", true, false, "Shows debug info for mesh rendering"),
     CHUNK_SIZE = CreateClientConVar("rtx_chunk_size", "65536", true, false, "Size of chunks for mesh combining"),
     CAPTURE_MODE = CreateClientConVar("rtx_capture_mode", "0", true, false, "Toggles r_drawworld for capture mode"),
-    BOUNDS_PADDING = CreateClientConVar("rtx_bounds_padding", "128", true, false, "Padding added to map bounds for geometry inclusion")
+    BOUNDS_PADDING = CreateClientConVar("rtx_bounds_padding", "128", true, false, "Padding added to map bounds for geometry inclusion"),
+    COMPACT_VERTICES = CreateClientConVar("rtx_compact_vertices", "0", true, false, "Keep native world mesh buffers with small UV ranges in the 20-byte compact vertex layout (half-float UVs)"),
+    MESH_CACHE = CreateClientConVar("rtx_mesh_cache", "1", true, false, "Cache built chunk meshes in data/rtx_mesh_cache and reuse them on the next load"),
+    CHUNK_CULLING = CreateClientConVar("rtx_chunk_culling", "1", true, false, "Skip world meshes outside the view frustum"),
+    CULL_DISTANCE = CreateClientConVar("rtx_chunk_cull_distance", "0", true, false, "Skip world meshes farther away than this (0 = unlimited)"),
+    CHUNK_PVS = CreateClientConVar("rtx_chunk_pvs", "0", true, false, "Also skip world meshes outside the map's potentially visible set"),
+    CHUNK_LODS = CreateClientConVar("rtx_chunk_lods", "0", true, false, "Simplified LOD meshes built per world chunk mesh, 0-3 (applies on rebuild)"),
+    LOD_THRESHOLD = CreateClientConVar("rtx_chunk_lod_threshold", "0.25", true, false, "Projected size (chunk radius over view half-width) below which chunks switch to their next LOD"),
+    MERGE_FACES = CreateClientConVar("rtx_merge_coplanar_faces", "1", true, false, "Merge adjacent coplanar brush faces with the same material and texture mapping before triangulating (applies on map load)"),
+    BUILD_BUDGET = CreateClientConVar("rtx_mesh_build_budget", "4", true, false, "Milliseconds per frame spent building native world meshes; 0 builds them all at once during load"),
+    REMIX_DIRECT = CreateClientConVar("rtx_remix_direct_meshes", "0", true, false, "Hand native world meshes straight to the Remix API instead of building Source meshes (experimental, applies on rebuild)")
 }
 
 -- Local Variables and Caches
@@ -20,6 +30,18 @@ local mapMeshes = {
 local isEnabled = false
 local renderStats = {draws = 0}
 local materialCache = {}
+-- Native meshes by the id their bounds were registered under with EntityManager.AddChunkBounds
+local chunkDraws = {}
+local visibleChunks = {}
+local visibleLods = {}
+-- Sorted visible list for the current frame: opaque draws first, then translucent from firstTranslucent on
+local drawList = { frame = -1, count = 0, firstTranslucent = 1 }
+-- Chunks whose geometry lives in Remix; the native side draws them every frame
+local remixChunkCount = 0
+local remixDrawFrame = -1
+-- Incremental native build in progress: progress = {done, total, cached}
+local nativeBuild = nil
+local CULL_FOV_PADDING = 10 -- Degrees, keeps geometry just off-screen in the ray traced scene
 local Vector = Vector
 local math_min = math.min
 local math_max = math.max
@@ -29,6 +51,7 @@ local table_insert = table.insert
 local MAX_VERTICES = 10000
 local MAX_CHUNK_VERTS = 32768
 local boundingRegions = {}
+local faceRegions = {} -- NikNaks face -> region from ClassifyRegions
 local isDrawingSkybox = false
 local lastSkyState = GetConVar("r_3dsky"):GetBool()
 local disclaimerShown = false
@@ -231,54 +254,6 @@ local function MapTable(tbl, func)
     return mapped
 end
 
-local function CalculateRegionBounds(vertices)
-    local mins = Vector(math_huge, math_huge, math_huge)
-    local maxs = Vector(-math_huge, -math_huge, -math_huge)
-    local vertCount = #vertices
-    local center = Vector(0, 0, 0)
-    
-    for _, vert in ipairs(vertices) do
-        mins.x = math_min(mins.x, vert.x)
-        mins.y = math_min(mins.y, vert.y)
-        mins.z = math_min(mins.z, vert.z)
-        maxs.x = math_max(maxs.x, vert.x)
-        maxs.y = math_max(maxs.y, vert.y)
-        maxs.z = math_max(maxs.z, vert.z)
-        center:Add(vert)
-    end
-    
-    center:Div(vertCount)
-    
-    return {
-        mins = mins,
-        maxs = maxs,
-        center = center,
-        size = maxs - mins
-    }
-end
-
-local function IsRegionConnected(regionA, regionB)
-    local gap_threshold = 1024 -- Smaller threshold for direct connections
-    
-    -- Check if regions are directly adjacent or overlapping on any axis
-    local isConnectedX = (regionA.maxs.x + gap_threshold) >= regionB.mins.x and
-                        (regionB.maxs.x + gap_threshold) >= regionA.mins.x
-    local isConnectedY = (regionA.maxs.y + gap_threshold) >= regionB.mins.y and
-                        (regionB.maxs.y + gap_threshold) >= regionA.mins.y
-    local isConnectedZ = (regionA.maxs.z + gap_threshold) >= regionB.mins.z and
-                        (regionB.maxs.z + gap_threshold) >= regionA.mins.z
-    
-    -- Check if regions share a plane (like different floors of a building)
-    local sharesPlanXY = math.abs(regionA.center.z - regionB.center.z) < gap_threshold * 2
-    local sharesPlanXZ = math.abs(regionA.center.y - regionB.center.y) < gap_threshold * 2
-    local sharesPlanYZ = math.abs(regionA.center.x - regionB.center.x) < gap_threshold * 2
-    
-    return (isConnectedX and isConnectedY) or
-           (isConnectedY and isConnectedZ) or
-           (isConnectedX and isConnectedZ) or
-           sharesPlanXY or sharesPlanXZ or sharesPlanYZ
-end
-
 local function IsPointInRegion(point, region, tolerance)
     tolerance = tolerance or 0
     return point.x >= (region.mins.x - tolerance) and point.x <= (region.maxs.x + tolerance) and
@@ -286,14 +261,17 @@ local function IsPointInRegion(point, region, tolerance)
            point.z >= (region.mins.z - tolerance) and point.z <= (region.maxs.z + tolerance)
 end
 
+-- Groups every face into connected regions natively (grid hash + union-find)
+-- and remembers each face's region, so the per-face check is a table lookup
 local function IdentifyMapRegions()
     boundingRegions = {}
-    local initialRegions = {}
-    local processedCount = 0
-    
-    print("[RTX Fixes] Starting intelligent region identification...")
-    
-    -- First pass: Create initial regions based on spatial proximity
+    faceRegions = {}
+
+    if not EntityManager or not EntityManager.ClassifyRegions then return end
+
+    local faces = {}
+    local faceVertices = {}
+    local seen = {}
     for _, leaf in pairs(NikNaks.CurrentMap:GetLeafs()) do
         if not leaf or leaf:IsOutsideMap() then continue end
         
@@ -301,72 +279,29 @@ local function IdentifyMapRegions()
         if not leafFaces then continue end
         
         for _, face in pairs(leafFaces) do
-            if not face then continue end
+            if not face or seen[face] then continue end
+            seen[face] = true
             
             local vertices = face:GetVertexs()
             if not vertices or #vertices == 0 then continue end
             
-            local bounds = CalculateRegionBounds(vertices)
-            
-            -- Find a region to merge with
-            local mergedWithExisting = false
-            for _, region in ipairs(initialRegions) do
-                if IsRegionConnected(bounds, region) then
-                    -- Expand existing region
-                    region.mins.x = math_min(region.mins.x, bounds.mins.x)
-                    region.mins.y = math_min(region.mins.y, bounds.mins.y)
-                    region.mins.z = math_min(region.mins.z, bounds.mins.z)
-                    region.maxs.x = math_max(region.maxs.x, bounds.maxs.x)
-                    region.maxs.y = math_max(region.maxs.y, bounds.maxs.y)
-                    region.maxs.z = math_max(region.maxs.z, bounds.maxs.z)
-                    region.size = region.maxs - region.mins
-                    region.center = (region.maxs + region.mins) / 2
-                    region.faceCount = (region.faceCount or 0) + 1
-                    mergedWithExisting = true
-                    break
-                end
-            end
-            
-            if not mergedWithExisting then
-                bounds.faceCount = 1
-                table_insert(initialRegions, bounds)
-            end
-            
-            processedCount = processedCount + 1
-            if processedCount % 5000 == 0 then
-                print(string.format("[RTX Fixes] Processed %d faces...", processedCount))
-            end
+            local index = #faces + 1
+            faces[index] = face
+            faceVertices[index] = vertices
         end
     end
     
-    -- Second pass: Merge connected regions and identify main play area
-    local mainRegion = nil
-    local maxFaces = 0
-    
-    -- Find the region with the most faces (likely the main play area)
-    for _, region in ipairs(initialRegions) do
-        if region.faceCount > maxFaces then
-            maxFaces = region.faceCount
-            mainRegion = region
+    local regions, regionOfFace = EntityManager.ClassifyRegions(faceVertices)
+    for i, face in ipairs(faces) do
+        local region = regions[regionOfFace[i]]
+        if region then
+            faceRegions[face] = region
         end
     end
     
-    if mainRegion then
-        -- Only keep regions that are definitely separate from the main area
-        for _, region in ipairs(initialRegions) do
-            if region ~= mainRegion then
-                local distToMain = (region.center - mainRegion.center):Length()
-                local sizeRatio = region.size:Length() / mainRegion.size:Length()
-                
-                -- Keep region separate if:
-                -- 1. It's very far from the main region
-                -- 2. It's much smaller than the main region (likely a skybox or separate room)
-                -- 3. It's not connected to the main region
-                if (distToMain > 8192 and sizeRatio < 0.25) or
-                   (not IsRegionConnected(region, mainRegion) and distToMain > 4096) then
-                    table_insert(boundingRegions, region)
-                end
-            end
+    for _, region in ipairs(regions) do
+        if region.separate then
+            table_insert(boundingRegions, region)
         end
     end
     
@@ -374,12 +309,10 @@ local function IdentifyMapRegions()
 end
 
 local function IsInSeparateRegion(face)
-    if #boundingRegions <= 1 then return false end
+    if #boundingRegions == 0 then return false end
     
-    local vertices = face:GetVertexs()
-    if not vertices or #vertices == 0 then return false end
-    
-    return EntityManager.ProcessRegionBatch(vertices, LocalPlayer():GetPos(), 256)
+    local region = faceRegions[face]
+    return region ~= nil and region.separate
 end
 
 local function ValidateVertex(pos)
@@ -471,27 +404,45 @@ local function IsSkyboxFace(face)
     return false
 end
 
+-- Packed integer chunk key; exact as a Lua number, no string building
+local function GetChunkKey(x, y, z)
+    return RTXMath.GenerateChunkKey(x, y, z)
+end
+
+local function GetFaceCenter(vertices)
+    local center = Vector(0, 0, 0)
+    local vertCount = #vertices
+    for i = 1, vertCount do
+        local vert = vertices[i]
+        if not vert then continue end
+        center:Add(vert)
+    end
+    center:Div(vertCount)
+    return center
+end
+
+-- Regroups faces into half-size sub-chunks; returns a list of face lists
 local function SplitChunk(faces, chunkSize)
-    local subChunks = {}
+    local kept = {}
+    local centers = {}
     for _, face in ipairs(faces) do
         local vertices = face:GetVertexs()
         if not vertices or #vertices == 0 then continue end
         
-        -- Calculate face center
-        local center = Vector(0, 0, 0)
-        for _, vert in ipairs(vertices) do
-            center:Add(vert)
+        local index = #kept + 1
+        kept[index] = face
+        centers[index] = GetFaceCenter(vertices)
+    end
+    
+    -- Use smaller chunk size for subdivision
+    local order, keys, starts = RTXMath.BucketPoints(centers, chunkSize / 2)
+    local subChunks = {}
+    for b = 1, #keys do
+        local subFaces = {}
+        for i = starts[b], starts[b + 1] - 1 do
+            subFaces[#subFaces + 1] = kept[order[i]]
         end
-        center:Div(#vertices)
-        
-        -- Use smaller chunk size for subdivision
-        local subX = math_floor(center.x / (chunkSize/2))
-        local subY = math_floor(center.y / (chunkSize/2))
-        local subZ = math_floor(center.z / (chunkSize/2))
-        local subKey = GetChunkKey(subX, subY, subZ)
-        
-        subChunks[subKey] = subChunks[subKey] or {}
-        table_insert(subChunks[subKey], face)
+        subChunks[b] = subFaces
     end
     return subChunks
 end
@@ -516,37 +467,235 @@ local function CreateMeshBatch(vertices, material, maxVertsPerMesh)
         table.insert(vertexData.uvs, Vector(vert.u or 0, vert.v or 0, 0))
     end
     
-    -- Get optimized batch from native code
-    local batch = EntityManager.CreateOptimizedMeshBatch(
+    -- Native code splits the triangles into spatially compact batches that
+    -- each fit the vertex budget, so nothing past the limit is dropped
+    local batches = EntityManager.CreateOptimizedMeshBatch(
         vertexData.positions,
         vertexData.normals,
         vertexData.uvs,
         maxVertsPerMesh
     )
     
-    -- Create mesh from optimized data
+    -- Create meshes from optimized data; each native buffer writes its vertices
+    -- into the open mesh directly instead of handing back boxed Vectors
     local meshes = {}
-    local newMesh = Mesh(material)
+    for _, batch in ipairs(batches) do
+        local triangleCount = batch:GetTriangleCount()
+        if triangleCount > 0 then
+            local newMesh = Mesh(material)
+            
+            mesh.Begin(newMesh, MATERIAL_TRIANGLES, triangleCount)
+            batch:FeedMeshBuilder()
+            mesh.End()
+            
+            table.insert(meshes, newMesh)
+        end
+    end
     
-    mesh.Begin(newMesh, MATERIAL_TRIANGLES, #batch.vertices)
-    for i = 1, #batch.vertices do
-        mesh.Position(batch.vertices[i])
-        mesh.Normal(batch.normals[i])
-        mesh.TexCoord(0, batch.uvs[i].x, batch.uvs[i].y)
-        mesh.AdvanceVertex()
+    return meshes
+end
+
+-- Turns one native chunk mesh entry into IMeshes and registers its draw.
+-- state carries the running buffer size and material ids of the build.
+local function AddNativeChunkMesh(group, state)
+    if group.remix then
+        remixChunkCount = remixChunkCount + 1
+        return
+    end
+    
+    state.bufferBytes = state.bufferBytes + group.buffer:GetMemoryUsage()
+    local matName = group.material
+    if not materialCache[matName] then
+        materialCache[matName] = Material(matName)
     end
+    local material = materialCache[matName]
+    
+    local triangleCount = group.buffer:GetTriangleCount()
+    if triangleCount <= 0 then return end
+    
+    local renderType = group.translucent and "translucent" or "opaque"
+    local chunkKey = GetChunkKey(group.x, group.y, group.z)
+    
+    local chunkMaterials = mapMeshes[renderType][chunkKey] or {}
+    mapMeshes[renderType][chunkKey] = chunkMaterials
+    
+    local entry = chunkMaterials[matName] or { meshes = {}, lodMeshes = {}, material = material }
+    chunkMaterials[matName] = entry
+    
+    local newMesh = Mesh(material)
+    mesh.Begin(newMesh, MATERIAL_TRIANGLES, triangleCount)
+    group.buffer:FeedMeshBuilder()
     mesh.End()
     
-    table.insert(meshes, newMesh)
-    return meshes
+    table_insert(entry.meshes, newMesh)
+    
+    if group.id then
+        -- Remix rejected the mesh; its bounds are already registered
+        chunkDraws[group.id] = { mesh = newMesh, material = material, translucent = group.translucent }
+    elseif EntityManager.AddChunkBounds then
+        -- LODs are only drawn through the culled path, which picks the
+        -- level per frame; kept out of entry.meshes so the fallback
+        -- renderer keeps drawing full detail only
+        local lods = {}
+        for level, buffer in ipairs(group.lods or {}) do
+            state.bufferBytes = state.bufferBytes + buffer:GetMemoryUsage()
+            local lodMesh = Mesh(material)
+            mesh.Begin(lodMesh, MATERIAL_TRIANGLES, buffer:GetTriangleCount())
+            buffer:FeedMeshBuilder()
+            mesh.End()
+            lods[level] = lodMesh
+            table_insert(entry.lodMeshes, lodMesh)
+        end
+        
+        local materialId = state.materialIds[matName]
+        if not materialId then
+            state.materialCount = state.materialCount + 1
+            materialId = state.materialCount
+            state.materialIds[matName] = materialId
+        end
+        
+        local id = EntityManager.AddChunkBounds(group.mins, group.maxs, materialId, group.translucent, #lods)
+        chunkDraws[id] = { mesh = newMesh, lods = lods, material = material, translucent = group.translucent }
+    end
 end
 
-local function GetChunkKey(x, y, z)
-    return x .. "," .. y .. "," .. z
+local function PrintNativeBuildStats(stats, state)
+    if remixChunkCount > 0 then
+        print(string.format("[RTX Fixes] Submitted %d meshes directly to Remix", remixChunkCount))
+    end
+    
+    if stats.cached then
+        print(string.format("[RTX Fixes] Loaded %d meshes from the chunk mesh cache in %.1f ms (%.1f MB of buffers)",
+            stats.meshes, stats.cacheMs, state.bufferBytes / (1024 * 1024)))
+        return
+    end
+    
+    print(string.format("[RTX Fixes] Native builder: %d faces -> %d meshes on %d threads (partition %.1f ms, build %.1f ms)",
+        stats.faces, stats.meshes, stats.threads, stats.partitionMs, stats.buildMs))
+    if remixChunkCount > 0 then
+        print(string.format("[RTX Fixes] Welded %d vertices -> %d unique, %d indices (%.1f MB of buffers)",
+            stats.sourceVertices, stats.vertices, stats.indices, state.bufferBytes / (1024 * 1024)))
+    else
+        -- Source meshes are fed as triangle lists, one vertex per index
+        print(string.format("[RTX Fixes] Built %d triangle list vertices (%.1f MB of buffers)",
+            stats.indices, state.bufferBytes / (1024 * 1024)))
+    end
+    if stats.acmrBefore then
+        print(string.format("[RTX Fixes] Remix mesh vertex cache: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f",
+            stats.acmrBefore, stats.acmrAfter, stats.atvrBefore, stats.atvrAfter))
+    end
+    if stats.lodBuffers then
+        print(string.format("[RTX Fixes] Built %d LOD meshes: %d -> %d / %d / %d indices",
+            stats.lodBuffers, stats.indices, stats.lodIndices[1], stats.lodIndices[2], stats.lodIndices[3]))
+    end
+end
+
+-- Advances the incremental native build by one frame's budget. Meshes are
+-- drawable as soon as they are added; the job is dropped once the last one is in.
+local function StepNativeBuild()
+    local build = nativeBuild
+    if not build then return end
+    
+    local deadline = SysTime() + math_max(CONVARS.BUILD_BUDGET:GetFloat(), 0.1) / 1000
+    repeat
+        -- Small batches so Lua's own mesh creation counts against the budget too
+        local groups, progress, stats = EntityManager.StepChunkBuild((deadline - SysTime()) * 1000, 8)
+        if not groups then
+            nativeBuild = nil
+            hook.Remove("Think", "RTXIncrementalBuild")
+            return
+        end
+        
+        for _, group in ipairs(groups) do
+            AddNativeChunkMesh(group, build)
+        end
+        build.progress = progress
+        
+        if progress.finished then
+            nativeBuild = nil
+            hook.Remove("Think", "RTXIncrementalBuild")
+            PrintNativeBuildStats(stats, build)
+            print(string.format("[RTX Fixes] Built chunked meshes over %d frames in %.2f seconds",
+                FrameNumber() - build.startFrame, SysTime() - build.startTime))
+            return
+        end
+    until SysTime() >= deadline
+end
+
+local function CancelNativeBuild()
+    if not nativeBuild then return end
+    nativeBuild = nil
+    hook.Remove("Think", "RTXIncrementalBuild")
+    if EntityManager and EntityManager.CancelChunkBuild then
+        EntityManager.CancelChunkBuild()
+    end
+end
+
+-- Builds every chunk/material mesh from the natively loaded BSP on the worker
+-- pool. With a build budget the work is spread over frames from Think and
+-- this returns true, true once the build has started.
+local function BuildNativeMapMeshes()
+    if not EntityManager.IsMapBSPLoaded or not EntityManager.IsMapBSPLoaded() then return false end
+    
+    local _, totalFaces = EntityManager.IsMapBSPLoaded()
+    local chunkSize = DetermineOptimalChunkSize(totalFaces)
+    CONVARS.CHUNK_SIZE:SetInt(chunkSize)
+    
+    local cachePath
+    if CONVARS.MESH_CACHE:GetBool() then
+        file.CreateDir("rtx_mesh_cache")
+        cachePath = "data/rtx_mesh_cache/" .. game.GetMap() .. ".dat"
+    end
+    
+    local options = {
+        chunkSize = chunkSize,
+        maxVertices = MAX_VERTICES,
+        -- Welded meshes are budgeted by unique vertices; FeedMeshBuilder still
+        -- expands them, so cap the expanded triangle list as well
+        weld = true,
+        maxIndices = MAX_VERTICES * 3,
+        -- Vertex order only matters where the indices survive (Remix meshes)
+        optimize = true,
+        lods = CONVARS.CHUNK_LODS:GetInt(),
+        compact = CONVARS.COMPACT_VERTICES:GetBool(),
+        cache = cachePath,
+        mins = mapBounds.initialized and mapBounds.mins or nil,
+        maxs = mapBounds.initialized and mapBounds.maxs or nil,
+        skyboxOrigin = skyboxOrigin,
+        skyboxRadius = 4096,
+        remix = CONVARS.REMIX_DIRECT:GetBool()
+    }
+    local state = { bufferBytes = 0, materialIds = {}, materialCount = 0 }
+    
+    if CONVARS.BUILD_BUDGET:GetFloat() > 0 and EntityManager.StartChunkBuild then
+        local total, cached = EntityManager.StartChunkBuild(options)
+        if not total then return false end
+        
+        state.progress = { done = 0, total = total, cached = cached }
+        state.startTime = SysTime()
+        state.startFrame = FrameNumber()
+        nativeBuild = state
+        hook.Add("Think", "RTXIncrementalBuild", StepNativeBuild)
+        print(string.format("[RTX Fixes] Building %d chunk meshes%s over frames (%.1f ms per frame)",
+            total, cached and " from the cache" or "", CONVARS.BUILD_BUDGET:GetFloat()))
+        return true, true
+    end
+    
+    local groups, stats = EntityManager.BuildChunkMeshes(options)
+    if not groups then return false end
+    
+    for _, group in ipairs(groups) do
+        AddNativeChunkMesh(group, state)
+    end
+    PrintNativeBuildStats(stats, state)
+    return true
 end
 
 -- Main Mesh Building Function
 local function BuildMapMeshes()
+    -- A build still streaming in belongs to the meshes about to be destroyed
+    CancelNativeBuild()
+    
     -- Clean up existing meshes first
     for renderType, chunks in pairs(mapMeshes) do
         for chunkKey, materials in pairs(chunks) do
@@ -558,6 +707,13 @@ local function BuildMapMeshes()
                         end
                     end
                 end
+                if group.lodMeshes then
+                    for _, mesh in ipairs(group.lodMeshes) do
+                        if mesh and mesh.Destroy then
+                            mesh:Destroy()
+                        end
+                    end
+                end
             end
         end
     end
@@ -567,12 +723,26 @@ local function BuildMapMeshes()
         translucent = {},
     }
     materialCache = {}
+    chunkDraws = {}
+    remixChunkCount = 0
+    drawList.frame = -1
+    if EntityManager and EntityManager.ClearChunkBounds then
+        EntityManager.ClearChunkBounds()
+    end
     
-    if not NikNaks or not NikNaks.CurrentMap then return end
-
     print("[RTX Fixes] Building chunked meshes...")
     local startTime = SysTime()
     
+    local built, incremental = BuildNativeMapMeshes()
+    if built then
+        if not incremental then
+            print(string.format("[RTX Fixes] Built chunked meshes in %.2f seconds", SysTime() - startTime))
+        end
+        return
+    end
+    
+    if not NikNaks or not NikNaks.CurrentMap then return end
+    
     -- Initialize regions before processing faces
     IdentifyMapRegions()
     
@@ -594,7 +764,10 @@ local function BuildMapMeshes()
         translucent = {},
     }
     
-    -- Sort faces into chunks with optimized table operations
+    -- Collect the faces to mesh and their centers, then bucket them by chunk
+    -- natively in one pass
+    local faces = {}
+    local centers = {}
     for _, leaf in pairs(NikNaks.CurrentMap:GetLeafs()) do  
         if not leaf or leaf:IsOutsideMap() then continue end
         
@@ -614,20 +787,18 @@ local function BuildMapMeshes()
             local vertices = face:GetVertexs()
             if not vertices or #vertices == 0 then continue end
             
-            -- Optimized center calculation
-            local center = Vector(0, 0, 0)
-            local vertCount = #vertices
-            for i = 1, vertCount do
-                local vert = vertices[i]
-                if not vert then continue end
-                center:Add(vert)
-            end
-            center:Div(vertCount)
-            
-            local chunkX = math_floor(center.x / chunkSize)
-            local chunkY = math_floor(center.y / chunkSize)
-            local chunkZ = math_floor(center.z / chunkSize)
-            local chunkKey = GetChunkKey(chunkX, chunkY, chunkZ)
+            local index = #faces + 1
+            faces[index] = face
+            centers[index] = GetFaceCenter(vertices)
+        end
+    end
+    
+    local order, keys, starts = RTXMath.BucketPoints(centers, chunkSize)
+    for b = 1, #keys do
+        local chunkKey = keys[b]
+        
+        for i = starts[b], starts[b + 1] - 1 do
+            local face = faces[order[i]]
             
             local material = face:GetMaterial()
             if not material then continue end
@@ -736,6 +907,72 @@ local function BuildMapMeshes()
 end
 
 -- Rendering Functions
+
+-- Culls and sorts the native draws once per frame; both passes share the list
+local function UpdateDrawList()
+    local frame = FrameNumber()
+    if drawList.frame == frame then return end
+    
+    local view = render.GetViewSetup and render.GetViewSetup()
+    local origin = view and view.origin or EyePos()
+    local angles = view and view.angles or EyeAngles()
+    local fov = (view and view.fov or LocalPlayer():GetFOV()) + CULL_FOV_PADDING
+    local aspect = view and view.aspect or ScrW() / ScrH()
+    
+    local lodOut = CONVARS.CHUNK_LODS:GetInt() > 0 and visibleLods or nil
+    local count, _, firstTranslucent = EntityManager.CullChunks(origin, angles, fov, aspect,
+        CONVARS.CULL_DISTANCE:GetFloat(), visibleChunks, CONVARS.CHUNK_PVS:GetBool(),
+        lodOut, CONVARS.LOD_THRESHOLD:GetFloat())
+    
+    drawList.frame = frame
+    drawList.count = count
+    drawList.firstTranslucent = firstTranslucent
+    drawList.lods = lodOut
+    
+    if remixChunkCount > 0 then
+        EntityManager.DrawRemixChunks(true)
+    end
+end
+
+-- Draws the natively built meshes that pass the native frustum and distance
+-- test, in the material-batched order built by CullChunks
+local function RenderCulledWorld(translucent)
+    UpdateDrawList()
+    
+    local first, last = 1, drawList.firstTranslucent - 1
+    if translucent then
+        first, last = drawList.firstTranslucent, drawList.count
+    end
+    
+    if translucent then
+        render.SetBlend(1)
+        render.OverrideDepthEnable(true, true)
+    end
+    
+    local draws = 0
+    local currentMaterial = nil
+    local lods = drawList.lods
+    for i = first, last do
+        local draw = chunkDraws[visibleChunks[i]]
+        if draw then
+            if currentMaterial ~= draw.material then
+                render.SetMaterial(draw.material)
+                currentMaterial = draw.material
+            end
+            local level = lods and lods[i] or 0
+            local drawMesh = level > 0 and draw.lods and draw.lods[level] or draw.mesh
+            drawMesh:Draw()
+            draws = draws + 1
+        end
+    end
+    
+    if translucent then
+        render.OverrideDepthEnable(false)
+    end
+    
+    renderStats.draws = draws
+end
+
 local function RenderCustomWorld(translucent)
     if not isEnabled then return end
     
@@ -746,6 +983,16 @@ local function RenderCustomWorld(translucent)
     local ply = LocalPlayer()
     if not IsValid(ply) then return end
     
+    if (next(chunkDraws) or remixChunkCount > 0) and EntityManager.CullChunks and CONVARS.CHUNK_CULLING:GetBool() then
+        RenderCulledWorld(translucent)
+        return
+    end
+    
+    if remixChunkCount > 0 and not translucent and remixDrawFrame ~= FrameNumber() then
+        remixDrawFrame = FrameNumber()
+        EntityManager.DrawRemixChunks(false)
+    end
+    
     local viewPos = ply:EyePos()
     local viewDir = ply:GetAimVector()
     
@@ -839,9 +1086,34 @@ local function DisableCustomRendering()
     hook.Remove("PreDrawTranslucentRenderables", "RTXCustomWorld")
 end
 
+-- Loads the map's face lumps natively so geometry no longer has to be
+-- decoded face by face through NikNaks
+local function LoadNativeMapData()
+    if not EntityManager or not EntityManager.LoadMapBSP then return false end
+    
+    local mapPath = "maps/" .. game.GetMap() .. ".bsp"
+    local loadOptions = { mergeFaces = CONVARS.MERGE_FACES:GetBool() }
+    local success, err = EntityManager.LoadMapBSP(mapPath, loadOptions)
+    
+    if not success then
+        -- Maps mounted from addons can't be mapped from disk, read them through the filesystem instead
+        local data = file.Read(mapPath, "GAME")
+        if data then
+            success, err = EntityManager.LoadMapBSPFromString(data, loadOptions)
+        end
+    end
+    
+    if not success then
+        print("[RTX Fixes] Native BSP loading unavailable: " .. tostring(err))
+    end
+    
+    return success
+end
+
 -- Initialization and Cleanup
 local function Initialize()
     InitializeMapBounds()
+    LoadNativeMapData()
     
     local success, err = pcall(BuildMapMeshes)
     if not success then
@@ -872,7 +1144,9 @@ end)
 
 hook.Add("ShutDown", "RTXCustomWorld", function()
     DisableCustomRendering()
+    CancelNativeBuild()
     
+
     for renderType, chunks in pairs(mapMeshes) do
         for chunkKey, materials in pairs(chunks) do
             for matName, group in pairs(materials) do
@@ -883,6 +1157,13 @@ hook.Add("ShutDown", "RTXCustomWorld", function()
                         end
                     end
                 end
+                if group.lodMeshes then
+                    for _, mesh in ipairs(group.lodMeshes) do
+                        if mesh.Destroy then
+                            mesh:Destroy()
+                        end
+                    end
+                end
             end
         end
     end
@@ -892,6 +1173,17 @@ hook.Add("ShutDown", "RTXCustomWorld", function()
         translucent = {}
     }
     materialCache = {}
+    chunkDraws = {}
+    remixChunkCount = 0
+    drawList.frame = -1
+    if EntityManager and EntityManager.ClearChunkBounds then
+        EntityManager.ClearChunkBounds()
+    end
+    
+    -- After the chunk meshes are gone, so their Remix materials are released too
+    if EntityManager and EntityManager.UnloadMapBSP then
+        EntityManager.UnloadMapBSP()
+    end
 end)
 
 -- ConVar Changes
@@ -919,6 +1211,24 @@ hook.Add("PopulateToolMenu", "RTXCustomWorldMenu", function()
         panel:CheckBox("Remix Capture Mode", "rtx_capture_mode")
         panel:ControlHelp("Enable this if you're taking a capture with RTX Remix")
         
+        panel:CheckBox("Cull Off-Screen Chunks", "rtx_chunk_culling")
+        panel:ControlHelp("Only draws world meshes inside the view frustum")
+        
+        panel:CheckBox("PVS Culling", "rtx_chunk_pvs")
+        panel:ControlHelp("Also skips world meshes the map's vis data hides from the camera")
+        
+        panel:NumSlider("Chunk LOD Levels", "rtx_chunk_lods", 0, 3, 0)
+        panel:ControlHelp("Simplified meshes drawn for distant chunks; rebuild to apply")
+        
+        panel:CheckBox("Merge Coplanar Faces", "rtx_merge_coplanar_faces")
+        panel:ControlHelp("Joins adjacent brush faces that share a plane and texture into fewer triangles; applies on map load")
+        
+        panel:NumSlider("Mesh Build Budget (ms/frame)", "rtx_mesh_build_budget", 0, 50, 1)
+        panel:ControlHelp("Spreads world mesh building over frames instead of freezing on load; 0 builds everything at once")
+        
+        panel:CheckBox("Direct Remix Meshes (Experimental)", "rtx_remix_direct_meshes")
+        panel:ControlHelp("Hands world meshes straight to Remix instead of building Source meshes; rebuild to apply")
+        
         panel:CheckBox("Show Debug Info", "rtx_force_render_debug")
     end)
 end)
@@ -926,6 +1236,49 @@ end)
 -- Console Commands
 concommand.Add("rtx_rebuild_meshes", BuildMapMeshes)
 
+concommand.Add("rtx_mesh_build_status", function()
+    if not nativeBuild then
+        print("[RTX Fixes] No chunk mesh build in progress")
+        return
+    end
+    
+    local progress = nativeBuild.progress
+    print(string.format("[RTX Fixes] Building chunk meshes%s: %d / %d (%.0f%%), %.1f s elapsed",
+        progress.cached and " from the cache" or "", progress.done, progress.total,
+        progress.total > 0 and progress.done / progress.total * 100 or 100, SysTime() - nativeBuild.startTime))
+end)
+
+concommand.Add("rtx_mesher_benchmark", function(_, _, args)
+    local faceCount = tonumber(args[1]) or 500000
+    EntityManager.BenchmarkChunkBuilder(faceCount, CONVARS.CHUNK_SIZE:GetInt())
+end)
+
+concommand.Add("rtx_chunk_draw_stats", function()
+    if not EntityManager or not EntityManager.GetChunkDrawStats then return end
+    local stats = EntityManager.GetChunkDrawStats()
+    print(string.format("[RTX Fixes] %d of %d chunks visible (%d translucent), %d material switches (%d saved by sorting)",
+        stats.visible, EntityManager.GetChunkBoundsCount(), stats.translucent, stats.switches, stats.switchesSaved))
+end)
+
+concommand.Add("rtx_chunk_pvs_validate", function(_, _, args)
+    if not EntityManager or not EntityManager.ValidateChunkPVS then return end
+    EntityManager.ValidateChunkPVS(tonumber(args[1]) or 256)
+end)
+
+concommand.Add("rtx_remix_direct_stats", function()
+    if not EntityManager or not EntityManager.GetRemixWorldStats then return end
+    local stats = EntityManager.GetRemixWorldStats()
+    print(string.format("[RTX Fixes] Remix %s: %d direct meshes (%d vertices, %d indices), %d rejected, %d instances last frame",
+        stats.available and "running" or "unavailable", stats.meshes, stats.vertices, stats.indices, stats.failed, stats.instances))
+end)
+
+concommand.Add("rtx_remix_material_stats", function()
+    if not EntityManager or not EntityManager.GetRemixMaterialStats then return end
+    local stats = EntityManager.GetRemixMaterialStats()
+    print(string.format("[RTX Fixes] Remix materials: %d live (%d referenced), %d hits, %d misses, %d rejected, %d created, %d destroyed",
+        stats.live, stats.referenced, stats.hits, stats.misses, stats.failed, stats.created, stats.destroyed))
+end)
+
 ------ r_3dsky disclaimer ------
 local function ShowSkyDisclaimer()
     if disclaimerShown then return end
@@ -35,6 +35,8 @@ CreateWorkspace({name = "RTXFixesBinary", abi_compatible = false, path = ""})
 		files {
 			"source/rtx_lights/*",
 			"source/shader_fixes/*",
+			"source/bsp_reader/*",
+			"source/mesh_builder/*",
 		} 
 
 
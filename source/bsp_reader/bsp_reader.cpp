@@ -0,0 +1,395 @@
+#include "bsp_reader.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BSPReader {
+
+static const int32_t IDBSPHEADER = ('P' << 24) + ('S' << 16) + ('B' << 8) + 'V';
+static const uint32_t LZMA_ID = ('A' << 24) | ('M' << 16) | ('Z' << 8) | 'L';
+
+// MappedFile
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return false;
+
+    m_mapped = true;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::Adopt(std::vector<uint8_t>&& buffer) {
+    Close();
+    m_owned = std::move(buffer);
+    m_data = m_owned.data();
+    m_size = m_owned.size();
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (m_mapping) {
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+        m_file = nullptr;
+    }
+#else
+    if (m_mapped) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+        m_mapped = false;
+    }
+#endif
+    m_owned.clear();
+    m_owned.shrink_to_fit();
+    m_data = nullptr;
+    m_size = 0;
+}
+
+// Map
+
+bool Map::Open(const std::string& path, std::string& error) {
+    Close();
+    if (!m_file.Open(path)) {
+        error = "could not open " + path;
+        return false;
+    }
+    return Validate(error);
+}
+
+bool Map::OpenFromMemory(std::vector<uint8_t>&& data, std::string& error) {
+    Close();
+    m_file.Adopt(std::move(data));
+    return Validate(error);
+}
+
+void Map::Close() {
+    m_header = nullptr;
+    m_file.Close();
+}
+
+bool Map::Validate(std::string& error) {
+    if (m_file.Size() < sizeof(FileHeader)) {
+        error = "file too small for a BSP header";
+        m_file.Close();
+        return false;
+    }
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(m_file.Data());
+    if (header->ident != IDBSPHEADER) {
+        error = "not a VBSP file";
+        m_file.Close();
+        return false;
+    }
+
+    if (header->version < 19 || header->version > 20) {
+        error = "unsupported BSP version " + std::to_string(header->version);
+        m_file.Close();
+        return false;
+    }
+
+    m_header = header;
+    return true;
+}
+
+const uint8_t* Map::GetLumpData(LumpIndex lump, size_t& bytes) const {
+    bytes = 0;
+    if (!m_header || lump < 0 || lump >= HEADER_LUMPS) return nullptr;
+
+    const LumpHeader& info = m_header->lumps[lump];
+    if (info.fileofs < 0 || info.filelen <= 0) return nullptr;
+
+    size_t offset = static_cast<size_t>(info.fileofs);
+    size_t length = static_cast<size_t>(info.filelen);
+    if (offset > m_file.Size() || length > m_file.Size() - offset) return nullptr;
+
+    const uint8_t* data = m_file.Data() + offset;
+
+    // Compressed lumps are not supported; callers fall back to the Lua path
+    if (length >= 4) {
+        uint32_t magic;
+        std::memcpy(&magic, data, sizeof(magic));
+        if (magic == LZMA_ID) return nullptr;
+    }
+
+    bytes = length;
+    return data;
+}
+
+int Map::GetLumpVersion(LumpIndex lump) const {
+    if (!m_header || lump < 0 || lump >= HEADER_LUMPS) return 0;
+    return m_header->lumps[lump].version;
+}
+
+const char* Map::GetTexDataName(int32_t texData) const {
+    size_t texDataCount, tableCount, stringBytes;
+    const DTexData* texDatas = GetLump<DTexData>(LUMP_TEXDATA, texDataCount);
+    const int32_t* table = GetLump<int32_t>(LUMP_TEXDATA_STRING_TABLE, tableCount);
+    const uint8_t* strings = GetLumpData(LUMP_TEXDATA_STRING_DATA, stringBytes);
+
+    if (!texDatas || !table || !strings) return nullptr;
+    if (texData < 0 || static_cast<size_t>(texData) >= texDataCount) return nullptr;
+
+    int32_t tableIndex = texDatas[texData].nameStringTableID;
+    if (tableIndex < 0 || static_cast<size_t>(tableIndex) >= tableCount) return nullptr;
+
+    int32_t offset = table[tableIndex];
+    if (offset < 0 || static_cast<size_t>(offset) >= stringBytes) return nullptr;
+
+    // Make sure the name is terminated inside the lump
+    const char* name = reinterpret_cast<const char*>(strings + offset);
+    if (!std::memchr(name, 0, stringBytes - offset)) return nullptr;
+    return name;
+}
+
+bool Map::GetFacePolygon(size_t faceIndex, std::vector<Vec3>& outVerts) const {
+    outVerts.clear();
+
+    size_t faceCount, edgeCount, surfEdgeCount, vertCount;
+    const DFace* faces = GetLump<DFace>(LUMP_FACES, faceCount);
+    const DEdge* edges = GetLump<DEdge>(LUMP_EDGES, edgeCount);
+    const int32_t* surfEdges = GetLump<int32_t>(LUMP_SURFEDGES, surfEdgeCount);
+    const Vec3* verts = GetLump<Vec3>(LUMP_VERTEXES, vertCount);
+
+    if (!faces || !edges || !surfEdges || !verts || faceIndex >= faceCount) return false;
+
+    const DFace& face = faces[faceIndex];
+    if (face.numedges < 3 || face.firstedge < 0 ||
+        static_cast<size_t>(face.firstedge) + face.numedges > surfEdgeCount) {
+        return false;
+    }
+
+    outVerts.reserve(face.numedges);
+    for (int i = 0; i < face.numedges; i++) {
+        int32_t surfEdge = surfEdges[face.firstedge + i];
+        size_t edgeIndex = static_cast<size_t>(surfEdge >= 0 ? surfEdge : -static_cast<int64_t>(surfEdge));
+        if (edgeIndex >= edgeCount) return false;
+
+        uint16_t vertIndex = surfEdge >= 0 ? edges[edgeIndex].v[0] : edges[edgeIndex].v[1];
+        if (vertIndex >= vertCount) return false;
+
+        outVerts.push_back(verts[vertIndex]);
+    }
+
+    return true;
+}
+
+bool Map::DecodeFace(size_t faceIndex, std::vector<TriangleVertex>& outTriangles, Vec3* outCenter) const {
+    size_t faceCount, planeCount, texInfoCount, texDataCount;
+    const DFace* faces = GetLump<DFace>(LUMP_FACES, faceCount);
+    const DPlane* planes = GetLump<DPlane>(LUMP_PLANES, planeCount);
+    const DTexInfo* texInfos = GetLump<DTexInfo>(LUMP_TEXINFO, texInfoCount);
+    const DTexData* texDatas = GetLump<DTexData>(LUMP_TEXDATA, texDataCount);
+
+    if (!faces || !planes || !texInfos || faceIndex >= faceCount) return false;
+
+    const DFace& face = faces[faceIndex];
+    if (face.planenum >= planeCount || face.texinfo < 0 ||
+        static_cast<size_t>(face.texinfo) >= texInfoCount) {
+        return false;
+    }
+
+    std::vector<Vec3> polygon;
+    if (!GetFacePolygon(faceIndex, polygon)) return false;
+
+    if (outCenter) {
+        // Same center as the Lua mesher: the average of the polygon corners
+        Vec3 center = {0, 0, 0};
+        for (const auto& p : polygon) {
+            center.x += p.x;
+            center.y += p.y;
+            center.z += p.z;
+        }
+        float inv = 1.0f / static_cast<float>(polygon.size());
+        *outCenter = {center.x * inv, center.y * inv, center.z * inv};
+    }
+
+    Vec3 normal = planes[face.planenum].normal;
+    if (face.side) {
+        normal = {-normal.x, -normal.y, -normal.z};
+    }
+
+    const DTexInfo& texInfo = texInfos[face.texinfo];
+    float width = 1.0f, height = 1.0f;
+    if (texDatas && texInfo.texdata >= 0 && static_cast<size_t>(texInfo.texdata) < texDataCount) {
+        width = static_cast<float>(std::max(texDatas[texInfo.texdata].width, 1));
+        height = static_cast<float>(std::max(texDatas[texInfo.texdata].height, 1));
+    }
+
+    auto makeVertex = [&](const Vec3& p) {
+        const float* s = texInfo.textureVecs[0];
+        const float* t = texInfo.textureVecs[1];
+        TriangleVertex vert;
+        vert.pos = p;
+        vert.normal = normal;
+        vert.u = (s[0] * p.x + s[1] * p.y + s[2] * p.z + s[3]) / width;
+        vert.v = (t[0] * p.x + t[1] * p.y + t[2] * p.z + t[3]) / height;
+        return vert;
+    };
+
+    // Faces are convex, so a fan around the first vertex covers them
+    outTriangles.reserve(outTriangles.size() + (polygon.size() - 2) * 3);
+    for (size_t i = 1; i + 1 < polygon.size(); i++) {
+        outTriangles.push_back(makeVertex(polygon[0]));
+        outTriangles.push_back(makeVertex(polygon[i]));
+        outTriangles.push_back(makeVertex(polygon[i + 1]));
+    }
+
+    return true;
+}
+
+bool Map::DecodeWorld(WorldGeometry& out, const DecodeOptions& options) const {
+    out.Clear();
+
+    size_t faceCount, texInfoCount, modelCount;
+    const DFace* faces = GetLump<DFace>(LUMP_FACES, faceCount);
+    const DTexInfo* texInfos = GetLump<DTexInfo>(LUMP_TEXINFO, texInfoCount);
+    const DModel* models = GetLump<DModel>(LUMP_MODELS, modelCount);
+    if (!faces || !texInfos) return false;
+
+    size_t firstFace = 0;
+    size_t lastFace = faceCount;
+    if (options.worldOnly && models && modelCount > 0) {
+        firstFace = static_cast<size_t>(std::max(models[0].firstface, 0));
+        lastFace = std::min(faceCount, firstFace + static_cast<size_t>(std::max(models[0].numfaces, 0)));
+    }
+
+    std::unordered_map<int32_t, size_t> streamByTexData;
+    std::vector<TriangleVertex> scratch;
+
+    for (size_t i = firstFace; i < lastFace; i++) {
+        const DFace& face = faces[i];
+
+        if (face.dispinfo != -1) {
+            if (options.skipDisplacements) out.skippedFaces++;
+            continue;
+        }
+
+        if (face.texinfo < 0 || static_cast<size_t>(face.texinfo) >= texInfoCount) {
+            out.skippedFaces++;
+            continue;
+        }
+
+        const DTexInfo& texInfo = texInfos[face.texinfo];
+        if (static_cast<uint32_t>(texInfo.flags) & options.skipSurfaceFlags) {
+            out.skippedFaces++;
+            continue;
+        }
+
+        FaceRange range = {};
+        scratch.clear();
+        if (!DecodeFace(i, scratch, &range.center) || scratch.empty()) {
+            out.skippedFaces++;
+            continue;
+        }
+
+        range.faceIndex = static_cast<uint32_t>(i);
+        range.texInfo = static_cast<uint32_t>(face.texinfo);
+        range.mins = {FLT_MAX, FLT_MAX, FLT_MAX};
+        range.maxs = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+        bool valid = true;
+        for (const auto& vert : scratch) {
+            const Vec3& p = vert.pos;
+            if (!std::isfinite(p.x) || !std::isfinite(p.y) || !std::isfinite(p.z) ||
+                std::fabs(p.x) > options.maxCoord ||
+                std::fabs(p.y) > options.maxCoord ||
+                std::fabs(p.z) > options.maxCoord) {
+                valid = false;
+                break;
+            }
+            range.mins = {std::min(range.mins.x, p.x), std::min(range.mins.y, p.y), std::min(range.mins.z, p.z)};
+            range.maxs = {std::max(range.maxs.x, p.x), std::max(range.maxs.y, p.y), std::max(range.maxs.z, p.z)};
+        }
+        if (!valid) {
+            out.skippedFaces++;
+            continue;
+        }
+
+        auto it = streamByTexData.find(texInfo.texdata);
+        if (it == streamByTexData.end()) {
+            MaterialStream stream;
+            const char* name = GetTexDataName(texInfo.texdata);
+            stream.material = name ? name : "";
+            stream.texData = texInfo.texdata;
+            stream.surfaceFlags = 0;
+            it = streamByTexData.emplace(texInfo.texdata, out.materials.size()).first;
+            out.materials.push_back(std::move(stream));
+        }
+
+        MaterialStream& stream = out.materials[it->second];
+        stream.surfaceFlags |= static_cast<uint32_t>(texInfo.flags);
+        range.firstVertex = static_cast<uint32_t>(stream.vertices.size());
+        range.vertexCount = static_cast<uint32_t>(scratch.size());
+        stream.vertices.insert(stream.vertices.end(), scratch.begin(), scratch.end());
+        stream.faces.push_back(range);
+
+        out.faceCount++;
+        out.triangleCount += scratch.size() / 3;
+    }
+
+    return true;
+}
+
+} // namespace BSPReader
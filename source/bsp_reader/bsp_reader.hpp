@@ -0,0 +1,306 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Minimal reader for Source engine .bsp files (versions 19 and 20, the ones
+// Garry's Mod loads; version 21 reorders the lump header fields).
+// Kept free of SDK and Lua headers so it can be used from worker threads
+// and compiled on any platform.
+namespace BSPReader {
+    enum LumpIndex {
+        LUMP_ENTITIES = 0,
+        LUMP_PLANES = 1,
+        LUMP_TEXDATA = 2,
+        LUMP_VERTEXES = 3,
+        LUMP_VISIBILITY = 4,
+        LUMP_NODES = 5,
+        LUMP_TEXINFO = 6,
+        LUMP_FACES = 7,
+        LUMP_LEAFS = 10,
+        LUMP_EDGES = 12,
+        LUMP_SURFEDGES = 13,
+        LUMP_MODELS = 14,
+        LUMP_LEAFFACES = 16,
+        LUMP_DISPINFO = 26,
+        LUMP_DISP_VERTS = 33,
+        LUMP_TEXDATA_STRING_DATA = 43,
+        LUMP_TEXDATA_STRING_TABLE = 44,
+        HEADER_LUMPS = 64
+    };
+
+    // Surface flags from texinfo_t::flags
+    enum SurfaceFlags : uint32_t {
+        SURF_LIGHT = 0x0001,
+        SURF_SKY2D = 0x0002,
+        SURF_SKY = 0x0004,
+        SURF_WARP = 0x0008,
+        SURF_TRANS = 0x0010,
+        SURF_NOPORTAL = 0x0020,
+        SURF_TRIGGER = 0x0040,
+        SURF_NODRAW = 0x0080,
+        SURF_HINT = 0x0100,
+        SURF_SKIP = 0x0200,
+        SURF_NOLIGHT = 0x0400,
+        SURF_BUMPLIGHT = 0x0800,
+    };
+
+    struct Vec3 {
+        float x, y, z;
+    };
+
+    // On-disk structures, laid out exactly as in bspfile.h
+    struct LumpHeader {
+        int32_t fileofs;
+        int32_t filelen;
+        int32_t version;
+        char fourCC[4];
+    };
+
+    struct FileHeader {
+        int32_t ident;
+        int32_t version;
+        LumpHeader lumps[HEADER_LUMPS];
+        int32_t mapRevision;
+    };
+
+    struct DPlane {
+        Vec3 normal;
+        float dist;
+        int32_t type;
+    };
+
+    struct DEdge {
+        uint16_t v[2];
+    };
+
+    struct DTexInfo {
+        float textureVecs[2][4];
+        float lightmapVecs[2][4];
+        int32_t flags;
+        int32_t texdata;
+    };
+
+    struct DTexData {
+        Vec3 reflectivity;
+        int32_t nameStringTableID;
+        int32_t width, height;
+        int32_t viewWidth, viewHeight;
+    };
+
+    struct DFace {
+        uint16_t planenum;
+        uint8_t side;
+        uint8_t onNode;
+        int32_t firstedge;
+        int16_t numedges;
+        int16_t texinfo;
+        int16_t dispinfo;
+        int16_t surfaceFogVolumeID;
+        uint8_t styles[4];
+        int32_t lightofs;
+        float area;
+        int32_t lightmapTextureMinsInLuxels[2];
+        int32_t lightmapTextureSizeInLuxels[2];
+        int32_t origFace;
+        uint16_t numPrims;
+        uint16_t firstPrimID;
+        uint32_t smoothingGroups;
+    };
+
+    struct DModel {
+        Vec3 mins, maxs;
+        Vec3 origin;
+        int32_t headnode;
+        int32_t firstface, numfaces;
+    };
+
+    struct DNode {
+        int32_t planenum;
+        int32_t children[2];  // Negative numbers are -(leaf + 1)
+        int16_t mins[3], maxs[3];
+        uint16_t firstface, numfaces;
+        int16_t area;
+        int16_t padding;
+    };
+
+    // Version 1 layout. Version 0 leaves carry a 24-byte ambient light cube
+    // before the padding (56 bytes); the fields up to leafWaterDataID match.
+    struct DLeaf {
+        int32_t contents;
+        int16_t cluster;      // -1 for solid leaves
+        int16_t areaFlags;    // area:9, flags:7
+        int16_t mins[3], maxs[3];
+        uint16_t firstleafface, numleaffaces;
+        uint16_t firstleafbrush, numleafbrushes;
+        int16_t leafWaterDataID;
+        int16_t padding;
+    };
+
+    struct DDispSubNeighbor {
+        uint16_t neighbor;
+        uint8_t neighborOrientation;
+        uint8_t span;
+        uint8_t neighborSpan;
+        uint8_t padding;
+    };
+
+    struct DDispCornerNeighbors {
+        uint16_t neighbors[4];
+        uint8_t numNeighbors;
+        uint8_t padding;
+    };
+
+    struct DDispInfo {
+        Vec3 startPosition;
+        int32_t dispVertStart;
+        int32_t dispTriStart;
+        int32_t power;
+        int32_t minTess;
+        float smoothingAngle;
+        int32_t contents;
+        uint16_t mapFace;
+        uint16_t padding;
+        int32_t lightmapAlphaStart;
+        int32_t lightmapSamplePositionStart;
+        DDispSubNeighbor edgeNeighbors[4][2];
+        DDispCornerNeighbors cornerNeighbors[4];
+        uint32_t allowedVerts[10];
+    };
+
+    struct DDispVert {
+        Vec3 vec;     // Normalized offset direction
+        float dist;
+        float alpha;
+    };
+
+    static_assert(sizeof(FileHeader) == 1036, "FileHeader layout mismatch");
+    static_assert(sizeof(DPlane) == 20, "DPlane layout mismatch");
+    static_assert(sizeof(DTexInfo) == 72, "DTexInfo layout mismatch");
+    static_assert(sizeof(DTexData) == 32, "DTexData layout mismatch");
+    static_assert(sizeof(DFace) == 56, "DFace layout mismatch");
+    static_assert(sizeof(DModel) == 48, "DModel layout mismatch");
+    static_assert(sizeof(DNode) == 32, "DNode layout mismatch");
+    static_assert(sizeof(DLeaf) == 32, "DLeaf layout mismatch");
+    static_assert(sizeof(DDispInfo) == 176, "DDispInfo layout mismatch");
+    static_assert(sizeof(DDispVert) == 20, "DDispVert layout mismatch");
+
+    // Read-only view of a .bsp, either memory-mapped from disk or backed by
+    // a buffer handed in by the caller (maps mounted from .gma archives)
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const std::string& path);
+        void Adopt(std::vector<uint8_t>&& buffer);
+        void Close();
+
+        const uint8_t* Data() const { return m_data; }
+        size_t Size() const { return m_size; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+        std::vector<uint8_t> m_owned;
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#else
+        bool m_mapped = false;
+#endif
+    };
+
+    // One triangle corner of the decoded world
+    struct TriangleVertex {
+        Vec3 pos;
+        Vec3 normal;
+        float u, v;
+    };
+
+    // A single decoded face inside a MaterialStream
+    struct FaceRange {
+        uint32_t faceIndex;
+        uint32_t firstVertex;
+        uint32_t vertexCount;
+        uint32_t texInfo;
+        Vec3 mins, maxs;
+        Vec3 center;
+    };
+
+    // Every triangle that uses one material, stored back to back
+    struct MaterialStream {
+        std::string material;
+        int32_t texData;
+        uint32_t surfaceFlags;
+        std::vector<TriangleVertex> vertices;
+        std::vector<FaceRange> faces;
+    };
+
+    struct DecodeOptions {
+        // Only faces of model 0; brush entities are drawn by the engine
+        bool worldOnly = true;
+        // Displacement faces are never decoded as flat polygons here;
+        // MeshBuilder::BuildDisplacements tessellates them unless this is set
+        bool skipDisplacements = false;
+        uint32_t skipSurfaceFlags = SURF_NODRAW | SURF_SKY | SURF_SKY2D | SURF_SKIP | SURF_HINT | SURF_TRIGGER;
+        // Reject faces with a vertex further than this from the origin
+        float maxCoord = 16384.0f;
+    };
+
+    struct WorldGeometry {
+        std::vector<MaterialStream> materials;
+        size_t faceCount = 0;
+        size_t triangleCount = 0;
+        size_t skippedFaces = 0;
+
+        void Clear() {
+            materials.clear();
+            faceCount = triangleCount = skippedFaces = 0;
+        }
+    };
+
+    class Map {
+    public:
+        bool Open(const std::string& path, std::string& error);
+        bool OpenFromMemory(std::vector<uint8_t>&& data, std::string& error);
+        void Close();
+
+        bool IsOpen() const { return m_header != nullptr; }
+        int Version() const { return m_header ? m_header->version : 0; }
+        int Revision() const { return m_header ? m_header->mapRevision : 0; }
+        const uint8_t* Data() const { return m_file.Data(); }
+        size_t Size() const { return m_file.Size(); }
+
+        // Typed view of a lump; count is 0 when the lump is missing or malformed
+        template<typename T>
+        const T* GetLump(LumpIndex lump, size_t& count) const {
+            size_t bytes = 0;
+            const uint8_t* data = GetLumpData(lump, bytes);
+            count = data ? bytes / sizeof(T) : 0;
+            return count ? reinterpret_cast<const T*>(data) : nullptr;
+        }
+        const uint8_t* GetLumpData(LumpIndex lump, size_t& bytes) const;
+        int GetLumpVersion(LumpIndex lump) const;
+
+        const char* GetTexDataName(int32_t texData) const;
+
+        // Decodes the face lumps into per-material triangle streams
+        bool DecodeWorld(WorldGeometry& out, const DecodeOptions& options = DecodeOptions()) const;
+
+        // Appends the fan-triangulated polygon of one face, returns false for
+        // degenerate or out-of-range faces
+        bool DecodeFace(size_t faceIndex, std::vector<TriangleVertex>& outTriangles,
+                        Vec3* outCenter = nullptr) const;
+        bool GetFacePolygon(size_t faceIndex, std::vector<Vec3>& outVerts) const;
+
+    private:
+        bool Validate(std::string& error);
+
+        MappedFile m_file;
+        const FileHeader* m_header = nullptr;
+    };
+}
@@ -0,0 +1,260 @@
+#include "visibility.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace BSPReader {
+
+// Version 0 leaves, see DLeaf
+static const size_t LEAF_SIZE_V0 = 56;
+
+bool Visibility::Load(const Map& map, std::string& error) {
+    Clear();
+
+    size_t planeCount, nodeCount, modelCount, leafBytes, visBytes;
+    const DPlane* planes = map.GetLump<DPlane>(LUMP_PLANES, planeCount);
+    const DNode* nodes = map.GetLump<DNode>(LUMP_NODES, nodeCount);
+    const DModel* models = map.GetLump<DModel>(LUMP_MODELS, modelCount);
+    const uint8_t* leafData = map.GetLumpData(LUMP_LEAFS, leafBytes);
+    const uint8_t* visData = map.GetLumpData(LUMP_VISIBILITY, visBytes);
+
+    if (!planes || !nodes || !models || !leafData) {
+        error = "map has no BSP tree";
+        return false;
+    }
+    if (!visData || visBytes < sizeof(int32_t)) {
+        error = "map has no visibility data (not vised)";
+        return false;
+    }
+
+    const size_t leafStride = map.GetLumpVersion(LUMP_LEAFS) == 0 ? LEAF_SIZE_V0 : sizeof(DLeaf);
+    const size_t leafCount = leafBytes / leafStride;
+    if (leafCount == 0) {
+        error = "map has no leaves";
+        return false;
+    }
+
+    m_headNode = models[0].headnode;
+    if (m_headNode < 0 || static_cast<size_t>(m_headNode) >= nodeCount) {
+        error = "world model has an invalid head node";
+        return false;
+    }
+
+    // vbsp writes nodes in preorder, so a child node always comes after its
+    // parent; requiring that rules out cycles. Leaves out of range are
+    // treated as solid leaf 0 rather than trusted.
+    m_nodes.resize(nodeCount);
+    for (size_t i = 0; i < nodeCount; i++) {
+        const DNode& in = nodes[i];
+        Node& node = m_nodes[i];
+        if (in.planenum < 0 || static_cast<size_t>(in.planenum) >= planeCount) {
+            error = "node references a missing plane";
+            Clear();
+            return false;
+        }
+
+        const DPlane& plane = planes[in.planenum];
+        node.normal[0] = plane.normal.x;
+        node.normal[1] = plane.normal.y;
+        node.normal[2] = plane.normal.z;
+        node.dist = plane.dist;
+
+        for (int side = 0; side < 2; side++) {
+            int32_t child = in.children[side];
+            if (child >= 0 && (static_cast<size_t>(child) <= i || static_cast<size_t>(child) >= nodeCount)) {
+                error = "BSP tree is malformed";
+                Clear();
+                return false;
+            }
+            node.children[side] = child >= 0 || static_cast<size_t>(-1 - child) < leafCount ? child : -1;
+        }
+    }
+
+    m_leafClusters.resize(leafCount);
+    m_leafBounds.resize(leafCount * 6);
+    for (size_t i = 0; i < leafCount; i++) {
+        DLeaf leaf;
+        std::memcpy(&leaf, leafData + i * leafStride, offsetof(DLeaf, padding));
+        m_leafClusters[i] = leaf.cluster;
+        std::copy(leaf.mins, leaf.mins + 3, &m_leafBounds[i * 6]);
+        std::copy(leaf.maxs, leaf.maxs + 3, &m_leafBounds[i * 6 + 3]);
+    }
+
+    // dvis_t: numclusters, then a (pvs, pas) offset pair per cluster
+    int32_t clusterCount;
+    std::memcpy(&clusterCount, visData, sizeof(clusterCount));
+    if (clusterCount <= 0 || static_cast<size_t>(clusterCount) > (visBytes - 4) / 8) {
+        error = "visibility lump is malformed";
+        Clear();
+        return false;
+    }
+
+    m_clusterCount = clusterCount;
+    m_rowBytes = (static_cast<size_t>(clusterCount) + 7) / 8;
+    m_pvs.assign(m_rowBytes * clusterCount, 0);
+
+    const uint8_t* visEnd = visData + visBytes;
+    for (int32_t cluster = 0; cluster < clusterCount; cluster++) {
+        int32_t offset;
+        std::memcpy(&offset, visData + 4 + cluster * 8, sizeof(offset));
+        if (offset <= 0 || static_cast<size_t>(offset) >= visBytes) {
+            // Without data the cluster may see anything
+            std::fill_n(&m_pvs[cluster * m_rowBytes], m_rowBytes, 0xFF);
+            continue;
+        }
+
+        // Zero bytes are followed by a count of zero bytes to emit
+        uint8_t* row = &m_pvs[cluster * m_rowBytes];
+        const uint8_t* in = visData + offset;
+        size_t out = 0;
+        while (out < m_rowBytes && in < visEnd) {
+            if (*in) {
+                row[out++] = *in++;
+                continue;
+            }
+            if (in + 1 >= visEnd) break;
+            out += in[1];
+            in += 2;
+        }
+    }
+
+    return true;
+}
+
+void Visibility::Clear() {
+    m_nodes.clear();
+    m_leafClusters.clear();
+    m_leafBounds.clear();
+    m_pvs.clear();
+    m_headNode = 0;
+    m_clusterCount = 0;
+    m_rowBytes = 0;
+}
+
+int Visibility::FindLeaf(const Vec3& point) const {
+    if (m_nodes.empty()) return -1;
+
+    int32_t node = m_headNode;
+    while (node >= 0) {
+        const Node& n = m_nodes[node];
+        float dist = n.normal[0] * point.x + n.normal[1] * point.y + n.normal[2] * point.z - n.dist;
+        node = n.children[dist >= 0.0f ? 0 : 1];
+    }
+    return -1 - node;
+}
+
+int Visibility::LeafCluster(int leaf) const {
+    if (leaf < 0 || static_cast<size_t>(leaf) >= m_leafClusters.size()) return -1;
+    return m_leafClusters[leaf];
+}
+
+void Visibility::GetLeafBounds(int leaf, Vec3& mins, Vec3& maxs) const {
+    mins = maxs = {0, 0, 0};
+    if (leaf < 0 || static_cast<size_t>(leaf) >= m_leafClusters.size()) return;
+
+    const int16_t* bounds = &m_leafBounds[leaf * 6];
+    mins = {static_cast<float>(bounds[0]), static_cast<float>(bounds[1]), static_cast<float>(bounds[2])};
+    maxs = {static_cast<float>(bounds[3]), static_cast<float>(bounds[4]), static_cast<float>(bounds[5])};
+}
+
+const uint8_t* Visibility::GetPVS(int cluster) const {
+    if (cluster < 0 || cluster >= m_clusterCount) return nullptr;
+    return &m_pvs[cluster * m_rowBytes];
+}
+
+bool Visibility::IsClusterVisible(int from, int to) const {
+    const uint8_t* row = GetPVS(from);
+    if (!row || to < 0 || to >= m_clusterCount) return true;
+    return (row[to >> 3] & (1 << (to & 7))) != 0;
+}
+
+bool Visibility::IsVisibleFrom(int camera, const int* clusters, size_t count) const {
+    if (count == 0) return true;
+
+    for (size_t i = 0; i < count; i++) {
+        if (IsClusterVisible(camera, clusters[i])) return true;
+    }
+    return false;
+}
+
+void Visibility::GetClustersInBox(const Vec3& mins, const Vec3& maxs, std::vector<int>& out) const {
+    out.clear();
+    if (m_nodes.empty()) return;
+
+    const float center[3] = {(mins.x + maxs.x) * 0.5f, (mins.y + maxs.y) * 0.5f, (mins.z + maxs.z) * 0.5f};
+    const float extent[3] = {(maxs.x - mins.x) * 0.5f, (maxs.y - mins.y) * 0.5f, (maxs.z - mins.z) * 0.5f};
+    const float epsilon = 0.1f;
+
+    std::vector<int32_t> stack = {m_headNode};
+    while (!stack.empty()) {
+        int32_t node = stack.back();
+        stack.pop_back();
+
+        if (node < 0) {
+            int cluster = m_leafClusters[-1 - node];
+            if (cluster >= 0) out.push_back(cluster);
+            continue;
+        }
+
+        const Node& n = m_nodes[node];
+        float dist = n.normal[0] * center[0] + n.normal[1] * center[1] + n.normal[2] * center[2] - n.dist;
+        float radius = std::fabs(n.normal[0]) * extent[0] + std::fabs(n.normal[1]) * extent[1] +
+                       std::fabs(n.normal[2]) * extent[2] + epsilon;
+
+        if (dist > -radius) stack.push_back(n.children[0]);
+        if (dist < radius) stack.push_back(n.children[1]);
+    }
+
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+PVSCheck CheckBoxPVS(const Visibility& visibility, const Vec3* mins, const Vec3* maxs, size_t boxCount,
+                     const uint32_t* clusterStart, const int* clusters, int maxClusters) {
+    PVSCheck check;
+    const int leafCount = static_cast<int>(visibility.LeafCount());
+    const float tolerance = 1.0f;
+
+    std::vector<std::vector<int>> leafClusters(boxCount);
+    for (size_t box = 0; box < boxCount; box++) {
+        std::vector<int>& overlapping = leafClusters[box];
+        for (int leaf = 0; leaf < leafCount; leaf++) {
+            int cluster = visibility.LeafCluster(leaf);
+            if (cluster < 0) continue;
+
+            Vec3 leafMins, leafMaxs;
+            visibility.GetLeafBounds(leaf, leafMins, leafMaxs);
+            if (mins[box].x > leafMaxs.x + tolerance || maxs[box].x < leafMins.x - tolerance ||
+                mins[box].y > leafMaxs.y + tolerance || maxs[box].y < leafMins.y - tolerance ||
+                mins[box].z > leafMaxs.z + tolerance || maxs[box].z < leafMins.z - tolerance) continue;
+            overlapping.push_back(cluster);
+        }
+        std::sort(overlapping.begin(), overlapping.end());
+        overlapping.erase(std::unique(overlapping.begin(), overlapping.end()), overlapping.end());
+
+        // Every cluster found by the tree walk must come from an overlapping leaf
+        for (uint32_t i = clusterStart[box]; i < clusterStart[box + 1]; i++) {
+            if (!std::binary_search(overlapping.begin(), overlapping.end(), clusters[i])) check.missingFromLeaves++;
+        }
+    }
+
+    const int clusterCount = visibility.ClusterCount();
+    const int step = std::max(1, clusterCount / std::max(maxClusters, 1));
+
+    for (int camera = 0; camera < clusterCount; camera += step) {
+        for (size_t box = 0; box < boxCount; box++) {
+            bool ours = visibility.IsVisibleFrom(camera, clusters + clusterStart[box],
+                                                 clusterStart[box + 1] - clusterStart[box]);
+            bool implied = visibility.IsVisibleFrom(camera, leafClusters[box].data(), leafClusters[box].size());
+
+            check.compared++;
+            if (ours == implied) check.matching++;
+            else if (implied) check.tighter++;
+            else check.looser++;
+        }
+    }
+
+    return check;
+}
+
+} // namespace BSPReader
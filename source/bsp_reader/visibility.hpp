@@ -0,0 +1,75 @@
+#pragma once
+#include "bsp_reader.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BSPReader {
+    // The world BSP tree plus the decompressed potentially visible sets.
+    // Everything needed is copied out of the map, so it stays valid after
+    // the map is closed.
+    class Visibility {
+    public:
+        // Fails on maps without nodes, leaves or vis data (unvised maps)
+        bool Load(const Map& map, std::string& error);
+        void Clear();
+
+        bool IsLoaded() const { return !m_leafClusters.empty() && m_clusterCount > 0; }
+        int ClusterCount() const { return m_clusterCount; }
+        size_t LeafCount() const { return m_leafClusters.size(); }
+        size_t RowBytes() const { return m_rowBytes; }
+
+        // Leaf containing point, walking the world model's tree
+        int FindLeaf(const Vec3& point) const;
+        int LeafCluster(int leaf) const;
+        void GetLeafBounds(int leaf, Vec3& mins, Vec3& maxs) const;
+
+        // Bit per cluster; nullptr for cluster -1 (solid or outside the map)
+        const uint8_t* GetPVS(int cluster) const;
+        bool IsClusterVisible(int from, int to) const;
+        // Whether a box overlapping clusters[0..count) may be seen from the
+        // camera cluster. Boxes inside no cluster (entirely in solid) are
+        // kept rather than guessed at.
+        bool IsVisibleFrom(int camera, const int* clusters, size_t count) const;
+
+        // Sorted, unique clusters of every non-solid leaf the box touches.
+        // Faces lie on node planes, so boxes touching a plane descend both sides.
+        void GetClustersInBox(const Vec3& mins, const Vec3& maxs, std::vector<int>& out) const;
+
+    private:
+        struct Node {
+            float normal[3];
+            float dist;
+            int32_t children[2];
+        };
+
+        std::vector<Node> m_nodes;
+        std::vector<int16_t> m_leafClusters;
+        std::vector<int16_t> m_leafBounds;  // mins xyz, maxs xyz per leaf
+        int32_t m_headNode = 0;
+
+        int m_clusterCount = 0;
+        size_t m_rowBytes = 0;
+        std::vector<uint8_t> m_pvs;  // ClusterCount() rows of RowBytes()
+    };
+
+    struct PVSCheck {
+        size_t compared = 0;           // Box/camera cluster pairs
+        size_t matching = 0;           // Same verdict as the leaf data
+        size_t tighter = 0;            // Hidden although the leaf data shows it
+        size_t looser = 0;             // Shown although the leaf data hides it
+        size_t missingFromLeaves = 0;  // Walked clusters without an overlapping leaf
+
+        bool Passed() const { return missingFromLeaves == 0 && looser == 0; }
+    };
+
+    // Checks the PVS verdicts for boxes whose clusters came from
+    // GetClustersInBox (box i owns clusters[clusterStart[i]..clusterStart[i + 1]))
+    // against a brute-force pass over the leaves: from cluster c, a box is
+    // implied visible when it overlaps the bounds of any leaf whose cluster c
+    // can see. Leaf bounds are conservative, so the tree walk may hide more
+    // ("tighter") but must never show a box the leaf data hides. Samples up
+    // to maxClusters camera clusters.
+    PVSCheck CheckBoxPVS(const Visibility& visibility, const Vec3* mins, const Vec3* maxs, size_t boxCount,
+                         const uint32_t* clusterStart, const int* clusters, int maxClusters);
+}
@@ -1,4 +1,8 @@
 #include "entity_manager.hpp"
+#include "entity_registry.hpp"
+#include "math/point_kernels.hpp"
+#include "mesh_builder/worker_pool.hpp"
+#include "lua_util.hpp"
 #include "mathlib/vector.h"
 #include "mathlib/mathlib.h"
 #include "vstdlib/random.h"
@@ -74,71 +78,42 @@ void AngleVectorsRadians(const QAngle& angles, Vector* forward, Vector* right, V
     }
 }
 
+static_assert(sizeof(Vector) == sizeof(float) * 3, "Vector must be tightly packed xyz");
+
 BatchedMesh ProcessVerticesSIMD(const std::vector<Vector>& vertices,
                                const std::vector<Vector>& normals,
                                const std::vector<BatchedMesh::UV>& uvs,
                                uint32_t maxVertices) {
     BatchedMesh result;
-    result.vertexCount = 0;
-    
-    // Pre-allocate with alignment
+
     const size_t vertCount = std::min(vertices.size(), static_cast<size_t>(maxVertices));
-    result.positions.reserve(vertCount);
-    result.normals.reserve(vertCount);
-    result.uvs.reserve(vertCount);
-
-    // Process in batches of 4 vertices (SSE)
-    for (size_t i = 0; i < vertCount; i += 4) {
-        __m128 positions[4];
-        __m128 norms[4];
-        __m128 uvCoords[4];
-        
-        // Load 4 vertices
-        for (size_t j = 0; j < 4 && (i + j) < vertCount; j++) {
-            const Vector& pos = vertices[i + j];
-            positions[j] = _mm_set_ps(0.0f, pos.z, pos.y, pos.x);
-            
-            if (i + j < normals.size()) {
-                const Vector& norm = normals[i + j];
-                norms[j] = _mm_set_ps(0.0f, norm.z, norm.y, norm.x);
-            }
-            
-            if (i + j < uvs.size()) {
-                const BatchedMesh::UV& uv = uvs[i + j];
-                uvCoords[j] = _mm_set_ps(0.0f, 0.0f, uv.v, uv.u);
-            }
-        }
+    result.vertexCount = static_cast<uint32_t>(vertCount);
 
-        // Process 4 vertices in parallel
-        for (size_t j = 0; j < 4 && (i + j) < vertCount; j++) {
-            // Transform position
-            float pos[4];
-            _mm_store_ps(pos, positions[j]);
-            result.positions.emplace_back(pos[0], pos[1], pos[2]);
-
-            // Transform normal
-            float norm[4];
-            _mm_store_ps(norm, norms[j]);
-            result.normals.emplace_back(norm[0], norm[1], norm[2]);
-
-            // Store UV
-            float uv[4];
-            _mm_store_ps(uv, uvCoords[j]);
-            result.uvs.push_back({uv[0], uv[1]});
-            
-            result.vertexCount++;
-        }
-    }
+    // Positions and UVs are plain bulk copies
+    result.positions.assign(vertices.begin(), vertices.begin() + vertCount);
+
+    const size_t uvCount = std::min(uvs.size(), vertCount);
+    result.uvs.assign(uvs.begin(), uvs.begin() + uvCount);
+    result.uvs.resize(vertCount, BatchedMesh::UV{0.0f, 0.0f});
+
+    // Normals are copied, then renormalized with the dispatched SoA kernels
+    const size_t normalCount = std::min(normals.size(), vertCount);
+    result.normals.assign(normals.begin(), normals.begin() + normalCount);
+    result.normals.resize(vertCount, Vector(0, 0, 0));
+    RTXMath::RenormalizeInterleaved(reinterpret_cast<float*>(result.normals.data()), vertCount);
 
     return result;
 }
 
-
 LUA_FUNCTION(CreateOptimizedMeshBatch_Native) {
     LUA->CheckType(1, Type::TABLE);  // vertices
     LUA->CheckType(2, Type::TABLE);  // normals
     LUA->CheckType(3, Type::TABLE);  // uvs
-    uint32_t maxVertices = LUA->CheckNumber(4);
+    // Parts are indexed with 16 bits; maxIndices 0 means 3 * maxVertices
+    uint32_t maxVertices = static_cast<uint32_t>(LuaUtil::ClampNumber(LUA->CheckNumber(4), 3.0, 65536.0));
+    uint32_t maxIndices = LUA->IsType(5, Type::Number)
+        ? static_cast<uint32_t>(LuaUtil::ClampNumber(LUA->GetNumber(5), 0.0, 3.0 * 65536.0))
+        : 0;
 
     std::vector<Vector> vertices;
     std::vector<Vector> normals;
@@ -174,49 +149,30 @@ LUA_FUNCTION(CreateOptimizedMeshBatch_Native) {
         LUA->Pop();
     }
 
-    BatchedMesh result = CreateOptimizedMeshBatch(vertices, normals, uvs, maxVertices);
-
-    // Create return table with the same structure as before
-    LUA->CreateTable();
-    
-    // Add vertices
-    LUA->CreateTable();
-    for (size_t i = 0; i < result.positions.size(); i++) {
-        LUA->PushNumber(i + 1);
-        Vector* v = new Vector(result.positions[i]);
-        LUA->PushUserType(v, Type::Vector);
-        LUA->SetTable(-3);
-    }
-    LUA->SetField(-2, "vertices");
-
-    // Add normals
-    LUA->CreateTable();
-    for (size_t i = 0; i < result.normals.size(); i++) {
-        LUA->PushNumber(i + 1);
-        Vector* n = new Vector(result.normals[i]);
-        LUA->PushUserType(n, Type::Vector);
-        LUA->SetTable(-3);
-    }
-    LUA->SetField(-2, "normals");
+    std::vector<BatchedMesh> batches = CreateOptimizedMeshBatch(vertices, normals, uvs, maxVertices, maxIndices);
 
-    // Add UVs
+    // Hand the packed buffers to Lua as-is instead of boxing every vertex
     LUA->CreateTable();
-    for (size_t i = 0; i < result.uvs.size(); i++) {
-        LUA->PushNumber(i + 1);
-        Vector* uv = new Vector(result.uvs[i].u, result.uvs[i].v, 0);
-        LUA->PushUserType(uv, Type::Vector);
+    for (size_t i = 0; i < batches.size(); i++) {
+        LUA->PushNumber(static_cast<double>(i + 1));
+        PushMeshBuffer(LUA, std::move(batches[i]));
         LUA->SetTable(-3);
     }
-    LUA->SetField(-2, "uvs");
-
     return 1;
 }
 
-BatchedMesh CreateOptimizedMeshBatch(const std::vector<Vector>& vertices,
-                                   const std::vector<Vector>& normals,
-                                   const std::vector<BatchedMesh::UV>& uvs,
-                                   uint32_t maxVertices) {
-    return ProcessVerticesSIMD(vertices, normals, uvs, maxVertices);
+std::vector<BatchedMesh> CreateOptimizedMeshBatch(const std::vector<Vector>& vertices,
+                                                  const std::vector<Vector>& normals,
+                                                  const std::vector<BatchedMesh::UV>& uvs,
+                                                  uint32_t maxVertices, uint32_t maxIndices) {
+    // Only whole triangles are kept; a trailing partial one cannot be drawn anyway
+    const uint32_t wholeTriangles = static_cast<uint32_t>(vertices.size() / 3 * 3);
+    BatchedMesh packed = ProcessVerticesSIMD(vertices, normals, uvs, wholeTriangles);
+
+    MeshBuilder::SplitOptions options;
+    options.maxVertices = maxVertices;
+    options.maxIndices = maxIndices;
+    return packed.Split(options);
 }
 
 LUA_FUNCTION(ProcessRegionBatch_Native) {
@@ -245,6 +201,7 @@ LUA_FUNCTION(ProcessRegionBatch_Native) {
 
 BatchedMesh BatchedMesh::CombineBatchesSIMD(const std::vector<BatchedMesh>& meshes) {
     BatchedMesh combined;
+    combined.vertexCount = 0;
     size_t totalVerts = 0;
     
     // Calculate total size
@@ -257,53 +214,12 @@ BatchedMesh BatchedMesh::CombineBatchesSIMD(const std::vector<BatchedMesh>& mesh
     combined.normals.reserve(totalVerts);
     combined.uvs.reserve(totalVerts);
     
-    // Combine using SIMD for 4 vertices at a time
-    std::vector<SIMDVertex, AlignedAllocator<SIMDVertex>> vertices;
-    vertices.reserve(totalVerts);
-    
+    // Vertices are already in their final layout, so combining is a straight append
     for (const auto& mesh : meshes) {
-        for (size_t i = 0; i < mesh.vertexCount; i++) {
-            SIMDVertex vert;
-            vert.pos = _mm_set_ps(0.0f, 
-                                 mesh.positions[i].z,
-                                 mesh.positions[i].y, 
-                                 mesh.positions[i].x);
-            vert.norm = _mm_set_ps(0.0f,
-                                  mesh.normals[i].z,
-                                  mesh.normals[i].y,
-                                  mesh.normals[i].x);
-            vert.uv = _mm_set_ps(0.0f, 0.0f,
-                                mesh.uvs[i].v,
-                                mesh.uvs[i].u);
-            vertices.push_back(vert);
-        }
-    }
-    
-    // Process combined vertices in batches of 4
-    for (size_t i = 0; i < vertices.size(); i += 4) {
-        __m128 positions[4];
-        __m128 normals[4];
-        __m128 uvs[4];
-        
-        // Load 4 vertices
-        for (size_t j = 0; j < 4 && (i + j) < vertices.size(); j++) {
-            positions[j] = vertices[i + j].pos;
-            normals[j] = vertices[i + j].norm;
-            uvs[j] = vertices[i + j].uv;
-        }
-        
-        // Store processed vertices
-        for (size_t j = 0; j < 4 && (i + j) < vertices.size(); j++) {
-            float pos[4], norm[4], uv[4];
-            _mm_store_ps(pos, positions[j]);
-            _mm_store_ps(norm, normals[j]);
-            _mm_store_ps(uv, uvs[j]);
-            
-            combined.positions.emplace_back(pos[0], pos[1], pos[2]);
-            combined.normals.emplace_back(norm[0], norm[1], norm[2]);
-            combined.uvs.push_back({uv[0], uv[1]});
-            combined.vertexCount++;
-        }
+        combined.positions.insert(combined.positions.end(), mesh.positions.begin(), mesh.positions.begin() + mesh.vertexCount);
+        combined.normals.insert(combined.normals.end(), mesh.normals.begin(), mesh.normals.begin() + mesh.vertexCount);
+        combined.uvs.insert(combined.uvs.end(), mesh.uvs.begin(), mesh.uvs.begin() + mesh.vertexCount);
+        combined.vertexCount += mesh.vertexCount;
     }
     
     return combined;
@@ -391,85 +307,85 @@ LUA_FUNCTION(CalculateSpecialEntityBounds_Native) {
 }
 
 LUA_FUNCTION(FilterEntitiesByDistance_Native) {
-    LUA->CheckType(1, Type::TABLE);  // entities
-    LUA->CheckType(2, Type::Vector);  // origin
-    LUA->CheckNumber(3);  // maxDistance
+    LUA->CheckType(1, Type::Vector);  // origin
+    LUA->CheckNumber(2);  // maxDistance
+
+    Vector* origin = LUA->GetUserType<Vector>(1, Type::Vector);
+    float maxDistance = LUA->GetNumber(2);
 
-    Vector* origin = LUA->GetUserType<Vector>(2, Type::Vector);
-    float maxDistance = LUA->GetNumber(3);
-    float maxDistSqr = maxDistance * maxDistance;
+    // Optional class filter; an unknown class matches nothing
+    bool filterClass = LUA->IsType(3, Type::String);
+    uint16_t classId = 0;
+    if (filterClass && !FindEntityClass(LUA->GetString(3), classId)) {
+        LUA->CreateTable();
+        return 1;
+    }
+
+    const EntityTable& entities = GetEntityTable();
+    const float center[3] = {origin->x, origin->y, origin->z};
+    static std::vector<uint32_t> rows;
+    entities.QueryRadius(center, maxDistance, rows);
 
     // Create result table
     LUA->CreateTable();
-    int resultTable = LUA->Top();
     int index = 1;
-
-    // Iterate input table
-    LUA->PushNil();
-    while (LUA->Next(1) != 0) {
-        if (LUA->IsType(-1, Type::Entity)) {
-            // Get entity position
-            LUA->GetField(-1, "GetPos");
-            LUA->Push(-2);
-            LUA->Call(1, 1);
-            Vector* pos = LUA->GetUserType<Vector>(-1, Type::Vector);
-
-            // Calculate distance
-            float dx = pos->x - origin->x;
-            float dy = pos->y - origin->y;
-            float dz = pos->z - origin->z;
-            float distSqr = dx*dx + dy*dy + dz*dz;
-
-            if (distSqr <= maxDistSqr) {
-                LUA->PushNumber(index++);
-                LUA->Push(-2);  // Push the entity
-                LUA->SetTable(resultTable);
-            }
-
-            LUA->Pop();  // Pop position
-        }
-        LUA->Pop();  // Pop value, keep key for next iteration
+    for (uint32_t row : rows) {
+        if (filterClass && entities.ClassIds()[row] != classId) continue;
+        LUA->PushNumber(index++);
+        LUA->ReferencePush(entities.Handles()[row]);
+        LUA->SetTable(-3);
     }
 
     return 1;  // Return the filtered table
 }
 
 LUA_FUNCTION(BatchUpdateEntityBounds_Native) {
-    LUA->CheckType(1, Type::TABLE);
+    LUA->CheckType(1, Type::Vector);
     LUA->CheckType(2, Type::Vector);
-    LUA->CheckType(3, Type::Vector);
-
-    Vector* mins = LUA->GetUserType<Vector>(2, Type::Vector);
-    Vector* maxs = LUA->GetUserType<Vector>(3, Type::Vector);
-
-    RTXMath::Vector3 rtxMins = {mins->x, mins->y, mins->z};
-    RTXMath::Vector3 rtxMaxs = {maxs->x, maxs->y, maxs->z};
-
-    // Process entity table
-    LUA->PushNil();
-    while (LUA->Next(1) != 0) {
-        if (LUA->IsType(-1, Type::Entity)) {
-            // Get entity position
-            LUA->GetField(-1, "GetPos");
-            LUA->Push(-2);
-            LUA->Call(1, 1);
-            Vector* pos = LUA->GetUserType<Vector>(-1, Type::Vector);
-
-            if (RTXMath::IsWithinBounds({pos->x, pos->y, pos->z}, rtxMins, rtxMaxs)) {
-                // Set render bounds
-                LUA->GetField(-2, "SetRenderBounds");
-                LUA->Push(-3);
-                LUA->Push(2);  // mins
-                LUA->Push(3);  // maxs
-                LUA->Call(3, 0);
-            }
 
-            LUA->Pop();  // Pop position
+    Vector* mins = LUA->GetUserType<Vector>(1, Type::Vector);
+    Vector* maxs = LUA->GetUserType<Vector>(2, Type::Vector);
+
+    const float boundsMins[3] = {mins->x, mins->y, mins->z};
+    const float boundsMaxs[3] = {maxs->x, maxs->y, maxs->z};
+
+    // Positions come from the last sync, so only SetRenderBounds goes through Lua
+    EntityTable& entities = GetEntityTable();
+    static std::vector<uint32_t> rows;
+    rows.resize(entities.Size());
+    rows.resize(RTXMath::SelectPointsInBox(entities.X(), entities.Y(), entities.Z(), entities.Size(),
+                                           boundsMins, boundsMaxs, rows.data()));
+
+    // Only entities Lua handed over are touched; those that already have
+    // these bounds from an earlier call are skipped
+    int applied = 0, skipped = 0;
+    for (uint32_t row : rows) {
+        if (!entities.IsBoundsManaged(entities.Indices()[row])) continue;
+        if (!entities.UpdateRenderBounds(row, boundsMins, boundsMaxs)) {
+            skipped++;
+            continue;
         }
-        LUA->Pop();  // Pop value, keep key for next iteration
+
+        LUA->ReferencePush(entities.Handles()[row]);
+        LUA->GetField(-1, "SetRenderBounds");
+        LUA->Push(-2);
+        LUA->Push(1);  // mins
+        LUA->Push(2);  // maxs
+        LUA->Call(3, 0);
+        LUA->Pop();  // Pop entity
+        applied++;
     }
 
-    return 0;
+    RenderBoundsStats& stats = GetRenderBoundsStats();
+    stats.calls++;
+    stats.applied += applied;
+    stats.skipped += skipped;
+    stats.lastApplied = applied;
+    stats.lastSkipped = skipped;
+
+    LUA->PushNumber(applied);
+    LUA->PushNumber(skipped);
+    return 2;
 }
 
 LUA_FUNCTION(UpdateLightCache_Native) {
@@ -688,6 +604,8 @@ LUA_FUNCTION(GetRandomLights_Native) {
 }
 
 void Initialize(ILuaBase* LUA) {
+    RegisterMeshBufferType(LUA);
+
     LUA->CreateTable();
 
     // Add existing functions
@@ -712,7 +630,18 @@ void Initialize(ILuaBase* LUA) {
     LUA->PushCFunction(ProcessRegionBatch_Native);
     LUA->SetField(-2, "ProcessRegionBatch");
 
+    RegisterWorldGeometryFunctions(LUA);
+    RegisterWorldCullingFunctions(LUA);
+    RegisterRemixWorldFunctions(LUA);
+    RegisterEntityRegistryFunctions(LUA);
+    RegisterStaticPropFunctions(LUA);
+
     LUA->SetField(-2, "EntityManager");
 }
 
+void Shutdown() {
+    UnloadWorldGeometry();
+    MeshBuilder::WorkerPool::Instance().Shutdown();
+}
+
 } // namespace EntityManager
\ No newline at end of file
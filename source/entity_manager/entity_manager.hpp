@@ -1,9 +1,15 @@
 #pragma once
 #include "GarrysMod/Lua/Interface.h"
 #include "math/math.hpp"
+#include "math/vertex_kernels.hpp"
+#include "math/compact_vertex.hpp"
+#include "bsp_reader/bsp_reader.hpp"
+#include "mesh_builder/vertex_weld.hpp"
+#include "mesh_builder/mesh_splitter.hpp"
 #include "mathlib/vector.h"
 #include <unordered_map>
 #include <vector>
+#include <string>
 #include <random>
 #include <immintrin.h> // For SSE/AVX intrinsics
 
@@ -79,12 +85,48 @@ namespace EntityManager {
         };
         std::vector<UV> uvs;
         uint32_t vertexCount;
+        // Triangle list over the vertices above; empty for unindexed soup
+        MeshBuilder::IndexBuffer indices;
+
+        // Compact layout: when non-empty it replaces positions/normals/uvs
+        std::vector<RTXMath::CompactVertex> compact;
+        float uvOffset[2] = {0.0f, 0.0f};
+
+        bool IsCompact() const { return !compact.empty(); }
+        // Re-encodes the float streams into the 20-byte compact layout.
+        // Returns false and keeps the float layout when the UVs span too
+        // many tiles for half floats (see RTXMath::ChooseCompactUVOffset).
+        bool Compact();
+        size_t MemoryBytes() const;
+
+        // Layout-independent vertex access
+        Vector GetPosition(size_t i) const;
+        Vector GetNormal(size_t i) const;
+        UV GetUV(size_t i) const;
+
+        // Number of vertices a triangle-list draw of this mesh emits
+        size_t DrawVertexCount() const { return indices.Empty() ? vertexCount : indices.Size(); }
+        // Merges duplicate vertices of an unindexed mesh into an index buffer
+        void Weld(const MeshBuilder::WeldOptions& options, MeshBuilder::WeldStats* stats = nullptr);
+        // Partitions into spatially compact sub-meshes that each fit the
+        // budgets; no triangle is cut or dropped. Keeps layout and indexing.
+        std::vector<BatchedMesh> Split(const MeshBuilder::SplitOptions& options,
+                                       MeshBuilder::SplitStats* stats = nullptr) const;
         
         // Add SIMD batch processing
         void ProcessVertexBatchSIMD(const VertexBatch& batch);
         static BatchedMesh CombineBatchesSIMD(const std::vector<BatchedMesh>& meshes);
     };
 
+    // Lua userdata that owns a BatchedMesh on the C++ side, so finished batches
+    // never have to be expanded into tables of Vector objects
+    extern int MeshBufferTypeId;
+    void PushMeshBuffer(GarrysMod::Lua::ILuaBase* LUA, BatchedMesh&& mesh);
+    BatchedMesh* CheckMeshBuffer(GarrysMod::Lua::ILuaBase* LUA, int stackPos);
+    void RegisterMeshBufferType(GarrysMod::Lua::ILuaBase* LUA);
+    BatchedMesh BatchedMeshFromVertices(const BSPReader::TriangleVertex* vertices, size_t count,
+                                        const MeshBuilder::IndexBuffer* indices = nullptr);
+
     // Light structure definition
     struct Light {
         Vector position;
@@ -108,13 +150,16 @@ namespace EntityManager {
     extern std::mt19937 rng;
 
     // Helper functions
+    void AngleVectorsRadians(const QAngle& angles, Vector* forward, Vector* right, Vector* up);
     void ShuffleLights();
     void GetRandomLights(int count, std::vector<Light>& outLights);
 
-    BatchedMesh CreateOptimizedMeshBatch(const std::vector<Vector>& vertices, 
-                                       const std::vector<Vector>& normals,
-                                       const std::vector<BatchedMesh::UV>& uvs,
-                                       uint32_t maxVertices);
+    // Packs a triangle soup and splits it into sub-meshes of at most
+    // maxVertices vertices (and maxIndices indices, 0 = 3 * maxVertices)
+    std::vector<BatchedMesh> CreateOptimizedMeshBatch(const std::vector<Vector>& vertices,
+                                                      const std::vector<Vector>& normals,
+                                                      const std::vector<BatchedMesh::UV>& uvs,
+                                                      uint32_t maxVertices, uint32_t maxIndices = 0);
 
     // SIMD processing functions
     BatchedMesh ProcessVerticesSIMD(const std::vector<Vector>& vertices,
@@ -126,6 +171,40 @@ namespace EntityManager {
                           const Vector& playerPos,
                           float threshold);
 
+    // Map geometry decoded natively from the .bsp, shared by the world mesh builders
+    BSPReader::Map& GetWorldMap();
+    const BSPReader::WorldGeometry& GetWorldGeometry();
+    bool LoadWorldGeometry(const std::string& path, std::string& error);
+    bool LoadWorldGeometryFromMemory(std::vector<uint8_t>&& data, std::string& error);
+    void UnloadWorldGeometry();
+    void RegisterWorldGeometryFunctions(GarrysMod::Lua::ILuaBase* LUA);
+
+    // Native frustum/distance culling of the world meshes registered from Lua
+    void RegisterWorldCullingFunctions(GarrysMod::Lua::ILuaBase* LUA);
+    // Same as AddChunkBounds; returns the 0-based id
+    uint32_t RegisterChunkDraw(const float mins[3], const float maxs[3], uint32_t material, bool translucent,
+                               uint32_t lodCount = 0);
+    // Draw list of the last CullChunks call, in draw order
+    size_t GetCulledChunks(const uint32_t*& chunks);
+
+    // World chunk meshes submitted straight to the Remix API
+    void RegisterRemixWorldFunctions(GarrysMod::Lua::ILuaBase* LUA);
+
+    // Entities mirrored by the last SyncEntities call
+    class EntityTable;
+    EntityTable& GetEntityTable();
+    // Applied/skipped counts of BatchUpdateEntityBounds
+    struct RenderBoundsStats;
+    RenderBoundsStats& GetRenderBoundsStats();
+    bool FindEntityClass(const char* name, uint16_t& classId);
+    void RegisterEntityRegistryFunctions(GarrysMod::Lua::ILuaBase* LUA);
+
+    // BVH over the current map's static props, built from Lua at map load
+    void RegisterStaticPropFunctions(GarrysMod::Lua::ILuaBase* LUA);
+
     // Initialize entity manager
     void Initialize(GarrysMod::Lua::ILuaBase* LUA);
+    // Cancels any chunk build, drops the native map and joins the mesh
+    // builder threads; called from GMOD_MODULE_CLOSE
+    void Shutdown();
 }
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "entity_manager.hpp"
+#include "entity_registry.hpp"
+#include "lua_util.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+using namespace GarrysMod::Lua;
+
+namespace EntityManager {
+
+// The table every query runs against; Lua holds one registry reference per row
+static EntityTable s_entities;
+
+// Class names interned to the ids stored in the table
+static std::vector<std::string> s_classNames;
+static std::unordered_map<std::string, uint16_t> s_classIds;
+
+struct EntitySyncStats {
+    size_t syncs = 0;
+    size_t added = 0;      // Rows created by the last sync
+    size_t removed = 0;    // Rows dropped by the last sync
+    double syncMs = 0.0;
+};
+static EntitySyncStats s_syncStats;
+static RenderBoundsStats s_boundsStats;
+
+EntityTable& GetEntityTable() {
+    return s_entities;
+}
+
+RenderBoundsStats& GetRenderBoundsStats() {
+    return s_boundsStats;
+}
+
+bool FindEntityClass(const char* name, uint16_t& classId) {
+    auto it = s_classIds.find(name);
+    if (it == s_classIds.end()) return false;
+    classId = it->second;
+    return true;
+}
+
+static uint16_t InternEntityClass(const char* name) {
+    auto it = s_classIds.find(name);
+    if (it != s_classIds.end()) return it->second;
+
+    // Class names are a small fixed set in practice; the last id absorbs any overflow
+    uint16_t id = static_cast<uint16_t>(std::min<size_t>(s_classNames.size(), UINT16_MAX));
+    if (id < UINT16_MAX) s_classNames.push_back(name);
+    s_classIds.emplace(name, id);
+    return id;
+}
+
+static int32_t GetEntityIndex(ILuaBase* LUA, int stackPos) {
+    LUA->GetField(stackPos, "EntIndex");
+    LUA->Push(stackPos < 0 ? stackPos - 1 : stackPos);
+    LUA->Call(1, 1);
+    int32_t index = static_cast<int32_t>(LUA->GetNumber(-1));
+    LUA->Pop();
+    return index;
+}
+
+static void ClearEntityTable(ILuaBase* LUA) {
+    for (size_t row = 0; row < s_entities.Size(); row++) {
+        LUA->ReferenceFree(s_entities.Handles()[row]);
+    }
+    s_entities.Clear();
+}
+
+LUA_FUNCTION(SyncEntities_Native) {
+    LUA->CheckType(1, Type::TABLE);  // entities
+
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t before = s_entities.Size();
+    s_entities.BeginSync();
+
+    LUA->PushNil();
+    while (LUA->Next(1) != 0) {
+        if (LUA->IsType(-1, Type::Entity)) {
+            // Clientside-only entities all share index -1 and are not mirrored
+            int32_t index = GetEntityIndex(LUA, -1);
+            if (index > 0) {
+                LUA->GetField(-1, "GetPos");
+                LUA->Push(-2);
+                LUA->Call(1, 1);
+                Vector pos = *LUA->GetUserType<Vector>(-1, Type::Vector);
+                LUA->Pop();
+
+                uint32_t row = s_entities.Find(index);
+                if (row == EntityTable::kNoRow) {
+                    // Class and reference are only looked up the first time an index shows up
+                    LUA->GetField(-1, "GetClass");
+                    LUA->Push(-2);
+                    LUA->Call(1, 1);
+                    uint16_t classId = InternEntityClass(LUA->GetString(-1));
+                    LUA->Pop();
+
+                    LUA->Push(-1);
+                    int handle = LUA->ReferenceCreate();
+                    s_entities.Set(index, classId, pos.x, pos.y, pos.z, handle);
+                } else {
+                    s_entities.Set(index, s_entities.ClassIds()[row], pos.x, pos.y, pos.z, s_entities.Handles()[row]);
+                }
+            }
+        }
+        LUA->Pop();  // Pop value, keep key for next iteration
+    }
+
+    std::vector<int> removedHandles;
+    s_syncStats.removed = s_entities.EndSync(&removedHandles);
+    for (int handle : removedHandles) {
+        LUA->ReferenceFree(handle);
+    }
+    s_syncStats.added = s_entities.Size() + s_syncStats.removed - before;
+    s_syncStats.syncs++;
+    s_syncStats.syncMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    LUA->PushNumber(static_cast<double>(s_entities.Size()));
+    return 1;
+}
+
+LUA_FUNCTION(RemoveEntity_Native) {
+    LUA->CheckType(1, Type::Entity);
+
+    int handle = 0;
+    bool removed = s_entities.Remove(GetEntityIndex(LUA, 1), &handle);
+    if (removed) LUA->ReferenceFree(handle);
+
+    LUA->PushBool(removed);
+    return 1;
+}
+
+LUA_FUNCTION(ClearEntities_Native) {
+    ClearEntityTable(LUA);
+    return 0;
+}
+
+// SetEntityBoundsManaged(ent, managed): hands the entity's default render
+// bounds to BatchUpdateEntityBounds, or takes them back for entities Lua
+// gives bounds of their own
+LUA_FUNCTION(SetEntityBoundsManaged_Native) {
+    LUA->CheckType(1, Type::Entity);
+    s_entities.SetBoundsManaged(GetEntityIndex(LUA, 1), LUA->GetBool(2));
+    return 0;
+}
+
+LUA_FUNCTION(GetEntityRegistryStats_Native) {
+    LUA->CreateTable();
+
+    LUA->PushNumber(static_cast<double>(s_entities.Size()));
+    LUA->SetField(-2, "entities");
+
+    LUA->PushNumber(static_cast<double>(s_classNames.size()));
+    LUA->SetField(-2, "classes");
+
+    LUA->PushNumber(static_cast<double>(s_syncStats.syncs));
+    LUA->SetField(-2, "syncs");
+
+    LUA->PushNumber(static_cast<double>(s_syncStats.added));
+    LUA->SetField(-2, "added");
+
+    LUA->PushNumber(static_cast<double>(s_syncStats.removed));
+    LUA->SetField(-2, "removed");
+
+    LUA->PushNumber(s_syncStats.syncMs);
+    LUA->SetField(-2, "syncMs");
+
+    LUA->PushNumber(static_cast<double>(s_boundsStats.lastApplied));
+    LUA->SetField(-2, "boundsApplied");
+
+    LUA->PushNumber(static_cast<double>(s_boundsStats.lastSkipped));
+    LUA->SetField(-2, "boundsSkipped");
+
+    LUA->PushNumber(static_cast<double>(s_boundsStats.applied));
+    LUA->SetField(-2, "boundsAppliedTotal");
+
+    LUA->PushNumber(static_cast<double>(s_boundsStats.skipped));
+    LUA->SetField(-2, "boundsSkippedTotal");
+
+    LUA->PushNumber(static_cast<double>(s_boundsStats.calls));
+    LUA->SetField(-2, "boundsCalls");
+
+    return 1;
+}
+
+// Writes the entity indices of rows into the table at outStackPos (see
+// LuaUtil::PushNumberList) and leaves it on the stack
+static void PushEntityIndexList(ILuaBase* LUA, const std::vector<uint32_t>& rows, int outStackPos) {
+    const EntityTable& entities = GetEntityTable();
+    LuaUtil::PushNumberList(LUA, rows.size(), outStackPos, [&](size_t i) { return entities.Indices()[rows[i]]; });
+}
+
+static std::vector<uint32_t> s_queryRows;
+
+LUA_FUNCTION(QueryEntitiesRadius_Native) {
+    float center[3];
+    LuaUtil::CheckVector(LUA, 1, center);
+    float radius = static_cast<float>(LUA->CheckNumber(2));
+
+    GetEntityTable().QueryRadius(center, radius, s_queryRows);
+    PushEntityIndexList(LUA, s_queryRows, 3);
+    LUA->PushNumber(static_cast<double>(s_queryRows.size()));
+    return 2;
+}
+
+LUA_FUNCTION(QueryEntitiesBox_Native) {
+    float mins[3], maxs[3];
+    LuaUtil::CheckVector(LUA, 1, mins);
+    LuaUtil::CheckVector(LUA, 2, maxs);
+
+    GetEntityTable().QueryBox(mins, maxs, s_queryRows);
+    PushEntityIndexList(LUA, s_queryRows, 3);
+    LUA->PushNumber(static_cast<double>(s_queryRows.size()));
+    return 2;
+}
+
+LUA_FUNCTION(QueryEntitiesNearest_Native) {
+    float center[3];
+    LuaUtil::CheckVector(LUA, 1, center);
+    size_t k = static_cast<size_t>(std::max(LUA->CheckNumber(2), 0.0));
+    float maxDistance = LUA->IsType(3, Type::Number) ? static_cast<float>(LUA->GetNumber(3)) : FLT_MAX;
+
+    GetEntityTable().QueryNearest(center, k, s_queryRows, maxDistance);
+    PushEntityIndexList(LUA, s_queryRows, 4);
+    LUA->PushNumber(static_cast<double>(s_queryRows.size()));
+    return 2;
+}
+
+void RegisterEntityRegistryFunctions(ILuaBase* LUA) {
+    LUA->PushCFunction(SyncEntities_Native);
+    LUA->SetField(-2, "SyncEntities");
+
+    LUA->PushCFunction(RemoveEntity_Native);
+    LUA->SetField(-2, "RemoveEntity");
+
+    LUA->PushCFunction(ClearEntities_Native);
+    LUA->SetField(-2, "ClearEntities");
+
+    LUA->PushCFunction(SetEntityBoundsManaged_Native);
+    LUA->SetField(-2, "SetEntityBoundsManaged");
+
+    LUA->PushCFunction(GetEntityRegistryStats_Native);
+    LUA->SetField(-2, "GetEntityRegistryStats");
+
+    LUA->PushCFunction(QueryEntitiesRadius_Native);
+    LUA->SetField(-2, "QueryEntitiesRadius");
+
+    LUA->PushCFunction(QueryEntitiesBox_Native);
+    LUA->SetField(-2, "QueryEntitiesBox");
+
+    LUA->PushCFunction(QueryEntitiesNearest_Native);
+    LUA->SetField(-2, "QueryEntitiesNearest");
+}
+
+} // namespace EntityManager
@@ -0,0 +1,106 @@
+#pragma once
+#include "math/spatial_grid.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace EntityManager {
+    // Native mirror of the client entities Lua syncs once per frame: entity
+    // index, class id and position in contiguous arrays, so distance and
+    // bounds queries never have to call back into Lua per entity. Rows are
+    // dense and unordered (removing one moves the last row into its place);
+    // lookups by entity index go through a sparse index -> row table. A
+    // spatial grid keyed by entity index follows every Set, so queries only
+    // look at nearby cells.
+    class EntityTable {
+    public:
+        static constexpr uint32_t kNoRow = UINT32_MAX;
+
+        // Adds the entity or updates its row; handle is an opaque per-entity
+        // value kept alongside it (the Lua registry reference of the entity)
+        uint32_t Set(int32_t index, uint16_t classId, float x, float y, float z, int handle);
+        // Returns false when the entity is not in the table; handle receives its value
+        bool Remove(int32_t index, int* handle = nullptr);
+        void Clear();
+
+        uint32_t Find(int32_t index) const {
+            return index >= 0 && static_cast<size_t>(index) < m_rowOfIndex.size() ? m_rowOfIndex[index] : kNoRow;
+        }
+
+        size_t Size() const { return m_index.size(); }
+        const int32_t* Indices() const { return m_index.data(); }
+        const uint16_t* ClassIds() const { return m_classId.data(); }
+        const float* X() const { return m_x.data(); }
+        const float* Y() const { return m_y.data(); }
+        const float* Z() const { return m_z.data(); }
+        const int* Handles() const { return m_handle.data(); }
+
+        // Entities not Set between BeginSync and EndSync are removed by
+        // EndSync; their handles are appended to removedHandles
+        void BeginSync();
+        size_t EndSync(std::vector<int>* removedHandles = nullptr);
+
+        // Rows whose position lies within radius of center (inclusive)
+        void QueryRadius(const float center[3], float radius, std::vector<uint32_t>& rows) const;
+        // Rows whose position lies inside the box (inclusive on every face)
+        void QueryBox(const float mins[3], const float maxs[3], std::vector<uint32_t>& rows) const;
+        // Up to k rows no further than maxDistance, closest first
+        void QueryNearest(const float center[3], size_t k, std::vector<uint32_t>& rows,
+                          float maxDistance = FLT_MAX) const;
+
+        // Same results as QueryRadius/QueryBox from a linear scan of every row
+        void ScanRadius(const float center[3], float radius, std::vector<uint32_t>& rows) const;
+        void ScanBox(const float mins[3], const float maxs[3], std::vector<uint32_t>& rows) const;
+
+        // Remembers the render bounds last applied to a row so callers can
+        // skip SetRenderBounds when nothing changed. Returns false when
+        // mins/maxs match what the row has, else records them and returns
+        // true. New rows start with none; moving a row keeps them.
+        bool UpdateRenderBounds(uint32_t row, const float mins[3], const float maxs[3]);
+        // Forgets the bounds of one row, so the next update applies them
+        void InvalidateRenderBounds(uint32_t row);
+
+        // Entities whose render bounds BatchUpdateEntityBounds owns, by
+        // entity index. Kept apart from the rows so Lua can hand an entity
+        // over before its first sync; Remove and Clear drop the flag.
+        // Changing it forgets the row's recorded bounds.
+        void SetBoundsManaged(int32_t index, bool managed);
+        bool IsBoundsManaged(int32_t index) const {
+            return index >= 0 && static_cast<size_t>(index) < m_boundsManaged.size() && m_boundsManaged[index];
+        }
+
+    private:
+        // NaN while unknown, so it never matches
+        struct RenderBounds {
+            float mins[3];
+            float maxs[3];
+        };
+        static const RenderBounds& NoRenderBounds();
+
+        void RemoveRow(uint32_t row);
+        // Turns grid ids (entity indices) into rows in place
+        void IdsToRows(std::vector<uint32_t>& ids) const;
+
+        std::vector<int32_t> m_index;
+        std::vector<uint16_t> m_classId;
+        std::vector<float> m_x, m_y, m_z;
+        std::vector<int> m_handle;
+        std::vector<uint32_t> m_syncStamp;
+        std::vector<RenderBounds> m_bounds;
+
+        std::vector<uint32_t> m_rowOfIndex;
+        std::vector<uint8_t> m_boundsManaged;  // By entity index
+        uint32_t m_stamp = 0;
+
+        RTXMath::SpatialGrid m_grid;
+    };
+
+    // BatchUpdateEntityBounds counters; "last" is the most recent call
+    struct RenderBoundsStats {
+        uint64_t calls = 0;
+        uint64_t applied = 0;
+        uint64_t skipped = 0;
+        size_t lastApplied = 0;
+        size_t lastSkipped = 0;
+    };
+}
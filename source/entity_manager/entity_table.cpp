@@ -0,0 +1,171 @@
+#include "entity_registry.hpp"
+#include "math/point_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace EntityManager {
+
+uint32_t EntityTable::Set(int32_t index, uint16_t classId, float x, float y, float z, int handle) {
+    if (index < 0) return kNoRow;
+    if (static_cast<size_t>(index) >= m_rowOfIndex.size()) {
+        m_rowOfIndex.resize(static_cast<size_t>(index) + 1, kNoRow);
+    }
+
+    m_grid.Update(static_cast<uint32_t>(index), x, y, z);
+
+    uint32_t row = m_rowOfIndex[index];
+    if (row == kNoRow) {
+        row = static_cast<uint32_t>(m_index.size());
+        m_rowOfIndex[index] = row;
+        m_index.push_back(index);
+        m_classId.push_back(classId);
+        m_x.push_back(x);
+        m_y.push_back(y);
+        m_z.push_back(z);
+        m_handle.push_back(handle);
+        m_syncStamp.push_back(m_stamp);
+        m_bounds.push_back(NoRenderBounds());
+        return row;
+    }
+
+    m_classId[row] = classId;
+    m_x[row] = x;
+    m_y[row] = y;
+    m_z[row] = z;
+    m_handle[row] = handle;
+    m_syncStamp[row] = m_stamp;
+    return row;
+}
+
+void EntityTable::RemoveRow(uint32_t row) {
+    const uint32_t last = static_cast<uint32_t>(m_index.size() - 1);
+    m_rowOfIndex[m_index[row]] = kNoRow;
+    m_grid.Remove(static_cast<uint32_t>(m_index[row]));
+
+    if (row != last) {
+        m_index[row] = m_index[last];
+        m_classId[row] = m_classId[last];
+        m_x[row] = m_x[last];
+        m_y[row] = m_y[last];
+        m_z[row] = m_z[last];
+        m_handle[row] = m_handle[last];
+        m_syncStamp[row] = m_syncStamp[last];
+        m_bounds[row] = m_bounds[last];
+        m_rowOfIndex[m_index[row]] = row;
+    }
+
+    m_index.pop_back();
+    m_classId.pop_back();
+    m_x.pop_back();
+    m_y.pop_back();
+    m_z.pop_back();
+    m_handle.pop_back();
+    m_syncStamp.pop_back();
+    m_bounds.pop_back();
+}
+
+bool EntityTable::Remove(int32_t index, int* handle) {
+    if (IsBoundsManaged(index)) m_boundsManaged[index] = 0;
+
+    uint32_t row = Find(index);
+    if (row == kNoRow) return false;
+
+    if (handle) *handle = m_handle[row];
+    RemoveRow(row);
+    return true;
+}
+
+void EntityTable::Clear() {
+    m_index.clear();
+    m_classId.clear();
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_handle.clear();
+    m_syncStamp.clear();
+    m_bounds.clear();
+    m_rowOfIndex.clear();
+    m_boundsManaged.clear();
+    m_grid.Clear();
+}
+
+void EntityTable::BeginSync() {
+    m_stamp++;
+}
+
+size_t EntityTable::EndSync(std::vector<int>* removedHandles) {
+    size_t removed = 0;
+    // Walk backwards so the row moved into a freed slot has already been visited
+    for (size_t row = m_index.size(); row-- > 0;) {
+        if (m_syncStamp[row] == m_stamp) continue;
+        if (removedHandles) removedHandles->push_back(m_handle[row]);
+        RemoveRow(static_cast<uint32_t>(row));
+        removed++;
+    }
+    return removed;
+}
+
+void EntityTable::IdsToRows(std::vector<uint32_t>& ids) const {
+    for (uint32_t& id : ids) {
+        id = m_rowOfIndex[id];
+    }
+}
+
+void EntityTable::QueryRadius(const float center[3], float radius, std::vector<uint32_t>& rows) const {
+    m_grid.QueryRadius(center, radius, rows);
+    IdsToRows(rows);
+}
+
+void EntityTable::QueryBox(const float mins[3], const float maxs[3], std::vector<uint32_t>& rows) const {
+    m_grid.QueryBox(mins, maxs, rows);
+    IdsToRows(rows);
+}
+
+void EntityTable::QueryNearest(const float center[3], size_t k, std::vector<uint32_t>& rows, float maxDistance) const {
+    m_grid.QueryNearest(center, k, rows, maxDistance);
+    IdsToRows(rows);
+}
+
+void EntityTable::ScanRadius(const float center[3], float radius, std::vector<uint32_t>& rows) const {
+    rows.resize(m_index.size());
+    rows.resize(RTXMath::SelectPointsInSphere(m_x.data(), m_y.data(), m_z.data(), m_index.size(),
+                                              center, radius, rows.data()));
+}
+
+void EntityTable::ScanBox(const float mins[3], const float maxs[3], std::vector<uint32_t>& rows) const {
+    rows.resize(m_index.size());
+    rows.resize(RTXMath::SelectPointsInBox(m_x.data(), m_y.data(), m_z.data(), m_index.size(),
+                                           mins, maxs, rows.data()));
+}
+
+const EntityTable::RenderBounds& EntityTable::NoRenderBounds() {
+    static const RenderBounds none = {{NAN, NAN, NAN}, {NAN, NAN, NAN}};
+    return none;
+}
+
+bool EntityTable::UpdateRenderBounds(uint32_t row, const float mins[3], const float maxs[3]) {
+    RenderBounds& bounds = m_bounds[row];
+    if (std::equal(mins, mins + 3, bounds.mins) && std::equal(maxs, maxs + 3, bounds.maxs)) return false;
+
+    std::copy(mins, mins + 3, bounds.mins);
+    std::copy(maxs, maxs + 3, bounds.maxs);
+    return true;
+}
+
+void EntityTable::InvalidateRenderBounds(uint32_t row) {
+    m_bounds[row] = NoRenderBounds();
+}
+
+void EntityTable::SetBoundsManaged(int32_t index, bool managed) {
+    if (index < 0) return;
+    if (static_cast<size_t>(index) >= m_boundsManaged.size()) {
+        if (!managed) return;
+        m_boundsManaged.resize(static_cast<size_t>(index) + 1, 0);
+    }
+    m_boundsManaged[index] = managed ? 1 : 0;
+
+    uint32_t row = Find(index);
+    if (row != kNoRow) InvalidateRenderBounds(row);
+}
+
+} // namespace EntityManager
@@ -0,0 +1,499 @@
+#include "entity_manager.hpp"
+#include "lua_util.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace GarrysMod::Lua;
+
+namespace EntityManager {
+
+int MeshBufferTypeId = 0;
+
+void PushMeshBuffer(ILuaBase* LUA, BatchedMesh&& mesh) {
+    BatchedMesh* buffer = new BatchedMesh(std::move(mesh));
+    LUA->PushUserType(buffer, MeshBufferTypeId);
+}
+
+BatchedMesh BatchedMeshFromVertices(const BSPReader::TriangleVertex* vertices, size_t count,
+                                    const MeshBuilder::IndexBuffer* indices) {
+    BatchedMesh mesh;
+    mesh.vertexCount = static_cast<uint32_t>(count);
+    mesh.positions.reserve(count);
+    mesh.normals.reserve(count);
+    mesh.uvs.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const BSPReader::TriangleVertex& vert = vertices[i];
+        mesh.positions.emplace_back(vert.pos.x, vert.pos.y, vert.pos.z);
+        mesh.normals.emplace_back(vert.normal.x, vert.normal.y, vert.normal.z);
+        mesh.uvs.push_back({vert.u, vert.v});
+    }
+
+    if (indices) {
+        mesh.indices = *indices;
+    }
+
+    return mesh;
+}
+
+bool BatchedMesh::Compact() {
+    if (IsCompact()) return true;
+    if (vertexCount == 0) return false;
+
+    uvs.resize(vertexCount, UV{0.0f, 0.0f});
+
+    // Half-float UVs are only exact enough close to the offset; meshes whose
+    // UVs span more tiles than that keep the float layout
+    float offset[2];
+    if (!RTXMath::ChooseCompactUVOffset(reinterpret_cast<const float*>(uvs.data()), vertexCount, offset)) {
+        return false;
+    }
+    uvOffset[0] = offset[0];
+    uvOffset[1] = offset[1];
+    normals.resize(vertexCount, Vector(0, 0, 1));
+
+    compact.resize(vertexCount);
+    RTXMath::EncodeCompactVertices(reinterpret_cast<const float*>(positions.data()),
+                                   reinterpret_cast<const float*>(normals.data()),
+                                   reinterpret_cast<const float*>(uvs.data()),
+                                   vertexCount, uvOffset, compact.data());
+
+    std::vector<Vector>().swap(positions);
+    std::vector<Vector>().swap(normals);
+    std::vector<UV>().swap(uvs);
+    return true;
+}
+
+size_t BatchedMesh::MemoryBytes() const {
+    return positions.size() * sizeof(Vector) + normals.size() * sizeof(Vector) +
+           uvs.size() * sizeof(UV) + compact.size() * sizeof(RTXMath::CompactVertex) +
+           indices.Size() * indices.IndexSize();
+}
+
+Vector BatchedMesh::GetPosition(size_t i) const {
+    if (IsCompact()) {
+        const float* pos = compact[i].pos;
+        return Vector(pos[0], pos[1], pos[2]);
+    }
+    return positions[i];
+}
+
+Vector BatchedMesh::GetNormal(size_t i) const {
+    if (IsCompact()) {
+        float normal[3];
+        RTXMath::DecodeOctahedral(compact[i].normal, normal);
+        return Vector(normal[0], normal[1], normal[2]);
+    }
+    return i < normals.size() ? normals[i] : Vector(0, 0, 1);
+}
+
+BatchedMesh::UV BatchedMesh::GetUV(size_t i) const {
+    if (IsCompact()) {
+        return {RTXMath::HalfToFloat(compact[i].uv[0]) + uvOffset[0],
+                RTXMath::HalfToFloat(compact[i].uv[1]) + uvOffset[1]};
+    }
+    return i < uvs.size() ? uvs[i] : UV{0.0f, 0.0f};
+}
+
+void BatchedMesh::Weld(const MeshBuilder::WeldOptions& options, MeshBuilder::WeldStats* stats) {
+    if (!indices.Empty() || IsCompact() || vertexCount < 3) return;
+
+    std::vector<BSPReader::TriangleVertex> soup(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        BSPReader::TriangleVertex& vert = soup[i];
+        vert.pos = {positions[i].x, positions[i].y, positions[i].z};
+        vert.normal = i < normals.size() ? BSPReader::Vec3{normals[i].x, normals[i].y, normals[i].z} : BSPReader::Vec3{0, 0, 0};
+        vert.u = i < uvs.size() ? uvs[i].u : 0.0f;
+        vert.v = i < uvs.size() ? uvs[i].v : 0.0f;
+    }
+
+    std::vector<BSPReader::TriangleVertex> unique;
+    MeshBuilder::IndexBuffer welded;
+    MeshBuilder::WeldTriangles(soup.data(), soup.size(), options, unique, welded, stats);
+
+    *this = BatchedMeshFromVertices(unique.data(), unique.size(), &welded);
+}
+
+std::vector<BatchedMesh> BatchedMesh::Split(const MeshBuilder::SplitOptions& options,
+                                            MeshBuilder::SplitStats* stats) const {
+    const bool indexed = !indices.Empty();
+    const size_t triangleCount = DrawVertexCount() / 3;
+
+    std::vector<float> points(static_cast<size_t>(vertexCount) * 3);
+    for (size_t i = 0; i < vertexCount; i++) {
+        Vector pos = GetPosition(i);
+        points[i * 3 + 0] = pos.x;
+        points[i * 3 + 1] = pos.y;
+        points[i * 3 + 2] = pos.z;
+    }
+
+    std::vector<uint32_t> flat;
+    if (indexed) indices.CopyTo(flat);
+
+    std::vector<std::vector<uint32_t>> parts = MeshBuilder::SplitTriangles(
+        points.data(), vertexCount, indexed ? flat.data() : nullptr, triangleCount, options, stats);
+
+    std::vector<BatchedMesh> result;
+    result.reserve(parts.size());
+
+    // Indexed parts get their own compacted vertex range; remap is reset after each
+    std::vector<uint32_t> remap(indexed ? vertexCount : 0, UINT32_MAX);
+
+    for (const std::vector<uint32_t>& part : parts) {
+        BatchedMesh sub;
+        sub.vertexCount = 0;
+        sub.uvOffset[0] = uvOffset[0];
+        sub.uvOffset[1] = uvOffset[1];
+
+        std::vector<uint32_t> used;
+        std::vector<uint32_t> subIndices;
+        if (indexed) subIndices.reserve(part.size() * 3);
+
+        for (uint32_t triangle : part) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t source = indexed ? flat[triangle * 3 + k] : triangle * 3 + k;
+
+                if (indexed) {
+                    if (remap[source] != UINT32_MAX) {
+                        subIndices.push_back(remap[source]);
+                        continue;
+                    }
+                    remap[source] = sub.vertexCount;
+                    subIndices.push_back(sub.vertexCount);
+                    used.push_back(source);
+                }
+
+                // Compact vertices are copied as-is so nothing is re-quantized
+                if (IsCompact()) {
+                    sub.compact.push_back(compact[source]);
+                } else {
+                    sub.positions.push_back(positions[source]);
+                    sub.normals.push_back(GetNormal(source));
+                    sub.uvs.push_back(GetUV(source));
+                }
+                sub.vertexCount++;
+            }
+        }
+
+        if (indexed) {
+            sub.indices.Assign(subIndices, sub.vertexCount);
+            for (uint32_t source : used) remap[source] = UINT32_MAX;
+        }
+
+        result.push_back(std::move(sub));
+    }
+
+    return result;
+}
+
+BatchedMesh* CheckMeshBuffer(ILuaBase* LUA, int stackPos) {
+    LUA->CheckType(stackPos, MeshBufferTypeId);
+    BatchedMesh* buffer = LUA->GetUserType<BatchedMesh>(stackPos, MeshBufferTypeId);
+    if (!buffer) {
+        LUA->ArgError(stackPos, "mesh buffer has already been released");
+    }
+    return buffer;
+}
+
+// Converts a 1-based Lua vertex index into a checked 0-based one
+static size_t CheckVertexIndex(ILuaBase* LUA, const BatchedMesh* buffer, int stackPos) {
+    double index = LUA->CheckNumber(stackPos);
+    if (index < 1 || index > buffer->vertexCount) {
+        LUA->ArgError(stackPos, "vertex index out of range");
+    }
+    return static_cast<size_t>(index) - 1;
+}
+
+LUA_FUNCTION(MeshBuffer_GC) {
+    BatchedMesh* buffer = LUA->GetUserType<BatchedMesh>(1, MeshBufferTypeId);
+    if (buffer) {
+        delete buffer;
+        LUA->SetUserType(1, nullptr);
+    }
+    return 0;
+}
+
+LUA_FUNCTION(MeshBuffer_GetVertexCount) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+    LUA->PushNumber(buffer->vertexCount);
+    return 1;
+}
+
+LUA_FUNCTION(MeshBuffer_GetIndexCount) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+    LUA->PushNumber(static_cast<double>(buffer->indices.Size()));
+    return 1;
+}
+
+LUA_FUNCTION(MeshBuffer_GetTriangleCount) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+    LUA->PushNumber(static_cast<double>(buffer->DrawVertexCount() / 3));
+    return 1;
+}
+
+// Returns whether the buffer is indexed and the index size in bytes
+LUA_FUNCTION(MeshBuffer_IsIndexed) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+    LUA->PushBool(!buffer->indices.Empty());
+    LUA->PushNumber(buffer->indices.Empty() ? 0 : static_cast<double>(buffer->indices.IndexSize()));
+    return 2;
+}
+
+// Welds an unindexed buffer in place; returns the vertex counts before and after
+LUA_FUNCTION(MeshBuffer_Weld) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+
+    MeshBuilder::WeldOptions options;
+    if (LUA->IsType(2, Type::Number)) {
+        options.positionTolerance = static_cast<float>(LUA->GetNumber(2));
+    }
+
+    size_t before = buffer->vertexCount;
+    buffer->Weld(options);
+
+    LUA->PushNumber(static_cast<double>(before));
+    LUA->PushNumber(static_cast<double>(buffer->vertexCount));
+    return 2;
+}
+
+// Switches the buffer to the compact 20-byte vertex layout when its UVs fit
+// the half-float range; returns the memory used before and after in bytes
+LUA_FUNCTION(MeshBuffer_Compact) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+
+    size_t before = buffer->MemoryBytes();
+    buffer->Compact();
+
+    LUA->PushNumber(static_cast<double>(before));
+    LUA->PushNumber(static_cast<double>(buffer->MemoryBytes()));
+    return 2;
+}
+
+LUA_FUNCTION(MeshBuffer_IsCompact) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+    LUA->PushBool(buffer->IsCompact());
+    return 1;
+}
+
+LUA_FUNCTION(MeshBuffer_GetMemoryUsage) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+    LUA->PushNumber(static_cast<double>(buffer->MemoryBytes()));
+    return 1;
+}
+
+LUA_FUNCTION(MeshBuffer_GetPosition) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+    size_t index = CheckVertexIndex(LUA, buffer, 2);
+    LUA->PushVector(buffer->GetPosition(index));
+    return 1;
+}
+
+LUA_FUNCTION(MeshBuffer_GetNormal) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+    size_t index = CheckVertexIndex(LUA, buffer, 2);
+    LUA->PushVector(buffer->GetNormal(index));
+    return 1;
+}
+
+LUA_FUNCTION(MeshBuffer_GetUV) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+    size_t index = CheckVertexIndex(LUA, buffer, 2);
+    BatchedMesh::UV uv = buffer->GetUV(index);
+    LUA->PushNumber(uv.u);
+    LUA->PushNumber(uv.v);
+    return 2;
+}
+
+LUA_FUNCTION(MeshBuffer_GetBounds) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+
+    float mins[3], maxs[3];
+    if (buffer->IsCompact()) {
+        std::fill(mins, mins + 3, FLT_MAX);
+        std::fill(maxs, maxs + 3, -FLT_MAX);
+        for (const RTXMath::CompactVertex& vert : buffer->compact) {
+            for (int k = 0; k < 3; k++) {
+                mins[k] = std::min(mins[k], vert.pos[k]);
+                maxs[k] = std::max(maxs[k], vert.pos[k]);
+            }
+        }
+    } else {
+        RTXMath::ComputeBoundsInterleaved(reinterpret_cast<const float*>(buffer->positions.data()),
+                                          buffer->positions.size(), mins, maxs);
+    }
+
+    LUA->PushVector(Vector(mins[0], mins[1], mins[2]));
+    LUA->PushVector(Vector(maxs[0], maxs[1], maxs[2]));
+    return 2;
+}
+
+// Returns a list of new buffers that each fit maxVertices (and maxIndices,
+// default 3 * maxVertices); the original buffer is left untouched
+LUA_FUNCTION(MeshBuffer_Split) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+
+    MeshBuilder::SplitOptions options;
+    options.maxVertices = static_cast<uint32_t>(LuaUtil::ClampNumber(LUA->CheckNumber(2), 3.0, 65536.0));
+    if (LUA->IsType(3, Type::Number)) {
+        options.maxIndices = static_cast<uint32_t>(LuaUtil::ClampNumber(LUA->GetNumber(3), 0.0, 3.0 * 65536.0));
+    }
+
+    std::vector<BatchedMesh> parts = buffer->Split(options);
+
+    LUA->CreateTable();
+    for (size_t i = 0; i < parts.size(); i++) {
+        LUA->PushNumber(static_cast<double>(i + 1));
+        PushMeshBuffer(LUA, std::move(parts[i]));
+        LUA->SetTable(-3);
+    }
+    return 1;
+}
+
+// Writes vertices straight into the mesh currently opened with mesh.Begin.
+// Must be called between mesh.Begin and mesh.End on the Lua side. The Lua
+// mesh library has no index API, so indexed buffers are expanded here and
+// first/count address the expanded triangle list.
+LUA_FUNCTION(MeshBuffer_FeedMeshBuilder) {
+    BatchedMesh* buffer = CheckMeshBuffer(LUA, 1);
+
+    size_t first = 0;
+    if (LUA->IsType(2, Type::Number)) {
+        first = static_cast<size_t>(std::max(LUA->GetNumber(2), 1.0)) - 1;
+    }
+    const size_t drawCount = buffer->DrawVertexCount();
+    size_t count = drawCount > first ? drawCount - first : 0;
+    if (LUA->IsType(3, Type::Number)) {
+        count = std::min(count, static_cast<size_t>(std::max(LUA->GetNumber(3), 0.0)));
+    }
+
+    // Resolve the mesh library functions once per call
+    LUA->PushSpecial(SPECIAL_GLOB);
+    LUA->GetField(-1, "mesh");
+    if (!LUA->IsType(-1, Type::Table)) {
+        LUA->Pop(2);
+        LUA->ThrowError("[RTX] mesh library is not available");
+        return 0;
+    }
+
+    LUA->GetField(-1, "Position");
+    int positionFn = LUA->ReferenceCreate();
+    LUA->GetField(-1, "Normal");
+    int normalFn = LUA->ReferenceCreate();
+    LUA->GetField(-1, "TexCoord");
+    int texCoordFn = LUA->ReferenceCreate();
+    LUA->GetField(-1, "AdvanceVertex");
+    int advanceFn = LUA->ReferenceCreate();
+    LUA->Pop(2); // Pop mesh and _G
+
+    // mesh.Position/mesh.Normal copy their argument, so a single pair of
+    // scratch Vectors is rewritten in place instead of allocating per vertex
+    LUA->PushVector(Vector(0, 0, 0));
+    Vector* scratchPos = LUA->GetUserType<Vector>(-1, Type::Vector);
+    int scratchPosRef = LUA->ReferenceCreate();
+
+    LUA->PushVector(Vector(0, 0, 1));
+    Vector* scratchNorm = LUA->GetUserType<Vector>(-1, Type::Vector);
+    int scratchNormRef = LUA->ReferenceCreate();
+
+    const bool indexed = !buffer->indices.Empty();
+    const bool hasNormals = buffer->IsCompact() || buffer->normals.size() >= buffer->vertexCount;
+    const bool hasUVs = buffer->IsCompact() || buffer->uvs.size() >= buffer->vertexCount;
+
+    for (size_t n = first; n < first + count; n++) {
+        const size_t i = indexed ? buffer->indices[n] : n;
+
+        *scratchPos = buffer->GetPosition(i);
+        LUA->ReferencePush(positionFn);
+        LUA->ReferencePush(scratchPosRef);
+        LUA->Call(1, 0);
+
+        if (hasNormals) {
+            *scratchNorm = buffer->GetNormal(i);
+            LUA->ReferencePush(normalFn);
+            LUA->ReferencePush(scratchNormRef);
+            LUA->Call(1, 0);
+        }
+
+        if (hasUVs) {
+            LUA->ReferencePush(texCoordFn);
+            BatchedMesh::UV uv = buffer->GetUV(i);
+            LUA->PushNumber(0);
+            LUA->PushNumber(uv.u);
+            LUA->PushNumber(uv.v);
+            LUA->Call(3, 0);
+        }
+
+        LUA->ReferencePush(advanceFn);
+        LUA->Call(0, 0);
+    }
+
+    LUA->ReferenceFree(scratchNormRef);
+    LUA->ReferenceFree(scratchPosRef);
+    LUA->ReferenceFree(advanceFn);
+    LUA->ReferenceFree(texCoordFn);
+    LUA->ReferenceFree(normalFn);
+    LUA->ReferenceFree(positionFn);
+
+    LUA->PushNumber(static_cast<double>(count));
+    return 1;
+}
+
+void RegisterMeshBufferType(ILuaBase* LUA) {
+    MeshBufferTypeId = LUA->CreateMetaTable("RTXMeshBuffer");
+
+    LUA->Push(-1);
+    LUA->SetField(-2, "__index");
+
+    LUA->PushCFunction(MeshBuffer_GC);
+    LUA->SetField(-2, "__gc");
+
+    LUA->PushCFunction(MeshBuffer_GetVertexCount);
+    LUA->SetField(-2, "__len");
+
+    LUA->PushCFunction(MeshBuffer_GetVertexCount);
+    LUA->SetField(-2, "GetVertexCount");
+
+    LUA->PushCFunction(MeshBuffer_GetIndexCount);
+    LUA->SetField(-2, "GetIndexCount");
+
+    LUA->PushCFunction(MeshBuffer_GetTriangleCount);
+    LUA->SetField(-2, "GetTriangleCount");
+
+    LUA->PushCFunction(MeshBuffer_IsIndexed);
+    LUA->SetField(-2, "IsIndexed");
+
+    LUA->PushCFunction(MeshBuffer_Weld);
+    LUA->SetField(-2, "Weld");
+
+    LUA->PushCFunction(MeshBuffer_Split);
+    LUA->SetField(-2, "Split");
+
+    LUA->PushCFunction(MeshBuffer_Compact);
+    LUA->SetField(-2, "Compact");
+
+    LUA->PushCFunction(MeshBuffer_IsCompact);
+    LUA->SetField(-2, "IsCompact");
+
+    LUA->PushCFunction(MeshBuffer_GetMemoryUsage);
+    LUA->SetField(-2, "GetMemoryUsage");
+
+    LUA->PushCFunction(MeshBuffer_GetPosition);
+    LUA->SetField(-2, "GetPosition");
+
+    LUA->PushCFunction(MeshBuffer_GetNormal);
+    LUA->SetField(-2, "GetNormal");
+
+    LUA->PushCFunction(MeshBuffer_GetUV);
+    LUA->SetField(-2, "GetUV");
+
+    LUA->PushCFunction(MeshBuffer_GetBounds);
+    LUA->SetField(-2, "GetBounds");
+
+    LUA->PushCFunction(MeshBuffer_FeedMeshBuilder);
+    LUA->SetField(-2, "FeedMeshBuilder");
+
+    LUA->Pop(); // Pop metatable
+}
+
+} // namespace EntityManager
@@ -0,0 +1,123 @@
+#include "remix_material_cache.hpp"
+#include <cctype>
+
+extern remix::Interface* g_remix;
+
+namespace EntityManager {
+
+uint64_t RemixMaterialCache::HashName(const std::string& name) {
+    size_t end = name.size();
+    if (end > 4 && name.compare(end - 4, 4, ".vmt") == 0) end -= 4;
+
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < end; i++) {
+        char c = name[i] == '\\' ? '/' : static_cast<char>(std::tolower(static_cast<unsigned char>(name[i])));
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+remix::Interface* RemixMaterialCache::Remix() const {
+    return m_remix ? m_remix : g_remix;
+}
+
+remixapi_MaterialHandle RemixMaterialCache::Create(uint64_t key, bool translucent) {
+    remix::Interface* remix = Remix();
+    if (!remix) return nullptr;
+
+    // Only the hash is set, so Remix replacements authored for the
+    // material's draw calls apply to the direct meshes as well
+    remix::MaterialInfo info;
+    info.hash = key;
+
+    remix::MaterialInfoOpaqueEXT opaque;
+    remix::MaterialInfoTranslucentEXT translucentInfo;
+    if (translucent) {
+        info.pNext = &translucentInfo;
+    } else {
+        info.pNext = &opaque;
+    }
+
+    auto result = remix->CreateMaterial(info);
+    if (!result) return nullptr;
+    return result.value();
+}
+
+remixapi_MaterialHandle RemixMaterialCache::Acquire(const std::string& name, bool translucent, uint64_t* outKey) {
+    uint64_t key = HashName(name);
+    if (outKey) *outKey = key;
+
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        m_counters.hits++;
+        it->second.refs++;
+        return it->second.handle;
+    }
+
+    m_counters.misses++;
+    Entry entry;
+    entry.refs = 1;
+    entry.handle = Create(key, translucent);
+    if (entry.handle) {
+        m_counters.created++;
+    } else {
+        // Remembered so every chunk of a rejected material does not retry
+        entry.failed = true;
+        m_counters.failed++;
+    }
+    m_entries.emplace(key, entry);
+    return entry.handle;
+}
+
+void RemixMaterialCache::Release(uint64_t key) {
+    auto it = m_entries.find(key);
+    if (it != m_entries.end() && it->second.refs > 0) {
+        it->second.refs--;
+    }
+}
+
+size_t RemixMaterialCache::DestroyUnused() {
+    remix::Interface* remix = Remix();
+    size_t destroyed = 0;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.refs > 0) {
+            ++it;
+            continue;
+        }
+        if (it->second.handle && remix) {
+            remix->DestroyMaterial(it->second.handle);
+            destroyed++;
+        }
+        it = m_entries.erase(it);
+    }
+    m_counters.destroyed += destroyed;
+    return destroyed;
+}
+
+void RemixMaterialCache::DestroyAll() {
+    remix::Interface* remix = Remix();
+    for (const auto& [key, entry] : m_entries) {
+        if (entry.handle && remix) {
+            remix->DestroyMaterial(entry.handle);
+            m_counters.destroyed++;
+        }
+    }
+    m_entries.clear();
+}
+
+RemixMaterialCache::Stats RemixMaterialCache::GetStats() const {
+    Stats stats = m_counters;
+    for (const auto& [key, entry] : m_entries) {
+        if (!entry.handle) continue;
+        stats.live++;
+        if (entry.refs > 0) stats.referenced++;
+    }
+    return stats;
+}
+
+void RemixMaterialCache::ResetCounters() {
+    m_counters = Stats();
+}
+
+} // namespace EntityManager
@@ -0,0 +1,66 @@
+#pragma once
+#include <remix/remix.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace EntityManager {
+    // One remixapi_MaterialHandle per Source material, keyed by the hash of
+    // its normalized name and shared by every chunk and prop that uses it.
+    // Handles are reference counted; unreferenced ones stay cached until the
+    // next DestroyUnused batch (map change), so rebuilds reuse them.
+    class RemixMaterialCache {
+    public:
+        struct Stats {
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t failed = 0;     // CreateMaterial calls Remix rejected
+            size_t created = 0;
+            size_t destroyed = 0;
+            size_t live = 0;       // Handles currently held by the cache
+            size_t referenced = 0; // Of those, handles with references
+        };
+
+        static RemixMaterialCache& Instance() {
+            static RemixMaterialCache instance;
+            return instance;
+        }
+
+        // remix == nullptr falls back to g_remix at call time
+        explicit RemixMaterialCache(remix::Interface* remix = nullptr) : m_remix(remix) {}
+        ~RemixMaterialCache() { DestroyAll(); }
+        RemixMaterialCache(const RemixMaterialCache&) = delete;
+        RemixMaterialCache& operator=(const RemixMaterialCache&) = delete;
+
+        // Lowercase, forward slashes, no extension; FNV-1a over the result
+        static uint64_t HashName(const std::string& name);
+
+        // Takes a reference to the material's handle, creating it on first
+        // use. Returns nullptr when Remix is unavailable or rejected it; the
+        // reference is taken either way and must be released.
+        remixapi_MaterialHandle Acquire(const std::string& name, bool translucent, uint64_t* outKey = nullptr);
+        void Release(uint64_t key);
+
+        // Destroys every unreferenced handle in one pass; returns the count
+        size_t DestroyUnused();
+        // Destroys everything, referenced or not (shutdown)
+        void DestroyAll();
+
+        Stats GetStats() const;
+        void ResetCounters();
+
+    private:
+        struct Entry {
+            remixapi_MaterialHandle handle = nullptr;
+            uint32_t refs = 0;
+            bool failed = false;
+        };
+
+        remix::Interface* Remix() const;
+        remixapi_MaterialHandle Create(uint64_t key, bool translucent);
+
+        remix::Interface* m_remix;
+        std::unordered_map<uint64_t, Entry> m_entries;
+        Stats m_counters;  // hits, misses, failed, created, destroyed
+    };
+}
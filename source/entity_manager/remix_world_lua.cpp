@@ -0,0 +1,123 @@
+// Lua bindings for the direct Remix world meshes and the shared material
+// cache; the classes themselves stay free of the Garry's Mod headers
+#include "entity_manager.hpp"
+#include "remix_world_meshes.hpp"
+
+using namespace GarrysMod::Lua;
+
+namespace EntityManager {
+
+// DrawRemixChunks([culled])
+// Draws the chunks kept by the last CullChunks call (or every chunk when
+// culled is false) as Remix instances. Returns the number drawn.
+LUA_FUNCTION(DrawRemixChunks_Native) {
+    RemixWorldMeshes& meshes = RemixWorldMeshes::Instance();
+    size_t drawn;
+    if (LUA->IsType(1, Type::Bool) && !LUA->GetBool(1)) {
+        drawn = meshes.DrawAll();
+    } else {
+        const uint32_t* chunks = nullptr;
+        size_t count = GetCulledChunks(chunks);
+        drawn = meshes.DrawChunks(chunks, count);
+    }
+    LUA->PushNumber(static_cast<double>(drawn));
+    return 1;
+}
+
+LUA_FUNCTION(GetRemixWorldStats_Native) {
+    const RemixWorldMeshes::Stats& stats = RemixWorldMeshes::Instance().GetStats();
+    LUA->CreateTable();
+
+    LUA->PushBool(RemixWorldMeshes::Instance().IsAvailable());
+    LUA->SetField(-2, "available");
+
+    LUA->PushNumber(static_cast<double>(stats.meshes));
+    LUA->SetField(-2, "meshes");
+
+    LUA->PushNumber(static_cast<double>(stats.vertices));
+    LUA->SetField(-2, "vertices");
+
+    LUA->PushNumber(static_cast<double>(stats.indices));
+    LUA->SetField(-2, "indices");
+
+    LUA->PushNumber(static_cast<double>(stats.failed));
+    LUA->SetField(-2, "failed");
+
+    LUA->PushNumber(static_cast<double>(stats.instancesLastDraw));
+    LUA->SetField(-2, "instances");
+
+    return 1;
+}
+
+// AcquireRemixMaterial(name[, translucent])
+// Takes a reference to the shared Remix material for a Source material name,
+// for draws other than world chunks (props). Returns whether Remix has a
+// handle for it; every call needs a matching ReleaseRemixMaterial.
+LUA_FUNCTION(AcquireRemixMaterial_Native) {
+    const char* name = LUA->CheckString(1);
+    bool translucent = LUA->GetBool(2);
+    LUA->PushBool(RemixMaterialCache::Instance().Acquire(name, translucent) != nullptr);
+    return 1;
+}
+
+LUA_FUNCTION(ReleaseRemixMaterial_Native) {
+    const char* name = LUA->CheckString(1);
+    RemixMaterialCache::Instance().Release(RemixMaterialCache::HashName(name));
+    return 0;
+}
+
+// Destroys every cached material nothing references; returns the count
+LUA_FUNCTION(FlushRemixMaterials_Native) {
+    LUA->PushNumber(static_cast<double>(RemixMaterialCache::Instance().DestroyUnused()));
+    return 1;
+}
+
+LUA_FUNCTION(GetRemixMaterialStats_Native) {
+    RemixMaterialCache::Stats stats = RemixMaterialCache::Instance().GetStats();
+    LUA->CreateTable();
+
+    LUA->PushNumber(static_cast<double>(stats.hits));
+    LUA->SetField(-2, "hits");
+
+    LUA->PushNumber(static_cast<double>(stats.misses));
+    LUA->SetField(-2, "misses");
+
+    LUA->PushNumber(static_cast<double>(stats.failed));
+    LUA->SetField(-2, "failed");
+
+    LUA->PushNumber(static_cast<double>(stats.created));
+    LUA->SetField(-2, "created");
+
+    LUA->PushNumber(static_cast<double>(stats.destroyed));
+    LUA->SetField(-2, "destroyed");
+
+    LUA->PushNumber(static_cast<double>(stats.live));
+    LUA->SetField(-2, "live");
+
+    LUA->PushNumber(static_cast<double>(stats.referenced));
+    LUA->SetField(-2, "referenced");
+
+    return 1;
+}
+
+void RegisterRemixWorldFunctions(ILuaBase* LUA) {
+    LUA->PushCFunction(DrawRemixChunks_Native);
+    LUA->SetField(-2, "DrawRemixChunks");
+
+    LUA->PushCFunction(GetRemixWorldStats_Native);
+    LUA->SetField(-2, "GetRemixWorldStats");
+
+    LUA->PushCFunction(AcquireRemixMaterial_Native);
+    LUA->SetField(-2, "AcquireRemixMaterial");
+
+    LUA->PushCFunction(ReleaseRemixMaterial_Native);
+    LUA->SetField(-2, "ReleaseRemixMaterial");
+
+    LUA->PushCFunction(FlushRemixMaterials_Native);
+    LUA->SetField(-2, "FlushRemixMaterials");
+
+    LUA->PushCFunction(GetRemixMaterialStats_Native);
+    LUA->SetField(-2, "GetRemixMaterialStats");
+}
+
+} // namespace EntityManager
@@ -0,0 +1,143 @@
+#include "remix_world_meshes.hpp"
+
+extern remix::Interface* g_remix;
+
+namespace EntityManager {
+
+static uint64_t Mix64(uint64_t x) {
+    // splitmix64 finalizer
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+uint64_t ChunkMeshHash(int64_t chunkKey, uint32_t material, uint32_t part) {
+    uint64_t hash = Mix64(static_cast<uint64_t>(chunkKey));
+    return Mix64(hash ^ ((static_cast<uint64_t>(material) << 32) | part));
+}
+
+remix::Interface* RemixWorldMeshes::Remix() const {
+    return m_remix ? m_remix : g_remix;
+}
+
+bool RemixWorldMeshes::CreateChunkMesh(uint32_t chunk, uint64_t hash,
+                                       const BSPReader::TriangleVertex* vertices, size_t vertexCount,
+                                       const MeshBuilder::IndexBuffer& indices,
+                                       const std::string& material, bool translucent) {
+    remix::Interface* remix = Remix();
+    if (!remix || vertexCount == 0) return false;
+
+    uint64_t materialKey = 0;
+    remixapi_MaterialHandle materialHandle = nullptr;
+    if (m_materials) materialHandle = m_materials->Acquire(material, translucent, &materialKey);
+
+    m_vertexScratch.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        const BSPReader::TriangleVertex& in = vertices[i];
+        remixapi_HardcodedVertex& out = m_vertexScratch[i];
+        out = {};
+        out.position[0] = in.pos.x;
+        out.position[1] = in.pos.y;
+        out.position[2] = in.pos.z;
+        out.normal[0] = in.normal.x;
+        out.normal[1] = in.normal.y;
+        out.normal[2] = in.normal.z;
+        out.texcoord[0] = in.u;
+        out.texcoord[1] = in.v;
+        out.color = 0xFFFFFFFF;
+    }
+
+    if (indices.Empty()) {
+        m_indexScratch.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++) m_indexScratch[i] = static_cast<uint32_t>(i);
+    } else {
+        indices.CopyTo(m_indexScratch);
+    }
+
+    remixapi_MeshInfoSurfaceTriangles surface = {};
+    surface.vertices_values = m_vertexScratch.data();
+    surface.vertices_count = vertexCount;
+    surface.indices_values = m_indexScratch.data();
+    surface.indices_count = m_indexScratch.size();
+    surface.skinning_hasvalue = false;
+    surface.material = materialHandle;
+
+    remix::MeshInfo info;
+    info.hash = hash;
+    info.surfaces_values = &surface;
+    info.surfaces_count = 1;
+
+    auto result = remix->CreateMesh(info);
+    if (!result) {
+        if (m_materials) m_materials->Release(materialKey);
+        m_stats.failed++;
+        return false;
+    }
+
+    // Replacing a chunk's mesh releases the old one
+    if (chunk >= m_meshes.size()) {
+        m_meshes.resize(chunk + 1, nullptr);
+        m_materialKeys.resize(chunk + 1, 0);
+    }
+    if (m_meshes[chunk]) {
+        DestroyChunkMesh(chunk);
+        m_stats.meshes--;
+    }
+    m_meshes[chunk] = result.value();
+    m_materialKeys[chunk] = materialKey;
+
+    m_stats.meshes++;
+    m_stats.vertices += vertexCount;
+    m_stats.indices += m_indexScratch.size();
+    return true;
+}
+
+bool RemixWorldMeshes::Draw(remixapi_MeshHandle mesh) {
+    remix::InstanceInfo info;
+    info.mesh = mesh;
+    info.transform.matrix[0][0] = 1.0f;
+    info.transform.matrix[1][1] = 1.0f;
+    info.transform.matrix[2][2] = 1.0f;
+    return static_cast<bool>(Remix()->DrawInstance(info));
+}
+
+size_t RemixWorldMeshes::DrawChunks(const uint32_t* chunks, size_t count) {
+    size_t drawn = 0;
+    if (Remix()) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t chunk = chunks[i];
+            if (HasChunkMesh(chunk) && Draw(m_meshes[chunk])) drawn++;
+        }
+    }
+    m_stats.instancesLastDraw = drawn;
+    return drawn;
+}
+
+size_t RemixWorldMeshes::DrawAll() {
+    size_t drawn = 0;
+    if (Remix()) {
+        for (remixapi_MeshHandle mesh : m_meshes) {
+            if (mesh && Draw(mesh)) drawn++;
+        }
+    }
+    m_stats.instancesLastDraw = drawn;
+    return drawn;
+}
+
+void RemixWorldMeshes::DestroyChunkMesh(uint32_t chunk) {
+    remix::Interface* remix = Remix();
+    if (remix) remix->DestroyMesh(m_meshes[chunk]);
+    if (m_materials) m_materials->Release(m_materialKeys[chunk]);
+    m_meshes[chunk] = nullptr;
+}
+
+void RemixWorldMeshes::Clear() {
+    for (uint32_t chunk = 0; chunk < m_meshes.size(); chunk++) {
+        if (m_meshes[chunk]) DestroyChunkMesh(chunk);
+    }
+    m_meshes.clear();
+    m_materialKeys.clear();
+    m_stats = Stats();
+}
+
+} // namespace EntityManager
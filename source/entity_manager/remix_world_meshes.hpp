@@ -0,0 +1,78 @@
+#pragma once
+#include <remix/remix.h>
+#include "remix_material_cache.hpp"
+#include "bsp_reader/bsp_reader.hpp"
+#include "mesh_builder/vertex_weld.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace EntityManager {
+    // World chunk meshes handed straight to the Remix API: one
+    // remixapi_MeshHandle per registered chunk draw, drawn as instances from
+    // native code every frame instead of going through Source meshes.
+    class RemixWorldMeshes {
+    public:
+        struct Stats {
+            size_t meshes = 0;
+            size_t vertices = 0;
+            size_t indices = 0;
+            size_t failed = 0;             // CreateMesh calls Remix rejected
+            size_t instancesLastDraw = 0;
+        };
+
+        // Uses g_remix and the shared material cache; the instance the Lua
+        // renderer draws through
+        static RemixWorldMeshes& Instance() {
+            static RemixWorldMeshes instance(nullptr, &RemixMaterialCache::Instance());
+            return instance;
+        }
+
+        // remix == nullptr falls back to g_remix at call time. Materials come
+        // from the given cache; without one meshes use Remix's default.
+        explicit RemixWorldMeshes(remix::Interface* remix = nullptr, RemixMaterialCache* materials = nullptr)
+            : m_remix(remix), m_materials(materials) {}
+        ~RemixWorldMeshes() { Clear(); }
+        RemixWorldMeshes(const RemixWorldMeshes&) = delete;
+        RemixWorldMeshes& operator=(const RemixWorldMeshes&) = delete;
+
+        bool IsAvailable() const { return Remix() != nullptr; }
+
+        // Creates the mesh drawn for chunk (the 0-based AddChunkBounds id),
+        // holding a reference to material's cached handle while it lives.
+        // indices may be empty for an unindexed triangle list.
+        bool CreateChunkMesh(uint32_t chunk, uint64_t hash,
+                             const BSPReader::TriangleVertex* vertices, size_t vertexCount,
+                             const MeshBuilder::IndexBuffer& indices,
+                             const std::string& material, bool translucent);
+
+        bool HasChunkMesh(uint32_t chunk) const {
+            return chunk < m_meshes.size() && m_meshes[chunk] != nullptr;
+        }
+
+        // Draws an identity-transformed instance of each listed chunk that has a mesh
+        size_t DrawChunks(const uint32_t* chunks, size_t count);
+        size_t DrawAll();
+
+        // Destroys every mesh and drops its material reference
+        void Clear();
+
+        const Stats& GetStats() const { return m_stats; }
+
+    private:
+        remix::Interface* Remix() const;
+        bool Draw(remixapi_MeshHandle mesh);
+        void DestroyChunkMesh(uint32_t chunk);
+
+        remix::Interface* m_remix;
+        RemixMaterialCache* m_materials;
+        std::vector<remixapi_MeshHandle> m_meshes;  // By chunk id, nullptr = none
+        std::vector<uint64_t> m_materialKeys;       // Cache key each mesh references
+        std::vector<remixapi_HardcodedVertex> m_vertexScratch;
+        std::vector<uint32_t> m_indexScratch;
+        Stats m_stats;
+    };
+
+    // Stable across rebuilds, so Remix captures and replacements keep matching
+    uint64_t ChunkMeshHash(int64_t chunkKey, uint32_t material, uint32_t part);
+}
@@ -0,0 +1,112 @@
+#include "entity_manager.hpp"
+#include "math/box_bvh.hpp"
+#include "lua_util.hpp"
+#include <algorithm>
+#include <chrono>
+
+using namespace GarrysMod::Lua;
+
+namespace EntityManager {
+
+// Static props of the current map, in the order Lua listed them
+static RTXMath::BoxBVH s_staticProps;
+static std::vector<uint32_t> s_staticPropHits;
+
+// BuildStaticPropIndex(positions[, radii]): one Vector per prop, optionally
+// with a bounding radius each; props without one are indexed by origin
+LUA_FUNCTION(BuildStaticPropIndex_Native) {
+    LUA->CheckType(1, Type::Table);
+    const bool hasRadii = LUA->IsType(2, Type::Table);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<float> mins, maxs;
+
+    for (int i = 1;; i++) {
+        LUA->PushNumber(i);
+        LUA->GetTable(1);
+        if (!LUA->IsType(-1, Type::Vector)) {
+            LUA->Pop();
+            break;
+        }
+        Vector pos = *LUA->GetUserType<Vector>(-1, Type::Vector);
+        LUA->Pop();
+
+        float radius = 0.0f;
+        if (hasRadii) {
+            LUA->PushNumber(i);
+            LUA->GetTable(2);
+            if (LUA->IsType(-1, Type::Number)) radius = std::max(static_cast<float>(LUA->GetNumber(-1)), 0.0f);
+            LUA->Pop();
+        }
+
+        mins.insert(mins.end(), {pos.x - radius, pos.y - radius, pos.z - radius});
+        maxs.insert(maxs.end(), {pos.x + radius, pos.y + radius, pos.z + radius});
+    }
+
+    s_staticProps.Build(mins.data(), maxs.data(), mins.size() / 3);
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    Msg("[RTX] Static prop BVH: %zu props, %zu nodes, depth %d, %.2f ms\n",
+        s_staticProps.Size(), s_staticProps.NodeCount(), s_staticProps.Depth(), buildMs);
+
+    LUA->PushNumber(static_cast<double>(s_staticProps.Size()));
+    LUA->PushNumber(buildMs);
+    return 2;
+}
+
+LUA_FUNCTION(ClearStaticPropIndex_Native) {
+    s_staticProps.Clear();
+    return 0;
+}
+
+// QueryStaticPropsRadius(pos, radius[, out]) -> indices, count
+LUA_FUNCTION(QueryStaticPropsRadius_Native) {
+    float center[3];
+    LuaUtil::CheckVector(LUA, 1, center);
+    float radius = static_cast<float>(LUA->CheckNumber(2));
+
+    s_staticProps.QueryRadius(center, radius, s_staticPropHits);
+    LuaUtil::PushNumberList(LUA, s_staticPropHits.size(), 3, [](size_t i) { return s_staticPropHits[i] + 1.0; });
+    LUA->PushNumber(static_cast<double>(s_staticPropHits.size()));
+    return 2;
+}
+
+// QueryStaticPropsFrustum(origin, angles, fov, aspect, maxDistance[, padding[, out]]) -> indices, count
+LUA_FUNCTION(QueryStaticPropsFrustum_Native) {
+    float origin[3];
+    LuaUtil::CheckVector(LUA, 1, origin);
+    LUA->CheckType(2, Type::Angle);
+    const QAngle* angles = LUA->GetUserType<QAngle>(2, Type::Angle);
+    float fov = static_cast<float>(LUA->CheckNumber(3));
+    float aspect = static_cast<float>(LUA->CheckNumber(4));
+    float maxDistance = static_cast<float>(LUA->CheckNumber(5));
+    float padding = LUA->IsType(6, Type::Number) ? static_cast<float>(LUA->GetNumber(6)) : 0.0f;
+
+    Vector forward, right, up;
+    AngleVectorsRadians(*angles, &forward, &right, &up);
+    const float f[3] = {forward.x, forward.y, forward.z};
+    const float r[3] = {right.x, right.y, right.z};
+    const float u[3] = {up.x, up.y, up.z};
+
+    RTXMath::ViewFrustum frustum = RTXMath::BuildViewFrustum(origin, f, r, u, fov, aspect, 0.0f, maxDistance);
+    s_staticProps.QueryFrustum(frustum, s_staticPropHits, padding);
+    LuaUtil::PushNumberList(LUA, s_staticPropHits.size(), 7, [](size_t i) { return s_staticPropHits[i] + 1.0; });
+    LUA->PushNumber(static_cast<double>(s_staticPropHits.size()));
+    return 2;
+}
+
+void RegisterStaticPropFunctions(ILuaBase* LUA) {
+    LUA->PushCFunction(BuildStaticPropIndex_Native);
+    LUA->SetField(-2, "BuildStaticPropIndex");
+
+    LUA->PushCFunction(ClearStaticPropIndex_Native);
+    LUA->SetField(-2, "ClearStaticPropIndex");
+
+    LUA->PushCFunction(QueryStaticPropsRadius_Native);
+    LUA->SetField(-2, "QueryStaticPropsRadius");
+
+    LUA->PushCFunction(QueryStaticPropsFrustum_Native);
+    LUA->SetField(-2, "QueryStaticPropsFrustum");
+}
+
+} // namespace EntityManager
@@ -0,0 +1,392 @@
+#include "entity_manager.hpp"
+#include "remix_world_meshes.hpp"
+#include "math/frustum_culling.hpp"
+#include "math/radix_sort.hpp"
+#include "bsp_reader/visibility.hpp"
+#include "lua_util.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+using namespace GarrysMod::Lua;
+
+namespace EntityManager {
+
+// Bounds of every world mesh the Lua renderer registered, in registration order
+static RTXMath::CullBoxSet s_chunkBounds;
+static std::vector<uint32_t> s_visibleChunks;
+static size_t s_visibleCount = 0;
+
+// Render state of each chunk, used to order the visible list
+static std::vector<uint32_t> s_chunkMaterials;
+static std::vector<uint8_t> s_chunkTranslucent;
+// Simplified LOD meshes each chunk has besides its full one
+static std::vector<uint8_t> s_chunkLods;
+
+static std::vector<uint64_t> s_sortKeys, s_sortKeyScratch;
+static std::vector<uint32_t> s_sortValueScratch;
+
+struct DrawListStats {
+    size_t visible = 0;
+    size_t translucent = 0;
+    size_t switches = 0;          // (translucency, material) changes in the sorted list
+    size_t unsortedSwitches = 0;  // Changes the unsorted list would have made
+};
+static DrawListStats s_drawListStats;
+
+// PVS of the loaded map, read on first use after the bounds were cleared
+static BSPReader::Visibility s_visibility;
+static bool s_visibilityTried = false;
+
+// Clusters each chunk overlaps (flattened, with a start offset per chunk),
+// filled in lazily for chunks added since the last cull
+static std::vector<uint32_t> s_chunkClusterStart = {0};
+static std::vector<int> s_chunkClusters;
+
+// Per-chunk PVS verdict for s_pvsCluster, recomputed when the camera changes cluster
+static std::vector<uint8_t> s_chunkInPVS;
+static int s_pvsCluster = INT_MIN;
+
+static bool EnsureVisibility() {
+    if (!s_visibilityTried) {
+        s_visibilityTried = true;
+
+        std::string error;
+        if (!GetWorldMap().IsOpen()) {
+            Msg("[RTX] PVS culling unavailable: no native map loaded\n");
+        } else if (!s_visibility.Load(GetWorldMap(), error)) {
+            Msg("[RTX] PVS culling unavailable: %s\n", error.c_str());
+        } else {
+            Msg("[RTX] Loaded PVS: %d clusters, %zu leaves\n", s_visibility.ClusterCount(), s_visibility.LeafCount());
+        }
+    }
+    return s_visibility.IsLoaded();
+}
+
+static void GetChunkBox(size_t chunk, BSPReader::Vec3& mins, BSPReader::Vec3& maxs) {
+    const float cx = s_chunkBounds.CenterX()[chunk], ex = s_chunkBounds.ExtentX()[chunk];
+    const float cy = s_chunkBounds.CenterY()[chunk], ey = s_chunkBounds.ExtentY()[chunk];
+    const float cz = s_chunkBounds.CenterZ()[chunk], ez = s_chunkBounds.ExtentZ()[chunk];
+    mins = {cx - ex, cy - ey, cz - ez};
+    maxs = {cx + ex, cy + ey, cz + ez};
+}
+
+static void UpdateChunkClusters() {
+    std::vector<int> clusters;
+    for (size_t chunk = s_chunkClusterStart.size() - 1; chunk < s_chunkBounds.Size(); chunk++) {
+        BSPReader::Vec3 mins, maxs;
+        GetChunkBox(chunk, mins, maxs);
+        s_visibility.GetClustersInBox(mins, maxs, clusters);
+
+        s_chunkClusters.insert(s_chunkClusters.end(), clusters.begin(), clusters.end());
+        s_chunkClusterStart.push_back(static_cast<uint32_t>(s_chunkClusters.size()));
+        s_pvsCluster = INT_MIN;
+    }
+}
+
+static bool IsChunkInPVS(size_t chunk, int cameraCluster) {
+    uint32_t begin = s_chunkClusterStart[chunk], end = s_chunkClusterStart[chunk + 1];
+    return s_visibility.IsVisibleFrom(cameraCluster, s_chunkClusters.data() + begin, end - begin);
+}
+
+// Returns the camera cluster, or -1 when the camera is in solid or outside
+// the map and everything has to be considered visible
+static int UpdateChunkPVS(const float origin[3]) {
+    UpdateChunkClusters();
+
+    int leaf = s_visibility.FindLeaf({origin[0], origin[1], origin[2]});
+    int cluster = s_visibility.LeafCluster(leaf);
+    if (cluster == s_pvsCluster) return cluster;
+
+    s_pvsCluster = cluster;
+    s_chunkInPVS.assign(s_chunkBounds.Size(), 1);
+    if (cluster >= 0) {
+        for (size_t chunk = 0; chunk < s_chunkBounds.Size(); chunk++) {
+            s_chunkInPVS[chunk] = IsChunkInPVS(chunk, cluster) ? 1 : 0;
+        }
+    }
+    return cluster;
+}
+
+// Material ids are kept to 20 bits in the sort key
+static const uint32_t kMaterialMask = 0xFFFFF;
+
+// Opaque draws sort by material, then front to back inside a material.
+// Translucent draws sort after every opaque one, back to front, with the
+// material only breaking ties between equally distant draws.
+static uint64_t MakeDrawSortKey(uint32_t material, bool translucent, float distanceSqr) {
+    uint64_t distance = RTXMath::FloatToSortableBits(distanceSqr);
+    if (translucent) {
+        return (1ull << 63) | ((~distance & 0xFFFFFFFFull) << 20) | (material & kMaterialMask);
+    }
+    return (static_cast<uint64_t>(material & kMaterialMask) << 32) | distance;
+}
+
+static size_t CountStateSwitches(const uint32_t* chunks, size_t count) {
+    size_t switches = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t chunk = chunks[i];
+        if (i == 0 || s_chunkMaterials[chunk] != s_chunkMaterials[chunks[i - 1]] ||
+            s_chunkTranslucent[chunk] != s_chunkTranslucent[chunks[i - 1]]) {
+            switches++;
+        }
+    }
+    return switches;
+}
+
+// Radix sorts the visible chunks by state and camera distance; returns the
+// position of the first translucent chunk (count when there is none)
+static size_t SortDrawList(uint32_t* chunks, size_t count, const float origin[3]) {
+    s_drawListStats = DrawListStats();
+    s_drawListStats.visible = count;
+    s_drawListStats.unsortedSwitches = CountStateSwitches(chunks, count);
+
+    s_sortKeys.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t chunk = chunks[i];
+        float dx = s_chunkBounds.CenterX()[chunk] - origin[0];
+        float dy = s_chunkBounds.CenterY()[chunk] - origin[1];
+        float dz = s_chunkBounds.CenterZ()[chunk] - origin[2];
+        s_sortKeys[i] = MakeDrawSortKey(s_chunkMaterials[chunk], s_chunkTranslucent[chunk] != 0,
+                                        dx * dx + dy * dy + dz * dz);
+        s_drawListStats.translucent += s_chunkTranslucent[chunk];
+    }
+
+    RTXMath::RadixSort64(s_sortKeys.data(), chunks, count, s_sortKeyScratch, s_sortValueScratch);
+
+    s_drawListStats.switches = CountStateSwitches(chunks, count);
+    return count - s_drawListStats.translucent;
+}
+
+// Picks the LOD of a chunk from the share of the view width its bounding
+// sphere covers: full detail at or above threshold, then one level coarser
+// each time the projected size halves
+static uint32_t SelectChunkLod(size_t chunk, const float origin[3], float tanHalfFov, float threshold) {
+    uint32_t lodCount = s_chunkLods[chunk];
+    if (lodCount == 0 || threshold <= 0.0f) return 0;
+
+    const float ex = s_chunkBounds.ExtentX()[chunk];
+    const float ey = s_chunkBounds.ExtentY()[chunk];
+    const float ez = s_chunkBounds.ExtentZ()[chunk];
+    const float dx = std::max(std::fabs(s_chunkBounds.CenterX()[chunk] - origin[0]) - ex, 0.0f);
+    const float dy = std::max(std::fabs(s_chunkBounds.CenterY()[chunk] - origin[1]) - ey, 0.0f);
+    const float dz = std::max(std::fabs(s_chunkBounds.CenterZ()[chunk] - origin[2]) - ez, 0.0f);
+
+    const float distance = std::sqrt(dx * dx + dy * dy + dz * dz) * tanHalfFov;
+    const float radius = std::sqrt(ex * ex + ey * ey + ez * ez);
+    uint32_t level = 0;
+    for (float size = threshold * distance; level < lodCount && radius < size; size *= 0.5f) {
+        level++;
+    }
+    return level;
+}
+
+uint32_t RegisterChunkDraw(const float mins[3], const float maxs[3], uint32_t material, bool translucent,
+                           uint32_t lodCount) {
+    uint32_t index = s_chunkBounds.Add(mins, maxs);
+    s_chunkMaterials.push_back(material);
+    s_chunkTranslucent.push_back(translucent ? 1 : 0);
+    s_chunkLods.push_back(static_cast<uint8_t>(std::min<uint32_t>(lodCount, UINT8_MAX)));
+    return index;
+}
+
+size_t GetCulledChunks(const uint32_t*& chunks) {
+    chunks = s_visibleChunks.data();
+    return s_visibleCount;
+}
+
+// AddChunkBounds(mins, maxs[, materialId, translucent, lodCount])
+// Registers a draw's bounds and render state and returns its 1-based id.
+// materialId is any small integer the caller uses to tell materials apart;
+// lodCount is how many simplified meshes the caller holds for the draw.
+LUA_FUNCTION(AddChunkBounds_Native) {
+    float mins[3], maxs[3];
+    LuaUtil::CheckVector(LUA, 1, mins);
+    LuaUtil::CheckVector(LUA, 2, maxs);
+    uint32_t material = LUA->IsType(3, Type::Number) ? static_cast<uint32_t>(LUA->GetNumber(3)) : 0;
+    bool translucent = LUA->GetBool(4);
+    uint32_t lodCount = LUA->IsType(5, Type::Number) ? static_cast<uint32_t>(LUA->GetNumber(5)) : 0;
+
+    uint32_t index = RegisterChunkDraw(mins, maxs, material, translucent, lodCount);
+    LUA->PushNumber(static_cast<double>(index) + 1);
+    return 1;
+}
+
+LUA_FUNCTION(ClearChunkBounds_Native) {
+    s_chunkBounds.Clear();
+    s_visibleChunks.clear();
+    s_visibleCount = 0;
+    s_chunkMaterials.clear();
+    s_chunkTranslucent.clear();
+    s_chunkLods.clear();
+    s_drawListStats = DrawListStats();
+
+    // Bounds are cleared on every rebuild, which is also when the map may have changed
+    s_visibility.Clear();
+    s_visibilityTried = false;
+    s_chunkClusterStart.assign(1, 0);
+    s_chunkClusters.clear();
+    s_chunkInPVS.clear();
+    s_pvsCluster = INT_MIN;
+
+    // Remix meshes are keyed by the ids that were just invalidated
+    RemixWorldMeshes::Instance().Clear();
+    return 0;
+}
+
+// CullChunks(origin, angles, fov, aspect, maxDistance, out[, usePVS, lodOut, lodThreshold])
+// Writes the ids of draws inside the view frustum and within maxDistance
+// (0 = unlimited) to out[1..count] and returns count. The list is ordered
+// for drawing: opaque draws grouped by material and front to back, then
+// translucent draws back to front. The third return value is the position
+// of the first translucent draw (count + 1 when there is none).
+// With usePVS, draws outside the potentially visible set of the camera's
+// cluster are dropped too. The camera cluster is the second return value
+// (-1 when the camera is in solid, the map has no vis data or usePVS is off).
+// With lodOut, lodOut[i] is the LOD to draw out[i] at: 0 for full detail, or
+// 1..lodCount once the draw's projected size (bounding radius over the view
+// half-width at its distance) falls below lodThreshold (default 0.25), one
+// level per halving.
+// out is reused across frames, so entries past count are stale.
+LUA_FUNCTION(CullChunks_Native) {
+    float origin[3];
+    LuaUtil::CheckVector(LUA, 1, origin);
+    LUA->CheckType(2, Type::Angle);
+    const QAngle* angles = LUA->GetUserType<QAngle>(2, Type::Angle);
+    float fov = static_cast<float>(LUA->CheckNumber(3));
+    float aspect = static_cast<float>(LUA->CheckNumber(4));
+    float maxDistance = static_cast<float>(LUA->CheckNumber(5));
+    LUA->CheckType(6, Type::Table);
+
+    Vector forward, right, up;
+    AngleVectorsRadians(*angles, &forward, &right, &up);
+    const float f[3] = {forward.x, forward.y, forward.z};
+    const float r[3] = {right.x, right.y, right.z};
+    const float u[3] = {up.x, up.y, up.z};
+
+    RTXMath::ViewFrustum frustum = RTXMath::BuildViewFrustum(origin, f, r, u, fov, aspect, 0.0f, maxDistance);
+
+    s_visibleChunks.resize(s_chunkBounds.Size());
+    size_t count = RTXMath::CullBoxes(s_chunkBounds, frustum, s_visibleChunks.data());
+
+    int cameraCluster = -1;
+    if (LUA->GetBool(7) && EnsureVisibility()) {
+        cameraCluster = UpdateChunkPVS(origin);
+        if (cameraCluster >= 0) {
+            size_t kept = 0;
+            for (size_t i = 0; i < count; i++) {
+                uint32_t chunk = s_visibleChunks[i];
+                s_visibleChunks[kept] = chunk;
+                kept += s_chunkInPVS[chunk];
+            }
+            count = kept;
+        }
+    }
+
+    size_t firstTranslucent = SortDrawList(s_visibleChunks.data(), count, origin);
+    s_visibleCount = count;
+
+    for (size_t i = 0; i < count; i++) {
+        LUA->PushNumber(static_cast<double>(i + 1));
+        LUA->PushNumber(static_cast<double>(s_visibleChunks[i]) + 1);
+        LUA->SetTable(6);
+    }
+
+    if (LUA->IsType(8, Type::Table)) {
+        const float threshold = LUA->IsType(9, Type::Number) ? static_cast<float>(LUA->GetNumber(9)) : 0.25f;
+        const float tanHalfFov = std::tan(std::min(std::max(fov, 1.0f), 179.0f) * 0.5f * 0.017453292519943295f);
+        for (size_t i = 0; i < count; i++) {
+            LUA->PushNumber(static_cast<double>(i + 1));
+            LUA->PushNumber(SelectChunkLod(s_visibleChunks[i], origin, tanHalfFov, threshold));
+            LUA->SetTable(8);
+        }
+    }
+
+    LUA->PushNumber(static_cast<double>(count));
+    LUA->PushNumber(cameraCluster);
+    LUA->PushNumber(static_cast<double>(firstTranslucent) + 1);
+    return 3;
+}
+
+// Stats of the draw list built by the last CullChunks call
+LUA_FUNCTION(GetChunkDrawStats_Native) {
+    const DrawListStats& stats = s_drawListStats;
+    LUA->CreateTable();
+
+    LUA->PushNumber(static_cast<double>(stats.visible));
+    LUA->SetField(-2, "visible");
+
+    LUA->PushNumber(static_cast<double>(stats.translucent));
+    LUA->SetField(-2, "translucent");
+
+    LUA->PushNumber(static_cast<double>(stats.switches));
+    LUA->SetField(-2, "switches");
+
+    LUA->PushNumber(static_cast<double>(stats.unsortedSwitches));
+    LUA->SetField(-2, "unsortedSwitches");
+
+    LUA->PushNumber(static_cast<double>(stats.unsortedSwitches - std::min(stats.switches, stats.unsortedSwitches)));
+    LUA->SetField(-2, "switchesSaved");
+
+    return 1;
+}
+
+// Checks the per-chunk PVS verdicts against a brute-force pass over the
+// leaf lump, see BSPReader::CheckBoxPVS. Samples up to maxClusters camera
+// clusters.
+LUA_FUNCTION(ValidateChunkPVS_Native) {
+    int maxClusters = LUA->IsType(1, Type::Number) ? static_cast<int>(LUA->GetNumber(1)) : 256;
+
+    if (!EnsureVisibility() || s_chunkBounds.Size() == 0) {
+        Msg("[RTX] PVS validation needs a vised map and registered chunk bounds\n");
+        LUA->PushBool(false);
+        return 1;
+    }
+    UpdateChunkClusters();
+
+    const size_t chunkCount = s_chunkBounds.Size();
+    std::vector<BSPReader::Vec3> mins(chunkCount), maxs(chunkCount);
+    for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+        GetChunkBox(chunk, mins[chunk], maxs[chunk]);
+    }
+
+    const BSPReader::PVSCheck check = BSPReader::CheckBoxPVS(s_visibility, mins.data(), maxs.data(), chunkCount,
+                                                             s_chunkClusterStart.data(), s_chunkClusters.data(),
+                                                             maxClusters);
+
+    bool passed = check.Passed();
+    Msg("[RTX] PVS validation %s: %zu chunk/cluster pairs, %zu match the leaf data, %zu tighter, %zu looser, "
+        "%zu walked clusters without an overlapping leaf\n",
+        passed ? "passed" : "FAILED", check.compared, check.matching, check.tighter, check.looser,
+        check.missingFromLeaves);
+
+    LUA->PushBool(passed);
+    return 1;
+}
+
+LUA_FUNCTION(GetChunkBoundsCount_Native) {
+    LUA->PushNumber(static_cast<double>(s_chunkBounds.Size()));
+    return 1;
+}
+
+void RegisterWorldCullingFunctions(ILuaBase* LUA) {
+    LUA->PushCFunction(AddChunkBounds_Native);
+    LUA->SetField(-2, "AddChunkBounds");
+
+    LUA->PushCFunction(ClearChunkBounds_Native);
+    LUA->SetField(-2, "ClearChunkBounds");
+
+    LUA->PushCFunction(CullChunks_Native);
+    LUA->SetField(-2, "CullChunks");
+
+    LUA->PushCFunction(GetChunkDrawStats_Native);
+    LUA->SetField(-2, "GetChunkDrawStats");
+
+    LUA->PushCFunction(ValidateChunkPVS_Native);
+    LUA->SetField(-2, "ValidateChunkPVS");
+
+    LUA->PushCFunction(GetChunkBoundsCount_Native);
+    LUA->SetField(-2, "GetChunkBoundsCount");
+}
+
+} // namespace EntityManager
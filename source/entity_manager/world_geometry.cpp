@@ -0,0 +1,966 @@
+#include "entity_manager.hpp"
+#include "remix_world_meshes.hpp"
+#include "mesh_builder/chunk_builder.hpp"
+#include "mesh_builder/displacement_builder.hpp"
+#include "mesh_builder/face_merge.hpp"
+#include "mesh_builder/mesh_cache.hpp"
+#include "mesh_builder/mesh_simplifier.hpp"
+#include "mesh_builder/region_classifier.hpp"
+#include "lua_util.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+using namespace GarrysMod::Lua;
+
+namespace EntityManager {
+
+static BSPReader::Map s_worldMap;
+static BSPReader::WorldGeometry s_worldGeometry;
+static std::string s_worldMapName;
+// Prefix that made the map path resolve, reused for files written next to it
+static std::string s_worldRoot = "garrysmod/";
+static MeshBuilder::DisplacementStats s_displacementStats;
+// Merge coplanar brush faces while decoding; set per load from Lua
+static bool s_mergeFaces = false;
+static MeshBuilder::FaceMergeStats s_faceMergeStats;
+static uint32_t s_worldMapCRC = 0;
+static bool s_worldMapCRCValid = false;
+
+BSPReader::Map& GetWorldMap() {
+    return s_worldMap;
+}
+
+const BSPReader::WorldGeometry& GetWorldGeometry() {
+    return s_worldGeometry;
+}
+
+// Materials cached for the previous map's direct Remix meshes are released
+// together once nothing references them any more
+static void ReleaseRemixMaterials() {
+    size_t destroyed = RemixMaterialCache::Instance().DestroyUnused();
+    if (destroyed > 0) Msg("[RTX] Released %zu cached Remix materials\n", destroyed);
+}
+
+static void CancelChunkBuildJob();
+
+void UnloadWorldGeometry() {
+    CancelChunkBuildJob();
+    ReleaseRemixMaterials();
+    s_worldGeometry.Clear();
+    s_worldMap.Close();
+    s_worldMapName.clear();
+    s_worldMapCRCValid = false;
+}
+
+// Computed on first use; only the chunk mesh cache needs it
+static uint32_t GetWorldMapCRC() {
+    if (!s_worldMapCRCValid) {
+        s_worldMapCRC = MeshBuilder::Crc32(s_worldMap.Data(), s_worldMap.Size());
+        s_worldMapCRCValid = true;
+    }
+    return s_worldMapCRC;
+}
+
+static bool DecodeWorldGeometry(std::string& error) {
+    BSPReader::DecodeOptions options;
+    if (!s_worldMap.DecodeWorld(s_worldGeometry, options)) {
+        error = "map is missing face lumps or uses compressed lumps";
+        UnloadWorldGeometry();
+        return false;
+    }
+
+    // Before displacements are appended: only brush face fans can merge
+    s_faceMergeStats = MeshBuilder::FaceMergeStats();
+    if (s_mergeFaces) {
+        MeshBuilder::MergeCoplanarFaces(s_worldGeometry, MeshBuilder::FaceMergeOptions(),
+                                        &MeshBuilder::WorkerPool::Instance(), &s_faceMergeStats);
+    }
+
+    // Displacements land in the same material streams as brush faces
+    MeshBuilder::BuildDisplacements(s_worldMap, options, s_worldGeometry,
+                                    &MeshBuilder::WorkerPool::Instance(), &s_displacementStats);
+    return true;
+}
+
+bool LoadWorldGeometry(const std::string& path, std::string& error) {
+    CancelChunkBuildJob();
+    ReleaseRemixMaterials();
+    s_worldGeometry.Clear();
+
+    // Lua hands us a path relative to the game directory
+    if (s_worldMap.Open(path, error)) {
+        s_worldRoot.clear();
+    } else if (s_worldMap.Open("garrysmod/" + path, error)) {
+        s_worldRoot = "garrysmod/";
+    } else {
+        return false;
+    }
+
+    s_worldMapName = path;
+    return DecodeWorldGeometry(error);
+}
+
+bool LoadWorldGeometryFromMemory(std::vector<uint8_t>&& data, std::string& error) {
+    CancelChunkBuildJob();
+    ReleaseRemixMaterials();
+    s_worldGeometry.Clear();
+
+    if (!s_worldMap.OpenFromMemory(std::move(data), error)) {
+        return false;
+    }
+
+    s_worldMapName = "<memory>";
+    return DecodeWorldGeometry(error);
+}
+
+static void PushWorldLoadResult(ILuaBase* LUA, bool success, const std::string& error) {
+    if (success) {
+        Msg("[RTX] Native BSP loaded: %zu faces, %zu triangles, %zu materials (%zu faces skipped)\n",
+            s_worldGeometry.faceCount, s_worldGeometry.triangleCount,
+            s_worldGeometry.materials.size(), s_worldGeometry.skippedFaces);
+        if (s_faceMergeStats.merges > 0) {
+            Msg("[RTX] Merged coplanar faces: %zu -> %zu faces, %zu -> %zu triangles (-%.1f%%) in %.1f ms\n",
+                s_faceMergeStats.facesBefore, s_faceMergeStats.facesAfter,
+                s_faceMergeStats.trianglesBefore, s_faceMergeStats.trianglesAfter,
+                100.0 * (s_faceMergeStats.trianglesBefore - s_faceMergeStats.trianglesAfter) /
+                    s_faceMergeStats.trianglesBefore,
+                s_faceMergeStats.milliseconds);
+        }
+        if (s_displacementStats.displacements > 0) {
+            Msg("[RTX] Tessellated %zu displacements into %zu triangles in %.1f ms (%zu edge vertices stitched, %zu skipped)\n",
+                s_displacementStats.displacements, s_displacementStats.triangles, s_displacementStats.milliseconds,
+                s_displacementStats.stitchedVertices, s_displacementStats.skipped);
+        }
+        LUA->PushBool(true);
+        LUA->PushNil();
+    } else {
+        LUA->PushBool(false);
+        LUA->PushString(error.c_str());
+    }
+}
+
+// Optional load options at stackPos: { mergeFaces = bool }
+static void ReadLoadOptions(ILuaBase* LUA, int stackPos) {
+    s_mergeFaces = false;
+    if (LUA->IsType(stackPos, Type::Table)) {
+        LUA->GetField(stackPos, "mergeFaces");
+        s_mergeFaces = LUA->GetBool(-1);
+        LUA->Pop();
+    }
+}
+
+LUA_FUNCTION(LoadMapBSP_Native) {
+    const char* path = LUA->CheckString(1);
+    ReadLoadOptions(LUA, 2);
+
+    std::string error;
+    bool success = LoadWorldGeometry(path, error);
+    PushWorldLoadResult(LUA, success, error);
+    return 2;
+}
+
+// Fallback for maps mounted from .gma archives, which cannot be mapped
+// directly: Lua reads the file with file.Read and passes the raw bytes
+LUA_FUNCTION(LoadMapBSPFromString_Native) {
+    LUA->CheckType(1, Type::String);
+
+    unsigned int length = 0;
+    const char* data = LUA->GetString(1, &length);
+
+    std::vector<uint8_t> buffer(length);
+    std::memcpy(buffer.data(), data, length);
+    ReadLoadOptions(LUA, 2);
+
+    std::string error;
+    bool success = LoadWorldGeometryFromMemory(std::move(buffer), error);
+    PushWorldLoadResult(LUA, success, error);
+    return 2;
+}
+
+LUA_FUNCTION(UnloadMapBSP_Native) {
+    UnloadWorldGeometry();
+    return 0;
+}
+
+LUA_FUNCTION(IsMapBSPLoaded_Native) {
+    LUA->PushBool(s_worldMap.IsOpen());
+    LUA->PushNumber(static_cast<double>(s_worldGeometry.faceCount));
+    return 2;
+}
+
+// Returns one entry per material with its triangle stream as a mesh buffer
+LUA_FUNCTION(GetWorldMaterialStreams_Native) {
+    LUA->CreateTable();
+
+    for (size_t i = 0; i < s_worldGeometry.materials.size(); i++) {
+        const BSPReader::MaterialStream& stream = s_worldGeometry.materials[i];
+
+        LUA->PushNumber(i + 1);
+        LUA->CreateTable();
+
+        LUA->PushString(stream.material.c_str());
+        LUA->SetField(-2, "material");
+
+        LUA->PushNumber(static_cast<double>(stream.faces.size()));
+        LUA->SetField(-2, "faces");
+
+        LUA->PushNumber(static_cast<double>(stream.vertices.size() / 3));
+        LUA->SetField(-2, "triangles");
+
+        LUA->PushNumber(stream.surfaceFlags);
+        LUA->SetField(-2, "surfaceFlags");
+
+        PushMeshBuffer(LUA, BatchedMeshFromVertices(stream.vertices.data(), stream.vertices.size()));
+        LUA->SetField(-2, "buffer");
+
+        LUA->SetTable(-3);
+    }
+
+    return 1;
+}
+
+// Reads an optional Vector field from the options table at stackPos
+static bool GetVectorOption(ILuaBase* LUA, int stackPos, const char* name, MeshBuilder::Vec3& out) {
+    LUA->GetField(stackPos, name);
+    bool found = LUA->IsType(-1, Type::Vector);
+    if (found) {
+        Vector* v = LUA->GetUserType<Vector>(-1, Type::Vector);
+        out = {v->x, v->y, v->z};
+    }
+    LUA->Pop();
+    return found;
+}
+
+static double GetNumberOption(ILuaBase* LUA, int stackPos, const char* name, double fallback) {
+    LUA->GetField(stackPos, name);
+    double value = LUA->IsType(-1, Type::Number) ? LUA->GetNumber(-1) : fallback;
+    LUA->Pop();
+    return value;
+}
+
+static void PushChunkBuildStats(ILuaBase* LUA, const MeshBuilder::ChunkBuildStats& stats) {
+    LUA->CreateTable();
+
+    LUA->PushNumber(static_cast<double>(stats.groups));
+    LUA->SetField(-2, "groups");
+
+    LUA->PushNumber(static_cast<double>(stats.meshes));
+    LUA->SetField(-2, "meshes");
+
+    LUA->PushNumber(static_cast<double>(stats.faces));
+    LUA->SetField(-2, "faces");
+
+    LUA->PushNumber(static_cast<double>(stats.skippedFaces));
+    LUA->SetField(-2, "skippedFaces");
+
+    LUA->PushNumber(static_cast<double>(stats.separateRegionFaces));
+    LUA->SetField(-2, "separateRegionFaces");
+
+    LUA->PushNumber(static_cast<double>(stats.vertices));
+    LUA->SetField(-2, "vertices");
+
+    LUA->PushNumber(static_cast<double>(stats.sourceVertices));
+    LUA->SetField(-2, "sourceVertices");
+
+    LUA->PushNumber(static_cast<double>(stats.indices));
+    LUA->SetField(-2, "indices");
+
+    if (stats.optimize.before.triangles > 0) {
+        LUA->PushNumber(stats.optimize.before.ACMR());
+        LUA->SetField(-2, "acmrBefore");
+        LUA->PushNumber(stats.optimize.after.ACMR());
+        LUA->SetField(-2, "acmrAfter");
+        LUA->PushNumber(stats.optimize.before.ATVR());
+        LUA->SetField(-2, "atvrBefore");
+        LUA->PushNumber(stats.optimize.after.ATVR());
+        LUA->SetField(-2, "atvrAfter");
+    }
+
+    if (stats.lodBuffers > 0) {
+        LUA->PushNumber(static_cast<double>(stats.lodBuffers));
+        LUA->SetField(-2, "lodBuffers");
+
+        LUA->CreateTable();
+        for (uint32_t level = 0; level < MeshBuilder::kMaxChunkLods; level++) {
+            LUA->PushNumber(static_cast<double>(level + 1));
+            LUA->PushNumber(static_cast<double>(stats.lodIndices[level]));
+            LUA->SetTable(-3);
+        }
+        LUA->SetField(-2, "lodIndices");
+    }
+
+    LUA->PushNumber(stats.partitionMs);
+    LUA->SetField(-2, "partitionMs");
+
+    LUA->PushNumber(stats.buildMs);
+    LUA->SetField(-2, "buildMs");
+
+    LUA->PushNumber(stats.threads);
+    LUA->SetField(-2, "threads");
+}
+
+// LOD buffers only carry the vertices their indices still reference
+static std::vector<BatchedMesh> BuildLodMeshBuffers(const MeshBuilder::Vertex* vertices, size_t vertexCount,
+                                                    const MeshBuilder::IndexBuffer* lods, size_t lodCount,
+                                                    bool compact) {
+    std::vector<BatchedMesh> buffers;
+    for (size_t level = 0; level < lodCount; level++) {
+        std::vector<MeshBuilder::Vertex> used(vertices, vertices + vertexCount);
+        std::vector<uint32_t> indices;
+        lods[level].CopyTo(indices);
+        used.resize(MeshBuilder::OptimizeVertexFetch(used, indices));
+
+        MeshBuilder::IndexBuffer remapped;
+        remapped.Assign(indices, used.size());
+        buffers.push_back(BatchedMeshFromVertices(used.data(), used.size(), &remapped));
+        if (compact) buffers.back().Compact();
+    }
+    return buffers;
+}
+
+// Pushes one BuildChunkMeshes entry. id is the 1-based AddChunkBounds id when
+// the mesh was registered natively (0 otherwise); buffer is null when Remix
+// owns the geometry and Lua has nothing to build. lods become a 1-based
+// array of simplified buffers, finest first.
+static void PushChunkMeshEntry(ILuaBase* LUA, int32_t x, int32_t y, int32_t z,
+                               const std::string& material, uint32_t surfaceFlags,
+                               const MeshBuilder::Vec3& mins, const MeshBuilder::Vec3& maxs,
+                               uint32_t id, BatchedMesh* buffer, std::vector<BatchedMesh>* lods = nullptr) {
+    LUA->CreateTable();
+
+    LUA->PushNumber(x);
+    LUA->SetField(-2, "x");
+    LUA->PushNumber(y);
+    LUA->SetField(-2, "y");
+    LUA->PushNumber(z);
+    LUA->SetField(-2, "z");
+
+    LUA->PushString(material.c_str());
+    LUA->SetField(-2, "material");
+
+    LUA->PushBool((surfaceFlags & BSPReader::SURF_TRANS) != 0);
+    LUA->SetField(-2, "translucent");
+
+    LUA->PushVector(Vector(mins.x, mins.y, mins.z));
+    LUA->SetField(-2, "mins");
+    LUA->PushVector(Vector(maxs.x, maxs.y, maxs.z));
+    LUA->SetField(-2, "maxs");
+
+    if (id != 0) {
+        LUA->PushNumber(id);
+        LUA->SetField(-2, "id");
+    }
+
+    if (buffer) {
+        PushMeshBuffer(LUA, std::move(*buffer));
+        LUA->SetField(-2, "buffer");
+
+        if (lods && !lods->empty()) {
+            LUA->CreateTable();
+            for (size_t level = 0; level < lods->size(); level++) {
+                LUA->PushNumber(static_cast<double>(level + 1));
+                PushMeshBuffer(LUA, std::move((*lods)[level]));
+                LUA->SetTable(-3);
+            }
+            LUA->SetField(-2, "lods");
+        }
+    } else {
+        LUA->PushBool(true);
+        LUA->SetField(-2, "remix");
+    }
+}
+
+// Registers the chunk's bounds and hands its geometry to Remix. Returns the
+// 1-based chunk id; submitted is false when Remix rejected the mesh and the
+// caller still has to provide a buffer for that id.
+static uint32_t SubmitRemixChunkMesh(int64_t chunkKey, uint32_t material, uint32_t part,
+                                     const std::string& materialName, uint32_t surfaceFlags,
+                                     const MeshBuilder::Vec3& mins, const MeshBuilder::Vec3& maxs,
+                                     const MeshBuilder::Vertex* vertices, size_t vertexCount,
+                                     const MeshBuilder::IndexBuffer& indices, bool& submitted) {
+    const float boxMins[3] = {mins.x, mins.y, mins.z};
+    const float boxMaxs[3] = {maxs.x, maxs.y, maxs.z};
+    const bool translucent = (surfaceFlags & BSPReader::SURF_TRANS) != 0;
+    uint32_t chunk = RegisterChunkDraw(boxMins, boxMaxs, material + 1, translucent);
+
+    submitted = RemixWorldMeshes::Instance().CreateChunkMesh(
+        chunk, ChunkMeshHash(chunkKey, material, part), vertices, vertexCount, indices, materialName, translucent);
+    return chunk + 1;
+}
+
+// Options shared by BuildChunkMeshes and StartChunkBuild
+struct ChunkBuildRequest {
+    MeshBuilder::ChunkBuildOptions options;
+    bool serial = false;
+    bool compact = false;
+    bool remix = false;
+    std::string cachePath;
+    MeshBuilder::ChunkCacheKey cacheKey;
+};
+
+static void ReadChunkBuildRequest(ILuaBase* LUA, int stackPos, ChunkBuildRequest& request) {
+    MeshBuilder::ChunkBuildOptions& options = request.options;
+    if (!LUA->IsType(stackPos, Type::Table)) return;
+
+    const double chunkSize = GetNumberOption(LUA, stackPos, "chunkSize", options.chunkSize);
+    if (!std::isfinite(chunkSize)) LUA->ArgError(stackPos, "chunkSize must be a finite number");
+    options.chunkSize = static_cast<float>(LuaUtil::ClampNumber(chunkSize, 1.0, FLT_MAX));
+    // Numbers are clamped before the casts; parts are indexed with 16 bits
+    options.maxVertices = static_cast<uint32_t>(
+        LuaUtil::ClampNumber(GetNumberOption(LUA, stackPos, "maxVertices", options.maxVertices), 3.0, 65536.0));
+    request.serial = GetNumberOption(LUA, stackPos, "threads", 0) == 1;
+
+    LUA->GetField(stackPos, "weld");
+    options.weldVertices = LUA->GetBool(-1);
+    LUA->Pop();
+    options.maxIndices = static_cast<uint32_t>(
+        LuaUtil::ClampNumber(GetNumberOption(LUA, stackPos, "maxIndices", 0), 0.0, 3.0 * 65536.0));
+
+    options.lodLevels = static_cast<uint32_t>(LuaUtil::ClampNumber(GetNumberOption(LUA, stackPos, "lods", 0), 0.0,
+                                                                   static_cast<double>(MeshBuilder::kMaxChunkLods)));
+    options.lodMaxError = static_cast<float>(GetNumberOption(LUA, stackPos, "lodError", options.lodMaxError));
+
+    LUA->GetField(stackPos, "compact");
+    request.compact = LUA->GetBool(-1);
+    LUA->Pop();
+
+    LUA->GetField(stackPos, "remix");
+    request.remix = LUA->GetBool(-1) && RemixWorldMeshes::Instance().IsAvailable();
+    LUA->Pop();
+
+    // FeedMeshBuilder expands indexed meshes into triangle lists, so vertex
+    // order only survives on the meshes handed to Remix
+    LUA->GetField(stackPos, "optimize");
+    options.optimizeMeshes = options.weldVertices && request.remix && LUA->GetBool(-1);
+    LUA->Pop();
+
+    LUA->GetField(stackPos, "cache");
+    if (LUA->IsType(-1, Type::String)) request.cachePath = LUA->GetString(-1);
+    LUA->Pop();
+
+    options.hasBounds = GetVectorOption(LUA, stackPos, "mins", options.boundsMins) &&
+                        GetVectorOption(LUA, stackPos, "maxs", options.boundsMaxs);
+
+    options.hasExclusionSphere = GetVectorOption(LUA, stackPos, "skyboxOrigin", options.exclusionCenter);
+    options.exclusionRadius = static_cast<float>(GetNumberOption(LUA, stackPos, "skyboxRadius", 4096));
+}
+
+// Resolves the cache path against the loaded map and opens the cache when
+// it is valid for this map and these options. A miss leaves cachePath set
+// so the build can write a fresh cache.
+static bool OpenChunkMeshCache(ChunkBuildRequest& request, MeshBuilder::ChunkMeshCache& cache) {
+    if (request.cachePath.empty()) return false;
+    request.cachePath = s_worldRoot + request.cachePath;
+
+    request.cacheKey.mapCRC = GetWorldMapCRC();
+    request.cacheKey.mapSize = s_worldMap.Size();
+    request.cacheKey.paramsHash = MeshBuilder::HashChunkBuildOptions(request.options);
+    // Merged faces build different meshes from the same map
+    if (s_mergeFaces) {
+        request.cacheKey.paramsHash = MeshBuilder::Crc32(&s_mergeFaces, sizeof(s_mergeFaces), request.cacheKey.paramsHash);
+    }
+
+    std::string cacheError;
+    if (cache.Open(request.cachePath, request.cacheKey, cacheError)) return true;
+
+    Msg("[RTX] Chunk mesh cache miss (%s), rebuilding\n", cacheError.c_str());
+    return false;
+}
+
+static void WriteChunkMeshCache(const ChunkBuildRequest& request, const std::vector<MeshBuilder::ChunkMesh>& meshes) {
+    std::vector<MeshBuilder::CachedMaterial> materials;
+    materials.reserve(s_worldGeometry.materials.size());
+    for (const BSPReader::MaterialStream& stream : s_worldGeometry.materials) {
+        materials.push_back({stream.material, stream.surfaceFlags});
+    }
+
+    std::string cacheError;
+    if (!MeshBuilder::WriteChunkMeshCache(request.cachePath, request.cacheKey, materials, meshes, cacheError)) {
+        Msg("[RTX] Failed to write chunk mesh cache: %s\n", cacheError.c_str());
+    }
+}
+
+// Pushes the entry for one mesh of an open cache and counts it in stats
+static void PushCachedChunkEntry(ILuaBase* LUA, const ChunkBuildRequest& request,
+                                 const MeshBuilder::ChunkMeshCache& cache, size_t index,
+                                 MeshBuilder::ChunkBuildStats& stats) {
+    const MeshBuilder::CachedChunkMesh& chunk = cache.Meshes()[index];
+    const MeshBuilder::CachedMaterial& material = cache.Materials()[chunk.material];
+
+    MeshBuilder::IndexBuffer indices;
+    if (chunk.indices) indices.Assign(chunk.indices, chunk.indexCount, chunk.indexSize);
+
+    uint32_t id = 0;
+    bool submitted = false;
+    if (request.remix) {
+        id = SubmitRemixChunkMesh(chunk.chunkKey, chunk.material, chunk.part, material.name,
+                                  material.surfaceFlags, chunk.mins, chunk.maxs,
+                                  chunk.vertices, chunk.vertexCount, indices, submitted);
+    }
+
+    BatchedMesh buffer;
+    std::vector<BatchedMesh> lodBuffers;
+    if (!submitted) {
+        buffer = BatchedMeshFromVertices(chunk.vertices, chunk.vertexCount, &indices);
+        if (request.compact) buffer.Compact();
+
+        MeshBuilder::IndexBuffer lods[MeshBuilder::kMaxChunkLods];
+        for (uint32_t level = 0; level < chunk.lodCount; level++) {
+            lods[level].Assign(chunk.lodIndices[level], chunk.lodIndexCounts[level], chunk.indexSize);
+        }
+        lodBuffers = BuildLodMeshBuffers(chunk.vertices, chunk.vertexCount, lods, chunk.lodCount, request.compact);
+    }
+
+    PushChunkMeshEntry(LUA, chunk.chunkX, chunk.chunkY, chunk.chunkZ, material.name,
+                       material.surfaceFlags, chunk.mins, chunk.maxs, id,
+                       submitted ? nullptr : &buffer, &lodBuffers);
+
+    stats.vertices += chunk.vertexCount;
+    stats.indices += chunk.indexCount;
+    stats.lodBuffers += chunk.lodCount;
+    for (uint32_t level = 0; level < chunk.lodCount; level++) {
+        stats.lodIndices[level] += chunk.lodIndexCounts[level];
+    }
+}
+
+// Pushes the entry for one freshly built mesh; chunk keeps its data
+static void PushBuiltChunkEntry(ILuaBase* LUA, const ChunkBuildRequest& request,
+                                const MeshBuilder::ChunkMesh& chunk) {
+    const BSPReader::MaterialStream& stream = s_worldGeometry.materials[chunk.material];
+
+    uint32_t id = 0;
+    bool submitted = false;
+    if (request.remix) {
+        id = SubmitRemixChunkMesh(chunk.chunkKey, chunk.material, chunk.part, stream.material,
+                                  stream.surfaceFlags, chunk.mins, chunk.maxs,
+                                  chunk.vertices.data(), chunk.vertices.size(), chunk.indices, submitted);
+    }
+
+    BatchedMesh buffer;
+    std::vector<BatchedMesh> lodBuffers;
+    if (!submitted) {
+        buffer = BatchedMeshFromVertices(chunk.vertices.data(), chunk.vertices.size(), &chunk.indices);
+        if (request.compact) buffer.Compact();
+        lodBuffers = BuildLodMeshBuffers(chunk.vertices.data(), chunk.vertices.size(),
+                                         chunk.lods.data(), chunk.lods.size(), request.compact);
+    }
+
+    PushChunkMeshEntry(LUA, chunk.chunkX, chunk.chunkY, chunk.chunkZ, stream.material,
+                       stream.surfaceFlags, chunk.mins, chunk.maxs, id,
+                       submitted ? nullptr : &buffer, &lodBuffers);
+}
+
+// Free the native copy as soon as the buffer (or Remix) owns the data
+static void ReleaseChunkMesh(MeshBuilder::ChunkMesh& chunk) {
+    std::vector<MeshBuilder::Vertex>().swap(chunk.vertices);
+    chunk.indices.Clear();
+    std::vector<MeshBuilder::IndexBuffer>().swap(chunk.lods);
+}
+
+// Builds every (chunk, material) mesh of the loaded map on the worker pool.
+// Options:
+//   chunkSize, maxVertices, threads (1 = serial), mins/maxs,
+//   skyboxOrigin/skyboxRadius
+//   weld       - indexed output, budgeted by unique vertices and maxIndices
+//   optimize   - vertex cache/overdraw/fetch pass over welded meshes; only
+//                with remix, since returned buffers are drawn unindexed
+//   lods       - simplified LOD buffers per welded mesh (0-3), returned as
+//                each entry's lods array; none for meshes Remix owns
+//   lodError   - allowed surface deviation of the first LOD in units,
+//                doubling per level
+//   compact    - 20-byte vertex layout for the returned buffers
+//   cache      - cache file path relative to the game directory; a valid
+//                cache for this map and these options replaces the build
+//   remix      - create each mesh through the Remix API and register its
+//                bounds natively; such entries carry id and remix = true
+//                instead of a buffer. Entries Remix rejects keep their
+//                buffer and id. Ignored when Remix is not running.
+// Returns the mesh list and a stats table.
+LUA_FUNCTION(BuildChunkMeshes_Native) {
+    ChunkBuildRequest request;
+    ReadChunkBuildRequest(LUA, 1, request);
+
+    if (!s_worldMap.IsOpen()) {
+        LUA->PushNil();
+        return 1;
+    }
+
+    auto loadStart = std::chrono::high_resolution_clock::now();
+    MeshBuilder::ChunkMeshCache cache;
+    if (OpenChunkMeshCache(request, cache)) {
+        MeshBuilder::ChunkBuildStats stats;
+        stats.threads = 1;
+
+        LUA->CreateTable();
+        for (size_t i = 0; i < cache.Meshes().size(); i++) {
+            LUA->PushNumber(i + 1);
+            PushCachedChunkEntry(LUA, request, cache, i, stats);
+            LUA->SetTable(-3);
+        }
+        stats.meshes = cache.Meshes().size();
+        cache.Close();
+
+        PushChunkBuildStats(LUA, stats);
+        LUA->PushBool(true);
+        LUA->SetField(-2, "cached");
+        LUA->PushNumber(std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - loadStart).count());
+        LUA->SetField(-2, "cacheMs");
+        return 2;
+    }
+
+    MeshBuilder::ChunkBuildStats stats;
+    std::vector<MeshBuilder::ChunkMesh> meshes = MeshBuilder::BuildChunkMeshes(
+        s_worldGeometry, request.options, request.serial ? nullptr : &MeshBuilder::WorkerPool::Instance(), &stats);
+
+    if (!request.cachePath.empty()) WriteChunkMeshCache(request, meshes);
+
+    LUA->CreateTable();
+    for (size_t i = 0; i < meshes.size(); i++) {
+        LUA->PushNumber(i + 1);
+        PushBuiltChunkEntry(LUA, request, meshes[i]);
+        LUA->SetTable(-3);
+        ReleaseChunkMesh(meshes[i]);
+    }
+
+    PushChunkBuildStats(LUA, stats);
+    return 2;
+}
+
+// A BuildChunkMeshes call spread over many frames. The plan is made up
+// front; StepChunkBuild then builds meshes in small parallel batches and
+// hands out finished ones until its time budget is spent.
+struct ChunkBuildJob {
+    ChunkBuildRequest request;
+    std::unique_ptr<MeshBuilder::ChunkBuildPlan> plan;  // Null when serving a valid cache
+    MeshBuilder::ChunkMeshCache cache;
+    std::vector<MeshBuilder::ChunkMesh> meshes;
+    std::vector<MeshBuilder::MeshOptimizeStats> optimizeStats;
+    MeshBuilder::ChunkBuildStats stats;
+    size_t total = 0;
+    size_t built = 0;    // Meshes [0, built) are finished
+    size_t emitted = 0;  // Meshes [0, emitted) were handed to Lua
+    std::chrono::high_resolution_clock::time_point start;
+};
+static std::unique_ptr<ChunkBuildJob> s_chunkBuildJob;
+
+// The plan reads s_worldGeometry, so any map change ends the job first
+static void CancelChunkBuildJob() {
+    if (!s_chunkBuildJob) return;
+    Msg("[RTX] Cancelled chunk build after %zu of %zu meshes\n", s_chunkBuildJob->emitted, s_chunkBuildJob->total);
+    s_chunkBuildJob.reset();
+}
+
+static void PushChunkBuildProgress(ILuaBase* LUA, const ChunkBuildJob& job, bool finished) {
+    LUA->CreateTable();
+
+    LUA->PushNumber(static_cast<double>(job.emitted));
+    LUA->SetField(-2, "done");
+
+    LUA->PushNumber(static_cast<double>(job.total));
+    LUA->SetField(-2, "total");
+
+    LUA->PushNumber(static_cast<double>(job.built));
+    LUA->SetField(-2, "built");
+
+    LUA->PushBool(finished);
+    LUA->SetField(-2, "finished");
+
+    LUA->PushBool(!job.plan);
+    LUA->SetField(-2, "cached");
+}
+
+// StartChunkBuild(options)
+// Starts an incremental build with the BuildChunkMeshes options, replacing
+// any build in progress. Returns the number of meshes it will produce and
+// whether they come from the cache, or nil when no map is loaded.
+LUA_FUNCTION(StartChunkBuild_Native) {
+    s_chunkBuildJob.reset();
+
+    auto job = std::make_unique<ChunkBuildJob>();
+    ReadChunkBuildRequest(LUA, 1, job->request);
+
+    if (!s_worldMap.IsOpen()) {
+        LUA->PushNil();
+        return 1;
+    }
+
+    job->start = std::chrono::high_resolution_clock::now();
+    if (OpenChunkMeshCache(job->request, job->cache)) {
+        job->total = job->cache.Meshes().size();
+        job->built = job->total;
+        job->stats.threads = 1;
+        job->stats.meshes = job->total;
+    } else {
+        job->plan = std::make_unique<MeshBuilder::ChunkBuildPlan>(s_worldGeometry, job->request.options);
+        job->total = job->plan->MeshCount();
+        job->meshes.resize(job->total);
+        job->optimizeStats.resize(job->request.options.optimizeMeshes ? job->total : 0);
+        job->stats = job->plan->Stats();
+        job->stats.threads = job->request.serial ? 1 : MeshBuilder::WorkerPool::Instance().ThreadCount() + 1;
+    }
+
+    LUA->PushNumber(static_cast<double>(job->total));
+    LUA->PushBool(!job->plan);
+    s_chunkBuildJob = std::move(job);
+    return 2;
+}
+
+// StepChunkBuild(budgetMs[, maxEntries])
+// Advances the build for about budgetMs (at least one mesh per call) and
+// returns the meshes finished meanwhile as BuildChunkMeshes entries, at most
+// maxEntries of them, plus a progress table {done, total, built, finished,
+// cached}. The call that hands out the last mesh also returns the stats
+// table and ends the job. Returns nil when no build is running.
+LUA_FUNCTION(StepChunkBuild_Native) {
+    if (!s_chunkBuildJob) {
+        LUA->PushNil();
+        return 1;
+    }
+
+    using Clock = std::chrono::high_resolution_clock;
+    const auto stepStart = Clock::now();
+    // max(lower, x) also maps NaN to the lower bound; the entry limit is
+    // only cast once it is known to fit
+    const double budgetMs = LUA->IsType(1, Type::Number) ? std::max(0.0, LUA->GetNumber(1)) : 4.0;
+    const double entryLimit = LUA->IsType(2, Type::Number) ? std::max(1.0, LUA->GetNumber(2)) : HUGE_VAL;
+    const size_t maxEntries = entryLimit < 4294967296.0 ? static_cast<size_t>(entryLimit) : SIZE_MAX;
+    auto elapsedMs = [](Clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    };
+
+    ChunkBuildJob& job = *s_chunkBuildJob;
+    MeshBuilder::WorkerPool* pool = job.request.serial ? nullptr : &MeshBuilder::WorkerPool::Instance();
+    const bool keepMeshes = job.plan && !job.request.cachePath.empty();
+
+    LUA->CreateTable();
+    size_t entries = 0;
+    while (entries < maxEntries) {
+        if (job.emitted < job.built) {
+            LUA->PushNumber(static_cast<double>(entries + 1));
+            if (job.plan) {
+                MeshBuilder::ChunkMesh& chunk = job.meshes[job.emitted];
+                PushBuiltChunkEntry(LUA, job.request, chunk);
+                MeshBuilder::ChunkBuildPlan::AddMeshStats(chunk, job.stats);
+                // The cache is written from every mesh once the last one is done
+                if (!keepMeshes) ReleaseChunkMesh(chunk);
+            } else {
+                PushCachedChunkEntry(LUA, job.request, job.cache, job.emitted, job.stats);
+            }
+            LUA->SetTable(-3);
+            job.emitted++;
+            entries++;
+        } else if (job.built < job.total) {
+            // One mesh per thread keeps each batch short enough to fit a frame
+            const size_t first = job.built;
+            const size_t batch = std::min(job.total - first, static_cast<size_t>(pool ? pool->ThreadCount() + 1 : 1));
+            auto buildStart = Clock::now();
+            auto buildMesh = [&](size_t i) {
+                job.plan->BuildMesh(first + i, job.meshes[first + i],
+                                    job.optimizeStats.empty() ? nullptr : &job.optimizeStats[first + i]);
+            };
+            if (pool) {
+                pool->ParallelFor(batch, buildMesh);
+            } else {
+                for (size_t i = 0; i < batch; i++) buildMesh(i);
+            }
+            job.stats.buildMs += elapsedMs(buildStart);
+            job.built += batch;
+        } else {
+            break;
+        }
+
+        if (elapsedMs(stepStart) >= budgetMs) break;
+    }
+
+    const bool finished = job.emitted == job.total;
+    PushChunkBuildProgress(LUA, job, finished);
+    if (!finished) return 2;
+
+    if (keepMeshes) WriteChunkMeshCache(job.request, job.meshes);
+    for (const auto& optimize : job.optimizeStats) {
+        job.stats.optimize.Add(optimize);
+    }
+
+    PushChunkBuildStats(LUA, job.stats);
+    if (!job.plan) {
+        LUA->PushBool(true);
+        LUA->SetField(-2, "cached");
+        LUA->PushNumber(elapsedMs(job.start));
+        LUA->SetField(-2, "cacheMs");
+    }
+    LUA->PushNumber(elapsedMs(job.start));
+    LUA->SetField(-2, "totalMs");
+
+    s_chunkBuildJob.reset();
+    return 3;
+}
+
+LUA_FUNCTION(CancelChunkBuild_Native) {
+    CancelChunkBuildJob();
+    return 0;
+}
+
+// Times the chunk builder serially and on the worker pool over a synthetic map
+LUA_FUNCTION(BenchmarkChunkBuilder_Native) {
+    size_t faceCount = LUA->IsType(1, Type::Number) ? static_cast<size_t>(LUA->GetNumber(1)) : 500000;
+    float chunkSize = LUA->IsType(2, Type::Number) ? static_cast<float>(LUA->GetNumber(2)) : 4096.0f;
+
+    BSPReader::WorldGeometry synthetic;
+    MeshBuilder::GenerateSyntheticWorld(faceCount, 64, 1337, synthetic);
+
+    MeshBuilder::ChunkBuildOptions options;
+    options.chunkSize = chunkSize;
+    options.skipSkyMaterials = false;
+    options.skipSeparateRegions = false;
+
+    MeshBuilder::ChunkBuildStats serialStats, parallelStats;
+    MeshBuilder::BuildChunkMeshes(synthetic, options, nullptr, &serialStats);
+    MeshBuilder::BuildChunkMeshes(synthetic, options, &MeshBuilder::WorkerPool::Instance(), &parallelStats);
+
+    double serialMs = serialStats.partitionMs + serialStats.buildMs;
+    double parallelMs = parallelStats.partitionMs + parallelStats.buildMs;
+    Msg("[RTX] Chunk builder benchmark (%zu faces, %zu meshes): serial %.2f ms, %u threads %.2f ms (%.2fx)\n",
+        faceCount, parallelStats.meshes, serialMs, parallelStats.threads, parallelMs,
+        parallelMs > 0.0 ? serialMs / parallelMs : 0.0);
+
+    PushChunkBuildStats(LUA, serialStats);
+    PushChunkBuildStats(LUA, parallelStats);
+    return 2;
+}
+
+// Groups faces into connected regions in one pass. Takes an array of vertex
+// tables (one per face, e.g. NikNaks face:GetVertexs()) and returns the
+// regions, largest first, plus the 1-based region of each face (0 = none).
+LUA_FUNCTION(ClassifyRegions_Native) {
+    LUA->CheckType(1, Type::Table);
+
+    MeshBuilder::RegionOptions options;
+    if (LUA->IsType(2, Type::Number)) options.gap = static_cast<float>(LUA->GetNumber(2));
+    if (LUA->IsType(3, Type::Number)) options.separationDistance = static_cast<float>(LUA->GetNumber(3));
+
+    size_t faceCount = LUA->ObjLen(1);
+    std::vector<float> boxes(faceCount * 6);
+    for (size_t f = 0; f < faceCount; f++) {
+        float* box = boxes.data() + f * 6;
+        box[0] = box[1] = box[2] = FLT_MAX;
+        box[3] = box[4] = box[5] = -FLT_MAX;
+
+        LUA->PushNumber(static_cast<double>(f + 1));
+        LUA->GetTable(1);
+        if (LUA->IsType(-1, Type::Table)) {
+            size_t vertexCount = LUA->ObjLen(-1);
+            for (size_t v = 1; v <= vertexCount; v++) {
+                LUA->PushNumber(static_cast<double>(v));
+                LUA->GetTable(-2);
+                if (LUA->IsType(-1, Type::Vector)) {
+                    const Vector& p = *LUA->GetUserType<Vector>(-1, Type::Vector);
+                    box[0] = std::min(box[0], p.x); box[3] = std::max(box[3], p.x);
+                    box[1] = std::min(box[1], p.y); box[4] = std::max(box[4], p.y);
+                    box[2] = std::min(box[2], p.z); box[5] = std::max(box[5], p.z);
+                }
+                LUA->Pop();
+            }
+        }
+        LUA->Pop();
+
+        // Faces without vertices get no region
+        if (box[0] > box[3]) box[0] = NAN;
+    }
+
+    MeshBuilder::RegionClassification result;
+    MeshBuilder::ClassifyRegions(boxes.data(), faceCount, options, result);
+
+    LUA->CreateTable();
+    for (size_t i = 0; i < result.regions.size(); i++) {
+        const MeshBuilder::Region& region = result.regions[i];
+        LUA->PushNumber(static_cast<double>(i + 1));
+        LUA->CreateTable();
+        LUA->PushVector(Vector(region.mins.x, region.mins.y, region.mins.z));
+        LUA->SetField(-2, "mins");
+        LUA->PushVector(Vector(region.maxs.x, region.maxs.y, region.maxs.z));
+        LUA->SetField(-2, "maxs");
+        LUA->PushNumber(static_cast<double>(region.faceCount));
+        LUA->SetField(-2, "faceCount");
+        LUA->PushBool(region.separate);
+        LUA->SetField(-2, "separate");
+        LUA->SetTable(-3);
+    }
+
+    LUA->CreateTable();
+    for (size_t f = 0; f < faceCount; f++) {
+        uint32_t region = result.faceRegions[f];
+        LUA->PushNumber(static_cast<double>(f + 1));
+        LUA->PushNumber(region == MeshBuilder::RegionClassification::InvalidRegion ? 0.0 : region + 1.0);
+        LUA->SetTable(-3);
+    }
+
+    Msg("[RTX] Classified %zu faces into %zu regions (%zu cells) in %.2f ms\n",
+        faceCount, result.regions.size(), result.cells, result.milliseconds);
+    return 2;
+}
+
+// Returns the coplanar face merge stats of the loaded map
+LUA_FUNCTION(GetFaceMergeStats_Native) {
+    LUA->CreateTable();
+    LUA->PushNumber(static_cast<double>(s_faceMergeStats.facesBefore));
+    LUA->SetField(-2, "facesBefore");
+    LUA->PushNumber(static_cast<double>(s_faceMergeStats.facesAfter));
+    LUA->SetField(-2, "facesAfter");
+    LUA->PushNumber(static_cast<double>(s_faceMergeStats.trianglesBefore));
+    LUA->SetField(-2, "trianglesBefore");
+    LUA->PushNumber(static_cast<double>(s_faceMergeStats.trianglesAfter));
+    LUA->SetField(-2, "trianglesAfter");
+    LUA->PushNumber(static_cast<double>(s_faceMergeStats.merges));
+    LUA->SetField(-2, "merges");
+    LUA->PushNumber(static_cast<double>(s_faceMergeStats.removedVertices));
+    LUA->SetField(-2, "removedVertices");
+    LUA->PushNumber(s_faceMergeStats.milliseconds);
+    LUA->SetField(-2, "ms");
+    return 1;
+}
+
+void RegisterWorldGeometryFunctions(ILuaBase* LUA) {
+    LUA->PushCFunction(LoadMapBSP_Native);
+    LUA->SetField(-2, "LoadMapBSP");
+
+    LUA->PushCFunction(LoadMapBSPFromString_Native);
+    LUA->SetField(-2, "LoadMapBSPFromString");
+
+    LUA->PushCFunction(UnloadMapBSP_Native);
+    LUA->SetField(-2, "UnloadMapBSP");
+
+    LUA->PushCFunction(IsMapBSPLoaded_Native);
+    LUA->SetField(-2, "IsMapBSPLoaded");
+
+    LUA->PushCFunction(GetWorldMaterialStreams_Native);
+    LUA->SetField(-2, "GetWorldMaterialStreams");
+
+    LUA->PushCFunction(BuildChunkMeshes_Native);
+    LUA->SetField(-2, "BuildChunkMeshes");
+
+    LUA->PushCFunction(StartChunkBuild_Native);
+    LUA->SetField(-2, "StartChunkBuild");
+
+    LUA->PushCFunction(StepChunkBuild_Native);
+    LUA->SetField(-2, "StepChunkBuild");
+
+    LUA->PushCFunction(CancelChunkBuild_Native);
+    LUA->SetField(-2, "CancelChunkBuild");
+
+    LUA->PushCFunction(BenchmarkChunkBuilder_Native);
+    LUA->SetField(-2, "BenchmarkChunkBuilder");
+
+    LUA->PushCFunction(ClassifyRegions_Native);
+    LUA->SetField(-2, "ClassifyRegions");
+
+    LUA->PushCFunction(GetFaceMergeStats_Native);
+    LUA->SetField(-2, "GetFaceMergeStats");
+}
+
+} // namespace EntityManager
@@ -0,0 +1,49 @@
+#pragma once
+#include "GarrysMod/Lua/Interface.h"
+#include "mathlib/vector.h"
+#include <cstddef>
+
+// Small Lua stack helpers shared by the native modules
+namespace LuaUtil {
+    // Reads the Vector at stackPos into xyz floats; raises a Lua argument
+    // error for anything else
+    inline void CheckVector(GarrysMod::Lua::ILuaBase* LUA, int stackPos, float out[3]) {
+        LUA->CheckType(stackPos, GarrysMod::Lua::Type::Vector);
+        const Vector* v = LUA->GetUserType<Vector>(stackPos, GarrysMod::Lua::Type::Vector);
+        out[0] = v->x;
+        out[1] = v->y;
+        out[2] = v->z;
+    }
+
+    // Clamps a Lua number into [lower, upper] so the integer cast after it
+    // is defined; NaN becomes lower
+    inline double ClampNumber(double value, double lower, double upper) {
+        return value >= lower ? (value <= upper ? value : upper) : lower;
+    }
+
+    // Writes value(0) .. value(count - 1) as an array into the table at
+    // outStackPos when there is one, so per-frame queries can reuse it, and
+    // clears whatever is left of its previous contents; otherwise into a new
+    // table. Leaves the table on the stack.
+    template <typename ValueFn>
+    void PushNumberList(GarrysMod::Lua::ILuaBase* LUA, size_t count, int outStackPos, ValueFn value) {
+        int previous = 0;
+        if (LUA->IsType(outStackPos, GarrysMod::Lua::Type::Table)) {
+            previous = LUA->ObjLen(outStackPos);
+            LUA->Push(outStackPos);
+        } else {
+            LUA->CreateTable();
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            LUA->PushNumber(static_cast<double>(i + 1));
+            LUA->PushNumber(static_cast<double>(value(i)));
+            LUA->SetTable(-3);
+        }
+        for (int i = static_cast<int>(count) + 1; i <= previous; i++) {
+            LUA->PushNumber(i);
+            LUA->PushNil();
+            LUA->SetTable(-3);
+        }
+    }
+}
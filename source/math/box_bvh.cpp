@@ -0,0 +1,180 @@
+#include "box_bvh.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace RTXMath {
+
+void BoxBVH::Clear() {
+    m_nodes.clear();
+    m_order.clear();
+    m_center.clear();
+    m_extent.clear();
+    m_depth = 0;
+}
+
+void BoxBVH::Build(const float* mins, const float* maxs, size_t count) {
+    Clear();
+    if (count == 0) return;
+
+    std::vector<float> centers(count * 3), extents(count * 3);
+    for (size_t i = 0; i < count * 3; i++) {
+        centers[i] = (mins[i] + maxs[i]) * 0.5f;
+        extents[i] = std::fabs(maxs[i] - mins[i]) * 0.5f;
+    }
+
+    m_order.resize(count);
+    for (size_t i = 0; i < count; i++) m_order[i] = static_cast<uint32_t>(i);
+
+    struct Range {
+        uint32_t node, first, count;
+        int depth;
+    };
+    std::vector<Range> stack;
+    m_nodes.reserve(2 * (count / kLeafSize + 1));
+    m_nodes.push_back(Node());
+    stack.push_back({0, 0, static_cast<uint32_t>(count), 1});
+
+    while (!stack.empty()) {
+        Range range = stack.back();
+        stack.pop_back();
+        m_depth = std::max(m_depth, range.depth);
+
+        // Bounds of the boxes and of their centroids
+        float boxMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, boxMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        float centroidMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, centroidMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        for (uint32_t i = range.first; i < range.first + range.count; i++) {
+            const float* c = centers.data() + m_order[i] * 3;
+            const float* e = extents.data() + m_order[i] * 3;
+            for (int axis = 0; axis < 3; axis++) {
+                boxMin[axis] = std::min(boxMin[axis], c[axis] - e[axis]);
+                boxMax[axis] = std::max(boxMax[axis], c[axis] + e[axis]);
+                centroidMin[axis] = std::min(centroidMin[axis], c[axis]);
+                centroidMax[axis] = std::max(centroidMax[axis], c[axis]);
+            }
+        }
+
+        Node& node = m_nodes[range.node];
+        for (int axis = 0; axis < 3; axis++) {
+            node.center[axis] = (boxMin[axis] + boxMax[axis]) * 0.5f;
+            // Padded so rounding never leaves a child poking out of its parent
+            float extent = (boxMax[axis] - boxMin[axis]) * 0.5f;
+            node.extent[axis] = extent + std::fabs(node.center[axis]) * 1e-6f + extent * 1e-6f + 1e-3f;
+        }
+
+        if (range.count <= kLeafSize) {
+            node.first = range.first;
+            node.count = range.count;
+            continue;
+        }
+
+        int axis = 0;
+        for (int a = 1; a < 3; a++) {
+            if (centroidMax[a] - centroidMin[a] > centroidMax[axis] - centroidMin[axis]) axis = a;
+        }
+
+        // Median split keeps the tree balanced even when centroids coincide
+        uint32_t half = range.count / 2;
+        auto begin = m_order.begin() + range.first;
+        std::nth_element(begin, begin + half, begin + range.count, [&](uint32_t a, uint32_t b) {
+            return centers[a * 3 + axis] < centers[b * 3 + axis];
+        });
+
+        uint32_t left = static_cast<uint32_t>(m_nodes.size());
+        node.first = left;
+        node.count = 0;
+        m_nodes.push_back(Node());
+        m_nodes.push_back(Node());
+        stack.push_back({left, range.first, half, range.depth + 1});
+        stack.push_back({left + 1, range.first + half, range.count - half, range.depth + 1});
+    }
+
+    m_center.resize(count * 3);
+    m_extent.resize(count * 3);
+    for (size_t i = 0; i < count; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            m_center[i * 3 + axis] = centers[m_order[i] * 3 + axis];
+            m_extent[i * 3 + axis] = extents[m_order[i] * 3 + axis];
+        }
+    }
+}
+
+void BoxBVH::QueryRadius(const float center[3], float radius, std::vector<uint32_t>& out) const {
+    out.clear();
+    if (m_nodes.empty() || !(radius >= 0.0f)) return;
+
+    const float radiusSqr = radius * radius;
+    auto distanceSqr = [&](const float* c, const float* e) {
+        float dx = std::max(std::fabs(c[0] - center[0]) - e[0], 0.0f);
+        float dy = std::max(std::fabs(c[1] - center[1]) - e[1], 0.0f);
+        float dz = std::max(std::fabs(c[2] - center[2]) - e[2], 0.0f);
+        return dx * dx + dy * dy + dz * dz;
+    };
+
+    uint32_t stack[128];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+        if (distanceSqr(node.center, node.extent) > radiusSqr) continue;
+
+        if (node.count == 0) {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+            if (distanceSqr(&m_center[i * 3], &m_extent[i * 3]) <= radiusSqr) out.push_back(m_order[i]);
+        }
+    }
+
+    std::sort(out.begin(), out.end());
+}
+
+void BoxBVH::QueryFrustum(const ViewFrustum& frustum, std::vector<uint32_t>& out, float padding) const {
+    out.clear();
+    if (m_nodes.empty()) return;
+
+    const bool testDistance = frustum.maxDistance > 0.0f;
+    const float maxDistanceSqr = frustum.maxDistance * frustum.maxDistance;
+    padding = std::max(padding, 0.0f);
+
+    // Same arithmetic as the scalar CullBoxes kernel
+    auto isVisible = [&](const float* c, const float* e) {
+        for (const CullPlane& plane : frustum.planes) {
+            float dist = plane.normal[0] * c[0] + plane.normal[1] * c[1] + plane.normal[2] * c[2] + plane.dist;
+            float radius = std::fabs(plane.normal[0]) * e[0] + std::fabs(plane.normal[1]) * e[1] +
+                           std::fabs(plane.normal[2]) * e[2];
+            if (dist + radius + padding < 0.0f) return false;
+        }
+
+        if (testDistance) {
+            float dx = std::max(std::fabs(c[0] - frustum.origin[0]) - e[0] - padding, 0.0f);
+            float dy = std::max(std::fabs(c[1] - frustum.origin[1]) - e[1] - padding, 0.0f);
+            float dz = std::max(std::fabs(c[2] - frustum.origin[2]) - e[2] - padding, 0.0f);
+            if (dx * dx + dy * dy + dz * dz > maxDistanceSqr) return false;
+        }
+        return true;
+    };
+
+    uint32_t stack[128];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = m_nodes[stack[--top]];
+        if (!isVisible(node.center, node.extent)) continue;
+
+        if (node.count == 0) {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+            if (isVisible(&m_center[i * 3], &m_extent[i * 3])) out.push_back(m_order[i]);
+        }
+    }
+
+    std::sort(out.begin(), out.end());
+}
+
+} // namespace RTXMath
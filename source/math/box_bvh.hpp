@@ -0,0 +1,47 @@
+#pragma once
+#include "frustum_culling.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RTXMath {
+    // Static bounding volume hierarchy over axis-aligned boxes, built once
+    // and then only queried. Nodes are split at the median centroid along
+    // their longest axis, so the tree is balanced and queries visit
+    // O(log n) nodes plus the boxes they return.
+    class BoxBVH {
+    public:
+        // mins and maxs hold count xyz triples; a box may be a single point
+        void Build(const float* mins, const float* maxs, size_t count);
+        void Clear();
+
+        size_t Size() const { return m_order.size(); }
+        size_t NodeCount() const { return m_nodes.size(); }
+        int Depth() const { return m_depth; }
+
+        // Boxes whose nearest point lies within radius of center, in
+        // ascending index order
+        void QueryRadius(const float center[3], float radius, std::vector<uint32_t>& out) const;
+        // Boxes that touch the frustum, grown by padding on every side, in
+        // ascending index order. With no padding the result is exactly what
+        // CullBoxes returns for the same boxes.
+        void QueryFrustum(const ViewFrustum& frustum, std::vector<uint32_t>& out, float padding = 0.0f) const;
+
+    private:
+        static constexpr uint32_t kLeafSize = 4;
+
+        // Center/half-extent form, the same as CullBoxSet, so leaves test
+        // exactly like the flat culling kernels
+        struct Node {
+            float center[3];
+            float extent[3];
+            uint32_t first;  // First child node, or first box in m_order for a leaf
+            uint32_t count;  // Boxes in a leaf, 0 for an inner node
+        };
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_order;        // Box indices in leaf order
+        std::vector<float> m_center, m_extent; // Per box in leaf order, xyz triples
+        int m_depth = 0;
+    };
+}
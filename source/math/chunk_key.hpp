@@ -0,0 +1,46 @@
+#pragma once
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+namespace RTXMath {
+    // The one packed key for chunk and grid cells, shared by the Lua mesher,
+    // the native chunk builder and the spatial indices. Signed cell
+    // coordinates are biased to 17 bits per axis, so the 51-bit key stays
+    // exact as a Lua number and sorts by x, y, z. Coordinates outside
+    // [kMinChunkCoord, kMaxChunkCoord] have no key; callers reject them
+    // rather than folding them into the edge cell.
+    constexpr int32_t kMinChunkCoord = -(1 << 16);
+    constexpr int32_t kMaxChunkCoord = (1 << 16) - 1;
+
+    inline bool IsChunkCoordInRange(int32_t x, int32_t y, int32_t z) {
+        return x >= kMinChunkCoord && x <= kMaxChunkCoord &&
+               y >= kMinChunkCoord && y <= kMaxChunkCoord &&
+               z >= kMinChunkCoord && z <= kMaxChunkCoord;
+    }
+
+    // floor(value * inverseCell) as a cell coordinate; false when value is
+    // not finite or its cell is out of range
+    inline bool ToChunkCoord(float value, float inverseCell, int32_t& coord) {
+        const float cell = std::floor(value * inverseCell);
+        if (!(cell >= kMinChunkCoord && cell <= kMaxChunkCoord)) return false;
+        coord = static_cast<int32_t>(cell);
+        return true;
+    }
+
+    inline int64_t PackChunkKey(int32_t x, int32_t y, int32_t z) {
+        assert(IsChunkCoordInRange(x, y, z));
+        const int64_t bias = 1 << 16;
+        return ((static_cast<int64_t>(x) + bias) << 34) |
+               ((static_cast<int64_t>(y) + bias) << 17) |
+               (static_cast<int64_t>(z) + bias);
+    }
+
+    inline void UnpackChunkKey(int64_t key, int32_t& x, int32_t& y, int32_t& z) {
+        const int64_t bias = 1 << 16;
+        const int64_t mask = (1 << 17) - 1;
+        x = static_cast<int32_t>(((key >> 34) & mask) - bias);
+        y = static_cast<int32_t>(((key >> 17) & mask) - bias);
+        z = static_cast<int32_t>((key & mask) - bias);
+    }
+}
@@ -0,0 +1,197 @@
+#include "compact_vertex.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace RTXMath {
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Inf and NaN (keep NaN quiet)
+    if (exponent == 0xFF) {
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    }
+
+    int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+
+    // Overflow rounds to infinity
+    if (halfExponent >= 0x1F) {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+
+    // Subnormal or zero
+    if (halfExponent <= 0) {
+        if (halfExponent < -10) return static_cast<uint16_t>(sign);
+
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+        uint32_t halfMantissa = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (halfMantissa & 1))) halfMantissa++;
+        return static_cast<uint16_t>(sign | halfMantissa);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFF;
+    // Carry into the exponent is correct, including overflow to infinity
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) half++;
+    return static_cast<uint16_t>(half);
+}
+
+float HalfToFloat(uint16_t value) {
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1F;
+    uint32_t mantissa = value & 0x3FF;
+    uint32_t bits;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Renormalize the subnormal
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400) == 0) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+    } else if (exponent == 0x1F) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static float SignNotZero(float value) {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+void EncodeOctahedral(const float normal[3], int16_t out[2]) {
+    float l1 = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+    if (l1 <= 0.0f) {
+        out[0] = 0;
+        out[1] = 0;
+        return;
+    }
+
+    float x = normal[0] / l1;
+    float y = normal[1] / l1;
+
+    // Fold the lower hemisphere over the diagonals
+    if (normal[2] < 0.0f) {
+        float foldX = (1.0f - std::fabs(y)) * SignNotZero(x);
+        float foldY = (1.0f - std::fabs(x)) * SignNotZero(y);
+        x = foldX;
+        y = foldY;
+    }
+
+    // The rounded grid point is not always the one that decodes closest,
+    // so try all four neighbours and keep the best (the "precise" variant)
+    float bx = std::floor(std::max(-1.0f, std::min(1.0f, x)) * 32767.0f);
+    float by = std::floor(std::max(-1.0f, std::min(1.0f, y)) * 32767.0f);
+
+    double bestDot = -2.0;
+    for (int i = 0; i < 4; i++) {
+        int16_t candidate[2] = {
+            static_cast<int16_t>(std::max(-32767.0f, std::min(32767.0f, bx + (i & 1)))),
+            static_cast<int16_t>(std::max(-32767.0f, std::min(32767.0f, by + (i >> 1))))
+        };
+
+        float decoded[3];
+        DecodeOctahedral(candidate, decoded);
+        double dot = static_cast<double>(decoded[0]) * normal[0] +
+                     static_cast<double>(decoded[1]) * normal[1] +
+                     static_cast<double>(decoded[2]) * normal[2];
+        if (dot > bestDot) {
+            bestDot = dot;
+            out[0] = candidate[0];
+            out[1] = candidate[1];
+        }
+    }
+}
+
+void DecodeOctahedral(const int16_t encoded[2], float normal[3]) {
+    float x = std::max(encoded[0] / 32767.0f, -1.0f);
+    float y = std::max(encoded[1] / 32767.0f, -1.0f);
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+    if (z < 0.0f) {
+        float foldX = (1.0f - std::fabs(y)) * SignNotZero(x);
+        float foldY = (1.0f - std::fabs(x)) * SignNotZero(y);
+        x = foldX;
+        y = foldY;
+    }
+
+    float length = std::sqrt(x * x + y * y + z * z);
+    normal[0] = x / length;
+    normal[1] = y / length;
+    normal[2] = z / length;
+}
+
+void EncodeCompactVertices(const float* positions, const float* normals, const float* uvs,
+                           size_t count, const float uvOffset[2], CompactVertex* out) {
+    for (size_t i = 0; i < count; i++) {
+        CompactVertex& vert = out[i];
+        vert.pos[0] = positions[i * 3 + 0];
+        vert.pos[1] = positions[i * 3 + 1];
+        vert.pos[2] = positions[i * 3 + 2];
+        EncodeOctahedral(&normals[i * 3], vert.normal);
+        vert.uv[0] = FloatToHalf(uvs[i * 2 + 0] - uvOffset[0]);
+        vert.uv[1] = FloatToHalf(uvs[i * 2 + 1] - uvOffset[1]);
+    }
+}
+
+void DecodeCompactVertices(const CompactVertex* vertices, size_t count, const float uvOffset[2],
+                           float* positions, float* normals, float* uvs) {
+    for (size_t i = 0; i < count; i++) {
+        const CompactVertex& vert = vertices[i];
+        if (positions) {
+            positions[i * 3 + 0] = vert.pos[0];
+            positions[i * 3 + 1] = vert.pos[1];
+            positions[i * 3 + 2] = vert.pos[2];
+        }
+        if (normals) {
+            DecodeOctahedral(vert.normal, &normals[i * 3]);
+        }
+        if (uvs) {
+            uvs[i * 2 + 0] = HalfToFloat(vert.uv[0]) + uvOffset[0];
+            uvs[i * 2 + 1] = HalfToFloat(vert.uv[1]) + uvOffset[1];
+        }
+    }
+}
+
+bool ChooseCompactUVOffset(const float* uvs, size_t count, float uvOffset[2]) {
+    uvOffset[0] = uvOffset[1] = 0.0f;
+    if (count == 0) return true;
+
+    for (int k = 0; k < 2; k++) {
+        float lower = FLT_MAX, upper = -FLT_MAX;
+        for (size_t i = 0; i < count; i++) {
+            const float uv = uvs[i * 2 + k];
+            if (!std::isfinite(uv)) return false;
+            lower = std::min(lower, uv);
+            upper = std::max(upper, uv);
+        }
+
+        // Whole tiles keep the texture repeat exact after decoding
+        float offset = std::round(0.5f * lower + 0.5f * upper);
+        if (upper - offset > kCompactMaxUVExtent || offset - lower > kCompactMaxUVExtent) return false;
+        uvOffset[k] = offset;
+    }
+    return true;
+}
+
+} // namespace RTXMath
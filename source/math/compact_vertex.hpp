@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Compact world vertex layout: float position, octahedral snorm16 normal and
+// half-float UV, 20 bytes per vertex instead of the 32 used by separate
+// float position/normal/UV streams.
+namespace RTXMath {
+    struct CompactVertex {
+        float pos[3];
+        int16_t normal[2];  // Octahedral encoding, snorm16
+        uint16_t uv[2];     // IEEE 754 binary16
+    };
+    static_assert(sizeof(CompactVertex) == 20, "CompactVertex must stay 20 bytes");
+
+    // Round-to-nearest-even conversion, handles subnormals, inf and NaN
+    uint16_t FloatToHalf(float value);
+    float HalfToFloat(uint16_t value);
+
+    // Unit vector <-> octahedral snorm16; zero vectors decode as +Z
+    void EncodeOctahedral(const float normal[3], int16_t out[2]);
+    void DecodeOctahedral(const int16_t encoded[2], float normal[3]);
+
+    // Bulk kernels over interleaved xyz positions/normals and uv pairs.
+    // uvOffset is subtracted before encoding and added back on decode, so
+    // large tiled coordinates keep half-float precision near zero.
+    void EncodeCompactVertices(const float* positions, const float* normals, const float* uvs,
+                               size_t count, const float uvOffset[2], CompactVertex* out);
+    void DecodeCompactVertices(const CompactVertex* vertices, size_t count, const float uvOffset[2],
+                               float* positions, float* normals, float* uvs);
+
+    // Half floats keep 11 significant bits, so the absolute UV error grows
+    // with distance from the offset. Within kCompactMaxUVExtent tiles of it,
+    // and with offsets under 1024 tiles, the decoded UV stays within
+    // kCompactUVAbsoluteBound tiles: half a texel of a 1024 texture.
+    const float kCompactMaxUVExtent = 1.0f;
+    const double kCompactUVAbsoluteBound = 1.0 / 2048.0;
+
+    // Picks the whole-tile offset nearest the center of the UV bounds.
+    // Returns false when some UV lies further than kCompactMaxUVExtent
+    // from it (or is not finite); such meshes should keep float UVs.
+    bool ChooseCompactUVOffset(const float* uvs, size_t count, float uvOffset[2]);
+}
@@ -0,0 +1,263 @@
+#include "frustum_culling.hpp"
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#define RTX_TARGET_AVX2
+#else
+// Without "fma" in the target GCC cannot fuse the plane tests' multiplies
+// and adds, which would break parity with the scalar path
+#define RTX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace RTXMath {
+
+static CullPlane MakePlane(float nx, float ny, float nz, const float origin[3], float offset) {
+    float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+    if (length > 0.0f) {
+        nx /= length;
+        ny /= length;
+        nz /= length;
+    }
+
+    CullPlane plane;
+    plane.normal[0] = nx;
+    plane.normal[1] = ny;
+    plane.normal[2] = nz;
+    plane.dist = -(nx * origin[0] + ny * origin[1] + nz * origin[2]) - offset;
+    return plane;
+}
+
+ViewFrustum BuildViewFrustum(const float origin[3], const float forward[3], const float right[3],
+                             const float up[3], float fovX, float aspect, float zNear,
+                             float maxDistance) {
+    const float degreesToRadians = 0.017453292519943295f;
+    fovX = std::min(std::max(fovX, 1.0f), 179.0f);
+    aspect = aspect > 0.0f ? aspect : 1.0f;
+
+    // Half-angle slopes of the side planes
+    const float tanX = std::tan(fovX * 0.5f * degreesToRadians);
+    const float tanY = tanX / aspect;
+
+    ViewFrustum frustum;
+    auto sidePlane = [&](float slope, const float axis[3], float sign) {
+        return MakePlane(forward[0] * slope + axis[0] * sign,
+                         forward[1] * slope + axis[1] * sign,
+                         forward[2] * slope + axis[2] * sign, origin, 0.0f);
+    };
+    frustum.planes[0] = sidePlane(tanX, right, 1.0f);   // Left
+    frustum.planes[1] = sidePlane(tanX, right, -1.0f);  // Right
+    frustum.planes[2] = sidePlane(tanY, up, 1.0f);      // Bottom
+    frustum.planes[3] = sidePlane(tanY, up, -1.0f);     // Top
+    frustum.planes[4] = MakePlane(forward[0], forward[1], forward[2], origin, std::max(zNear, 0.0f));
+
+    frustum.origin[0] = origin[0];
+    frustum.origin[1] = origin[1];
+    frustum.origin[2] = origin[2];
+    frustum.maxDistance = maxDistance;
+    return frustum;
+}
+
+uint32_t CullBoxSet::Add(const float mins[3], const float maxs[3]) {
+    uint32_t index = static_cast<uint32_t>(m_centerX.size());
+    m_centerX.push_back((mins[0] + maxs[0]) * 0.5f);
+    m_centerY.push_back((mins[1] + maxs[1]) * 0.5f);
+    m_centerZ.push_back((mins[2] + maxs[2]) * 0.5f);
+    m_extentX.push_back(std::fabs(maxs[0] - mins[0]) * 0.5f);
+    m_extentY.push_back(std::fabs(maxs[1] - mins[1]) * 0.5f);
+    m_extentZ.push_back(std::fabs(maxs[2] - mins[2]) * 0.5f);
+    return index;
+}
+
+void CullBoxSet::Clear() {
+    m_centerX.clear();
+    m_centerY.clear();
+    m_centerZ.clear();
+    m_extentX.clear();
+    m_extentY.clear();
+    m_extentZ.clear();
+}
+
+namespace {
+    const int kPlaneCount = 5;
+
+    // Planes split into components plus their absolute values, which give
+    // the projected radius of a box onto each normal
+    struct PreparedFrustum {
+        float nx[kPlaneCount], ny[kPlaneCount], nz[kPlaneCount], d[kPlaneCount];
+        float ax[kPlaneCount], ay[kPlaneCount], az[kPlaneCount];
+        float ox, oy, oz;
+        float maxDistanceSqr;
+        bool testDistance;
+    };
+
+    PreparedFrustum Prepare(const ViewFrustum& frustum) {
+        PreparedFrustum f;
+        for (int p = 0; p < kPlaneCount; p++) {
+            f.nx[p] = frustum.planes[p].normal[0];
+            f.ny[p] = frustum.planes[p].normal[1];
+            f.nz[p] = frustum.planes[p].normal[2];
+            f.d[p] = frustum.planes[p].dist;
+            f.ax[p] = std::fabs(f.nx[p]);
+            f.ay[p] = std::fabs(f.ny[p]);
+            f.az[p] = std::fabs(f.nz[p]);
+        }
+        f.ox = frustum.origin[0];
+        f.oy = frustum.origin[1];
+        f.oz = frustum.origin[2];
+        f.testDistance = frustum.maxDistance > 0.0f;
+        f.maxDistanceSqr = frustum.maxDistance * frustum.maxDistance;
+        return f;
+    }
+
+    struct BoxArrays {
+        const float *cx, *cy, *cz, *ex, *ey, *ez;
+    };
+}
+
+// Scalar reference kernel
+
+namespace Scalar {
+    static bool IsVisible(const PreparedFrustum& f, const BoxArrays& b, size_t i) {
+        for (int p = 0; p < kPlaneCount; p++) {
+            float dist = f.nx[p] * b.cx[i] + f.ny[p] * b.cy[i] + f.nz[p] * b.cz[i] + f.d[p];
+            float radius = f.ax[p] * b.ex[i] + f.ay[p] * b.ey[i] + f.az[p] * b.ez[i];
+            if (dist + radius < 0.0f) return false;
+        }
+
+        if (f.testDistance) {
+            // Distance from the origin to the nearest point of the box
+            float dx = std::max(std::fabs(b.cx[i] - f.ox) - b.ex[i], 0.0f);
+            float dy = std::max(std::fabs(b.cy[i] - f.oy) - b.ey[i], 0.0f);
+            float dz = std::max(std::fabs(b.cz[i] - f.oz) - b.ez[i], 0.0f);
+            if (dx * dx + dy * dy + dz * dz > f.maxDistanceSqr) return false;
+        }
+        return true;
+    }
+
+    static size_t Cull(const PreparedFrustum& f, const BoxArrays& b, size_t begin, size_t count, uint32_t* out) {
+        size_t visible = 0;
+        for (size_t i = begin; i < count; i++) {
+            out[visible] = static_cast<uint32_t>(i);
+            visible += IsVisible(f, b, i) ? 1 : 0;
+        }
+        return visible;
+    }
+}
+
+// SSE kernel, 4 boxes per iteration
+
+namespace SSE {
+    static size_t Cull(const PreparedFrustum& f, const BoxArrays& b, size_t count, uint32_t* out) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128 ox = _mm_set1_ps(f.ox), oy = _mm_set1_ps(f.oy), oz = _mm_set1_ps(f.oz);
+        const __m128 maxDistanceSqr = _mm_set1_ps(f.maxDistanceSqr);
+
+        size_t visible = 0;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 cx = _mm_loadu_ps(b.cx + i), cy = _mm_loadu_ps(b.cy + i), cz = _mm_loadu_ps(b.cz + i);
+            __m128 ex = _mm_loadu_ps(b.ex + i), ey = _mm_loadu_ps(b.ey + i), ez = _mm_loadu_ps(b.ez + i);
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < kPlaneCount; p++) {
+                __m128 dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(f.nx[p]), cx),
+                                                               _mm_mul_ps(_mm_set1_ps(f.ny[p]), cy)),
+                                                    _mm_mul_ps(_mm_set1_ps(f.nz[p]), cz)),
+                                         _mm_set1_ps(f.d[p]));
+                __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(f.ax[p]), ex),
+                                                      _mm_mul_ps(_mm_set1_ps(f.ay[p]), ey)),
+                                           _mm_mul_ps(_mm_set1_ps(f.az[p]), ez));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, radius), zero));
+            }
+
+            if (f.testDistance) {
+                __m128 dx = _mm_max_ps(_mm_sub_ps(_mm_and_ps(_mm_sub_ps(cx, ox), absMask), ex), zero);
+                __m128 dy = _mm_max_ps(_mm_sub_ps(_mm_and_ps(_mm_sub_ps(cy, oy), absMask), ey), zero);
+                __m128 dz = _mm_max_ps(_mm_sub_ps(_mm_and_ps(_mm_sub_ps(cz, oz), absMask), ez), zero);
+                __m128 distSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                inside = _mm_and_ps(inside, _mm_cmple_ps(distSqr, maxDistanceSqr));
+            }
+
+            int mask = _mm_movemask_ps(inside);
+            for (int k = 0; k < 4; k++) {
+                out[visible] = static_cast<uint32_t>(i + k);
+                visible += (mask >> k) & 1;
+            }
+        }
+
+        return visible + Scalar::Cull(f, b, i, count, out + visible);
+    }
+}
+
+// AVX2 kernel, 8 boxes per iteration
+
+namespace AVX2 {
+    RTX_TARGET_AVX2 static size_t Cull(const PreparedFrustum& f, const BoxArrays& b, size_t count, uint32_t* out) {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        const __m256 ox = _mm256_set1_ps(f.ox), oy = _mm256_set1_ps(f.oy), oz = _mm256_set1_ps(f.oz);
+        const __m256 maxDistanceSqr = _mm256_set1_ps(f.maxDistanceSqr);
+
+        size_t visible = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 cx = _mm256_loadu_ps(b.cx + i), cy = _mm256_loadu_ps(b.cy + i), cz = _mm256_loadu_ps(b.cz + i);
+            __m256 ex = _mm256_loadu_ps(b.ex + i), ey = _mm256_loadu_ps(b.ey + i), ez = _mm256_loadu_ps(b.ez + i);
+
+            // Separate multiplies and adds (no FMA) keep results identical to the scalar path
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int p = 0; p < kPlaneCount; p++) {
+                __m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(f.nx[p]), cx),
+                                                                        _mm256_mul_ps(_mm256_set1_ps(f.ny[p]), cy)),
+                                                          _mm256_mul_ps(_mm256_set1_ps(f.nz[p]), cz)),
+                                            _mm256_set1_ps(f.d[p]));
+                __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(f.ax[p]), ex),
+                                                            _mm256_mul_ps(_mm256_set1_ps(f.ay[p]), ey)),
+                                              _mm256_mul_ps(_mm256_set1_ps(f.az[p]), ez));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(dist, radius), zero, _CMP_GE_OQ));
+            }
+
+            if (f.testDistance) {
+                __m256 dx = _mm256_max_ps(_mm256_sub_ps(_mm256_and_ps(_mm256_sub_ps(cx, ox), absMask), ex), zero);
+                __m256 dy = _mm256_max_ps(_mm256_sub_ps(_mm256_and_ps(_mm256_sub_ps(cy, oy), absMask), ey), zero);
+                __m256 dz = _mm256_max_ps(_mm256_sub_ps(_mm256_and_ps(_mm256_sub_ps(cz, oz), absMask), ez), zero);
+                __m256 distSqr = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                                               _mm256_mul_ps(dz, dz));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distSqr, maxDistanceSqr, _CMP_LE_OQ));
+            }
+
+            int mask = _mm256_movemask_ps(inside);
+            for (int k = 0; k < 8; k++) {
+                out[visible] = static_cast<uint32_t>(i + k);
+                visible += (mask >> k) & 1;
+            }
+        }
+
+        return visible + Scalar::Cull(f, b, i, count, out + visible);
+    }
+}
+
+// Dispatch
+
+size_t CullBoxes(const CullBoxSet& boxes, const ViewFrustum& frustum, uint32_t* out) {
+    return CullBoxes(boxes, frustum, out, GetVertexKernels().level);
+}
+
+size_t CullBoxes(const CullBoxSet& boxes, const ViewFrustum& frustum, uint32_t* out, SimdLevel level) {
+    const PreparedFrustum f = Prepare(frustum);
+    const BoxArrays b = {boxes.CenterX(), boxes.CenterY(), boxes.CenterZ(),
+                         boxes.ExtentX(), boxes.ExtentY(), boxes.ExtentZ()};
+    const size_t count = boxes.Size();
+
+    // GetVertexKernels clamps the requested level to what the CPU supports
+    switch (GetVertexKernels(level).level) {
+        case SimdLevel::AVX2: return AVX2::Cull(f, b, count, out);
+        case SimdLevel::SSE: return SSE::Cull(f, b, count, out);
+        default: return Scalar::Cull(f, b, 0, count, out);
+    }
+}
+
+} // namespace RTXMath
@@ -0,0 +1,56 @@
+#pragma once
+#include "vertex_kernels.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// View frustum and distance culling of axis-aligned boxes stored as
+// structure-of-arrays, with the same scalar/SSE/AVX2 dispatch as the vertex
+// kernels. Every level returns exactly the same visible set.
+namespace RTXMath {
+    // A point p is inside when dot(normal, p) + dist >= 0
+    struct CullPlane {
+        float normal[3];
+        float dist;
+    };
+
+    struct ViewFrustum {
+        CullPlane planes[5];  // Left, right, bottom, top, near
+        float origin[3];
+        float maxDistance;    // <= 0 disables the distance test
+    };
+
+    // fovX is the full horizontal field of view in degrees and aspect is
+    // width / height. forward/right/up must be an orthonormal view basis.
+    ViewFrustum BuildViewFrustum(const float origin[3], const float forward[3], const float right[3],
+                                 const float up[3], float fovX, float aspect, float zNear,
+                                 float maxDistance);
+
+    // Boxes kept as centers and half extents, one array per component
+    class CullBoxSet {
+    public:
+        // Returns the 0-based index of the new box
+        uint32_t Add(const float mins[3], const float maxs[3]);
+        void Clear();
+        size_t Size() const { return m_centerX.size(); }
+
+        const float* CenterX() const { return m_centerX.data(); }
+        const float* CenterY() const { return m_centerY.data(); }
+        const float* CenterZ() const { return m_centerZ.data(); }
+        const float* ExtentX() const { return m_extentX.data(); }
+        const float* ExtentY() const { return m_extentY.data(); }
+        const float* ExtentZ() const { return m_extentZ.data(); }
+
+    private:
+        std::vector<float> m_centerX, m_centerY, m_centerZ;
+        std::vector<float> m_extentX, m_extentY, m_extentZ;
+    };
+
+    // Writes the indices of boxes that touch the frustum (and lie within
+    // maxDistance of the origin) to out in ascending order and returns how
+    // many there are. out must have room for boxes.Size() entries. The test
+    // is conservative: a box is only rejected when it is fully outside one plane.
+    size_t CullBoxes(const CullBoxSet& boxes, const ViewFrustum& frustum, uint32_t* out);
+    // Same, at a specific level clamped to what the CPU supports
+    size_t CullBoxes(const CullBoxSet& boxes, const ViewFrustum& frustum, uint32_t* out, SimdLevel level);
+}
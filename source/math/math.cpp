@@ -1,4 +1,11 @@
 #include "math.hpp"
+#include "chunk_key.hpp"
+#include "vertex_kernels.hpp"
+#include "compact_vertex.hpp"
+#include "spatial_buckets.hpp"
+#include "spatial_grid.hpp"
+#include "point_kernels.hpp"
+#include "lua_util.hpp"
 #include "mathlib/vector.h"
 
 using namespace GarrysMod::Lua;
@@ -38,10 +45,6 @@ bool IsWithinBounds(const Vector3& point, const Vector3& mins, const Vector3& ma
            point.z >= mins.z && point.z <= maxs.z;
 }
 
-int64_t GenerateChunkKey(int x, int y, int z) {
-    return ((int64_t)x << 42) | ((int64_t)y << 21) | (int64_t)z;
-}
-
 Vector3 ComputeNormal(const Vector3& v1, const Vector3& v2, const Vector3& v3) {
     Vector3 a = {v2.x - v1.x, v2.y - v1.y, v2.z - v1.z};
     Vector3 b = {v3.x - v1.x, v3.y - v1.y, v3.z - v1.z};
@@ -167,13 +170,20 @@ LUA_FUNCTION(IsWithinBounds_Native) {
     return 1;
 }
 
+// PackChunkKey for Lua; coordinates outside the key range are an error
+// rather than sharing the edge cell's key
 LUA_FUNCTION(GenerateChunkKey_Native) {
-    int x = LUA->CheckNumber(1);
-    int y = LUA->CheckNumber(2);
-    int z = LUA->CheckNumber(3);
-    
-    int64_t key = GenerateChunkKey(x, y, z);
-    
+    int32_t coords[3];
+    for (int i = 0; i < 3; i++) {
+        double value = LUA->CheckNumber(i + 1);
+        if (!(value >= kMinChunkCoord && value <= kMaxChunkCoord)) {
+            LUA->ArgError(i + 1, "chunk coordinate out of range");
+        }
+        coords[i] = static_cast<int32_t>(std::floor(value));
+    }
+
+    int64_t key = PackChunkKey(coords[0], coords[1], coords[2]);
+
     LUA->PushNumber(static_cast<double>(key));
     return 1;
 }
@@ -204,6 +214,118 @@ LUA_FUNCTION(ComputeNormal_Native) {
     return 1;
 }
 
+// Groups points by cell in one call. Takes an array of Vectors and a cell
+// size; returns the point indices grouped by cell, each bucket's key and the
+// start of each bucket in that order (plus one past the last), all 1-based.
+// Bucket b spans order[starts[b]] .. order[starts[b + 1] - 1].
+LUA_FUNCTION(BucketPoints_Native) {
+    LUA->CheckType(1, Type::Table);
+    float cellSize = static_cast<float>(LUA->CheckNumber(2));
+
+    size_t count = LUA->ObjLen(1);
+    std::vector<float> points(count * 3, NAN);
+    for (size_t i = 0; i < count; i++) {
+        LUA->PushNumber(static_cast<double>(i + 1));
+        LUA->GetTable(1);
+        if (LUA->IsType(-1, Type::Vector)) {
+            const Vector& p = *LUA->GetUserType<Vector>(-1, Type::Vector);
+            points[i * 3 + 0] = p.x;
+            points[i * 3 + 1] = p.y;
+            points[i * 3 + 2] = p.z;
+        }
+        LUA->Pop();
+    }
+
+    BucketResult result;
+    BucketPointsByCell(points.data(), count, cellSize, result);
+
+    LUA->CreateTable();
+    for (size_t i = 0; i < result.order.size(); i++) {
+        LUA->PushNumber(static_cast<double>(i + 1));
+        LUA->PushNumber(result.order[i] + 1.0);
+        LUA->SetTable(-3);
+    }
+
+    LUA->CreateTable();
+    for (size_t b = 0; b < result.buckets.size(); b++) {
+        LUA->PushNumber(static_cast<double>(b + 1));
+        LUA->PushNumber(static_cast<double>(result.buckets[b].key));
+        LUA->SetTable(-3);
+    }
+
+    LUA->CreateTable();
+    for (size_t b = 0; b < result.buckets.size(); b++) {
+        LUA->PushNumber(static_cast<double>(b + 1));
+        LUA->PushNumber(result.buckets[b].first + 1.0);
+        LUA->SetTable(-3);
+    }
+    LUA->PushNumber(static_cast<double>(result.buckets.size() + 1));
+    LUA->PushNumber(result.order.size() + 1.0);
+    LUA->SetTable(-3);
+
+    return 3;
+}
+
+// Reads an array of Vectors into separate x/y/z arrays; entries that are
+// not Vectors become NaN and never match
+static size_t ReadPointArrays(ILuaBase* LUA, int stackPos, std::vector<float>& x, std::vector<float>& y,
+                              std::vector<float>& z) {
+    size_t count = LUA->ObjLen(stackPos);
+    x.assign(count, NAN);
+    y.assign(count, NAN);
+    z.assign(count, NAN);
+    for (size_t i = 0; i < count; i++) {
+        LUA->PushNumber(static_cast<double>(i + 1));
+        LUA->GetTable(stackPos);
+        if (LUA->IsType(-1, Type::Vector)) {
+            const Vector& p = *LUA->GetUserType<Vector>(-1, Type::Vector);
+            x[i] = p.x;
+            y[i] = p.y;
+            z[i] = p.z;
+        }
+        LUA->Pop();
+    }
+    return count;
+}
+
+// Pushes the 1-based indices of the first hitCount hits (into the table at
+// outStackPos when there is one) and the count
+static int PushPointIndices(ILuaBase* LUA, const std::vector<uint32_t>& hits, size_t hitCount, int outStackPos) {
+    LuaUtil::PushNumberList(LUA, hitCount, outStackPos, [&](size_t i) { return hits[i] + 1.0; });
+    LUA->PushNumber(static_cast<double>(hitCount));
+    return 2;
+}
+
+// PointsInSphere(points, center, radius[, out]) -> indices, count
+LUA_FUNCTION(PointsInSphere_Native) {
+    LUA->CheckType(1, Type::Table);
+    float center[3];
+    LuaUtil::CheckVector(LUA, 2, center);
+    float radius = static_cast<float>(LUA->CheckNumber(3));
+
+    std::vector<float> x, y, z;
+    size_t count = ReadPointArrays(LUA, 1, x, y, z);
+
+    std::vector<uint32_t> hits(count);
+    size_t hitCount = SelectPointsInSphere(x.data(), y.data(), z.data(), count, center, radius, hits.data());
+    return PushPointIndices(LUA, hits, hitCount, 4);
+}
+
+// PointsInBox(points, mins, maxs[, out]) -> indices, count
+LUA_FUNCTION(PointsInBox_Native) {
+    LUA->CheckType(1, Type::Table);
+    float mins[3], maxs[3];
+    LuaUtil::CheckVector(LUA, 2, mins);
+    LuaUtil::CheckVector(LUA, 3, maxs);
+
+    std::vector<float> x, y, z;
+    size_t count = ReadPointArrays(LUA, 1, x, y, z);
+
+    std::vector<uint32_t> hits(count);
+    size_t hitCount = SelectPointsInBox(x.data(), y.data(), z.data(), count, mins, maxs, hits.data());
+    return PushPointIndices(LUA, hits, hitCount, 4);
+}
+
 void Initialize(ILuaBase* LUA) {
     LUA->CreateTable();
     
@@ -230,6 +352,15 @@ void Initialize(ILuaBase* LUA) {
     
     LUA->PushCFunction(MultiplyVector_Native);
     LUA->SetField(-2, "MultiplyVector");
+
+    LUA->PushCFunction(BucketPoints_Native);
+    LUA->SetField(-2, "BucketPoints");
+
+    LUA->PushCFunction(PointsInSphere_Native);
+    LUA->SetField(-2, "PointsInSphere");
+
+    LUA->PushCFunction(PointsInBox_Native);
+    LUA->SetField(-2, "PointsInBox");
     
     LUA->SetField(-2, "RTXMath");
 }
@@ -0,0 +1,229 @@
+#include "point_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#define RTX_TARGET_AVX2
+#else
+// avx2 only: enabling fma lets the compiler contract the distance sums
+#define RTX_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace RTXMath {
+
+namespace {
+    struct PointArrays {
+        const float *x, *y, *z;
+    };
+
+    struct Sphere {
+        float cx, cy, cz, radiusSqr;
+    };
+
+    struct Box {
+        float minX, minY, minZ, maxX, maxY, maxZ;
+    };
+
+    // One of out/mask is null. SIMD blocks start at multiples of 8 (or 4),
+    // so a block's bits never straddle two mask words.
+    inline size_t Emit(int bits, int width, size_t first, uint32_t* out, uint64_t* mask, size_t hits) {
+        if (mask) {
+            mask[first >> 6] |= static_cast<uint64_t>(bits) << (first & 63);
+            for (int k = 0; k < width; k++) hits += (bits >> k) & 1;
+            return hits;
+        }
+        if (width > 1 && bits == 0) return hits;  // Most blocks of a small query are empty
+        for (int k = 0; k < width; k++) {
+            out[hits] = static_cast<uint32_t>(first + k);
+            hits += (bits >> k) & 1;
+        }
+        return hits;
+    }
+
+    Sphere MakeSphere(const float center[3], float radius) {
+        // A negative or NaN radius matches nothing, like an empty box
+        float radiusSqr = radius >= 0.0f ? radius * radius : -1.0f;
+        return {center[0], center[1], center[2], radiusSqr};
+    }
+
+    Box MakeBox(const float mins[3], const float maxs[3]) {
+        return {mins[0], mins[1], mins[2], maxs[0], maxs[1], maxs[2]};
+    }
+}
+
+// Scalar reference kernels
+
+namespace Scalar {
+    static size_t InSphere(const PointArrays& p, size_t begin, size_t count, const Sphere& s,
+                           uint32_t* out, uint64_t* mask, size_t hits) {
+        for (size_t i = begin; i < count; i++) {
+            float dx = p.x[i] - s.cx;
+            float dy = p.y[i] - s.cy;
+            float dz = p.z[i] - s.cz;
+            bool inside = dx * dx + dy * dy + dz * dz <= s.radiusSqr;
+            hits = Emit(inside ? 1 : 0, 1, i, out, mask, hits);
+        }
+        return hits;
+    }
+
+    static size_t InBox(const PointArrays& p, size_t begin, size_t count, const Box& b,
+                        uint32_t* out, uint64_t* mask, size_t hits) {
+        for (size_t i = begin; i < count; i++) {
+            bool inside = p.x[i] >= b.minX && p.x[i] <= b.maxX &&
+                          p.y[i] >= b.minY && p.y[i] <= b.maxY &&
+                          p.z[i] >= b.minZ && p.z[i] <= b.maxZ;
+            hits = Emit(inside ? 1 : 0, 1, i, out, mask, hits);
+        }
+        return hits;
+    }
+}
+
+// SSE kernels, 4 points per iteration
+
+namespace SSE {
+    static size_t InSphere(const PointArrays& p, size_t count, const Sphere& s, uint32_t* out, uint64_t* mask) {
+        const __m128 cx = _mm_set1_ps(s.cx), cy = _mm_set1_ps(s.cy), cz = _mm_set1_ps(s.cz);
+        const __m128 radiusSqr = _mm_set1_ps(s.radiusSqr);
+
+        size_t hits = 0;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(p.x + i), cx);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(p.y + i), cy);
+            __m128 dz = _mm_sub_ps(_mm_loadu_ps(p.z + i), cz);
+            __m128 distSqr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            hits = Emit(_mm_movemask_ps(_mm_cmple_ps(distSqr, radiusSqr)), 4, i, out, mask, hits);
+        }
+        return Scalar::InSphere(p, i, count, s, out, mask, hits);
+    }
+
+    static size_t InBox(const PointArrays& p, size_t count, const Box& b, uint32_t* out, uint64_t* mask) {
+        const __m128 minX = _mm_set1_ps(b.minX), minY = _mm_set1_ps(b.minY), minZ = _mm_set1_ps(b.minZ);
+        const __m128 maxX = _mm_set1_ps(b.maxX), maxY = _mm_set1_ps(b.maxY), maxZ = _mm_set1_ps(b.maxZ);
+
+        size_t hits = 0;
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(p.x + i), y = _mm_loadu_ps(p.y + i), z = _mm_loadu_ps(p.z + i);
+            __m128 inside = _mm_and_ps(_mm_cmpge_ps(x, minX), _mm_cmple_ps(x, maxX));
+            inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(y, minY), _mm_cmple_ps(y, maxY)));
+            inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(z, minZ), _mm_cmple_ps(z, maxZ)));
+            hits = Emit(_mm_movemask_ps(inside), 4, i, out, mask, hits);
+        }
+        return Scalar::InBox(p, i, count, b, out, mask, hits);
+    }
+}
+
+// AVX2 kernels, 8 points per iteration
+
+namespace AVX2 {
+    RTX_TARGET_AVX2 static size_t InSphere(const PointArrays& p, size_t count, const Sphere& s,
+                                           uint32_t* out, uint64_t* mask) {
+        const __m256 cx = _mm256_set1_ps(s.cx), cy = _mm256_set1_ps(s.cy), cz = _mm256_set1_ps(s.cz);
+        const __m256 radiusSqr = _mm256_set1_ps(s.radiusSqr);
+
+        size_t hits = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(p.x + i), cx);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(p.y + i), cy);
+            __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(p.z + i), cz);
+            // Separate multiplies and adds (no FMA) keep results identical to the scalar path
+            __m256 distSqr = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                                           _mm256_mul_ps(dz, dz));
+            hits = Emit(_mm256_movemask_ps(_mm256_cmp_ps(distSqr, radiusSqr, _CMP_LE_OQ)), 8, i, out, mask, hits);
+        }
+        return Scalar::InSphere(p, i, count, s, out, mask, hits);
+    }
+
+    RTX_TARGET_AVX2 static size_t InBox(const PointArrays& p, size_t count, const Box& b,
+                                        uint32_t* out, uint64_t* mask) {
+        const __m256 minX = _mm256_set1_ps(b.minX), minY = _mm256_set1_ps(b.minY), minZ = _mm256_set1_ps(b.minZ);
+        const __m256 maxX = _mm256_set1_ps(b.maxX), maxY = _mm256_set1_ps(b.maxY), maxZ = _mm256_set1_ps(b.maxZ);
+
+        size_t hits = 0;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 x = _mm256_loadu_ps(p.x + i), y = _mm256_loadu_ps(p.y + i), z = _mm256_loadu_ps(p.z + i);
+            __m256 inside = _mm256_and_ps(_mm256_cmp_ps(x, minX, _CMP_GE_OQ), _mm256_cmp_ps(x, maxX, _CMP_LE_OQ));
+            inside = _mm256_and_ps(inside, _mm256_and_ps(_mm256_cmp_ps(y, minY, _CMP_GE_OQ),
+                                                         _mm256_cmp_ps(y, maxY, _CMP_LE_OQ)));
+            inside = _mm256_and_ps(inside, _mm256_and_ps(_mm256_cmp_ps(z, minZ, _CMP_GE_OQ),
+                                                         _mm256_cmp_ps(z, maxZ, _CMP_LE_OQ)));
+            hits = Emit(_mm256_movemask_ps(inside), 8, i, out, mask, hits);
+        }
+        return Scalar::InBox(p, i, count, b, out, mask, hits);
+    }
+}
+
+// Dispatch
+
+static size_t RunSphere(const float* x, const float* y, const float* z, size_t count, const float center[3],
+                        float radius, uint32_t* out, uint64_t* mask, SimdLevel level) {
+    const PointArrays p = {x, y, z};
+    const Sphere s = MakeSphere(center, radius);
+    if (mask) std::fill(mask, mask + (count + 63) / 64, 0ull);
+
+    // GetVertexKernels clamps the requested level to what the CPU supports
+    switch (GetVertexKernels(level).level) {
+        case SimdLevel::AVX2: return AVX2::InSphere(p, count, s, out, mask);
+        case SimdLevel::SSE: return SSE::InSphere(p, count, s, out, mask);
+        default: return Scalar::InSphere(p, 0, count, s, out, mask, 0);
+    }
+}
+
+static size_t RunBox(const float* x, const float* y, const float* z, size_t count, const float mins[3],
+                     const float maxs[3], uint32_t* out, uint64_t* mask, SimdLevel level) {
+    const PointArrays p = {x, y, z};
+    const Box b = MakeBox(mins, maxs);
+    if (mask) std::fill(mask, mask + (count + 63) / 64, 0ull);
+
+    switch (GetVertexKernels(level).level) {
+        case SimdLevel::AVX2: return AVX2::InBox(p, count, b, out, mask);
+        case SimdLevel::SSE: return SSE::InBox(p, count, b, out, mask);
+        default: return Scalar::InBox(p, 0, count, b, out, mask, 0);
+    }
+}
+
+size_t SelectPointsInSphere(const float* x, const float* y, const float* z, size_t count,
+                            const float center[3], float radius, uint32_t* out, SimdLevel level) {
+    return RunSphere(x, y, z, count, center, radius, out, nullptr, level);
+}
+
+size_t SelectPointsInBox(const float* x, const float* y, const float* z, size_t count,
+                         const float mins[3], const float maxs[3], uint32_t* out, SimdLevel level) {
+    return RunBox(x, y, z, count, mins, maxs, out, nullptr, level);
+}
+
+size_t MaskPointsInSphere(const float* x, const float* y, const float* z, size_t count,
+                          const float center[3], float radius, uint64_t* mask, SimdLevel level) {
+    return RunSphere(x, y, z, count, center, radius, nullptr, mask, level);
+}
+
+size_t MaskPointsInBox(const float* x, const float* y, const float* z, size_t count,
+                       const float mins[3], const float maxs[3], uint64_t* mask, SimdLevel level) {
+    return RunBox(x, y, z, count, mins, maxs, nullptr, mask, level);
+}
+
+size_t SelectPointsInSphere(const float* x, const float* y, const float* z, size_t count,
+                            const float center[3], float radius, uint32_t* out) {
+    return SelectPointsInSphere(x, y, z, count, center, radius, out, GetVertexKernels().level);
+}
+
+size_t SelectPointsInBox(const float* x, const float* y, const float* z, size_t count,
+                         const float mins[3], const float maxs[3], uint32_t* out) {
+    return SelectPointsInBox(x, y, z, count, mins, maxs, out, GetVertexKernels().level);
+}
+
+size_t MaskPointsInSphere(const float* x, const float* y, const float* z, size_t count,
+                          const float center[3], float radius, uint64_t* mask) {
+    return MaskPointsInSphere(x, y, z, count, center, radius, mask, GetVertexKernels().level);
+}
+
+size_t MaskPointsInBox(const float* x, const float* y, const float* z, size_t count,
+                       const float mins[3], const float maxs[3], uint64_t* mask) {
+    return MaskPointsInBox(x, y, z, count, mins, maxs, mask, GetVertexKernels().level);
+}
+
+} // namespace RTXMath
@@ -0,0 +1,37 @@
+#pragma once
+#include "vertex_kernels.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Batched containment tests of structure-of-arrays points against a sphere
+// or an axis-aligned box, with the same scalar/SSE/AVX2 dispatch as the
+// vertex kernels (4 points per SSE and 8 per AVX2 iteration). Both tests
+// are inclusive: points on the sphere or on a box face count as inside.
+// Every level returns exactly the same set; non-finite points are outside.
+namespace RTXMath {
+    // Writes the indices of points within radius of center to out in
+    // ascending order and returns how many there are. out must have room
+    // for count entries.
+    size_t SelectPointsInSphere(const float* x, const float* y, const float* z, size_t count,
+                                const float center[3], float radius, uint32_t* out);
+    size_t SelectPointsInBox(const float* x, const float* y, const float* z, size_t count,
+                             const float mins[3], const float maxs[3], uint32_t* out);
+
+    // Same tests as a bitmask: bit i % 64 of mask[i / 64] is set for an
+    // inside point. mask must have room for (count + 63) / 64 words.
+    // Returns the number of set bits.
+    size_t MaskPointsInSphere(const float* x, const float* y, const float* z, size_t count,
+                              const float center[3], float radius, uint64_t* mask);
+    size_t MaskPointsInBox(const float* x, const float* y, const float* z, size_t count,
+                           const float mins[3], const float maxs[3], uint64_t* mask);
+
+    // Same, at a specific level clamped to what the CPU supports
+    size_t SelectPointsInSphere(const float* x, const float* y, const float* z, size_t count,
+                                const float center[3], float radius, uint32_t* out, SimdLevel level);
+    size_t SelectPointsInBox(const float* x, const float* y, const float* z, size_t count,
+                             const float mins[3], const float maxs[3], uint32_t* out, SimdLevel level);
+    size_t MaskPointsInSphere(const float* x, const float* y, const float* z, size_t count,
+                              const float center[3], float radius, uint64_t* mask, SimdLevel level);
+    size_t MaskPointsInBox(const float* x, const float* y, const float* z, size_t count,
+                           const float mins[3], const float maxs[3], uint64_t* mask, SimdLevel level);
+}
@@ -0,0 +1,58 @@
+#include "radix_sort.hpp"
+#include <algorithm>
+
+namespace RTXMath {
+
+void RadixSort64(uint64_t* keys, uint32_t* values, size_t count,
+                 std::vector<uint64_t>& keyScratch, std::vector<uint32_t>& valueScratch) {
+    if (count < 2) return;
+
+    // One histogram per byte, built in a single pass over the keys
+    size_t histograms[8][256] = {};
+    for (size_t i = 0; i < count; i++) {
+        uint64_t key = keys[i];
+        for (int pass = 0; pass < 8; pass++) {
+            histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    keyScratch.resize(count);
+    valueScratch.resize(count);
+
+    uint64_t* srcKeys = keys;
+    uint32_t* srcValues = values;
+    uint64_t* dstKeys = keyScratch.data();
+    uint32_t* dstValues = valueScratch.data();
+
+    for (int pass = 0; pass < 8; pass++) {
+        size_t* histogram = histograms[pass];
+        const int shift = pass * 8;
+
+        // Every key shares this byte, so the pass would not move anything
+        if (histogram[(srcKeys[0] >> shift) & 0xFF] == count) continue;
+
+        size_t offset = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            size_t bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            size_t slot = histogram[(srcKeys[i] >> shift) & 0xFF]++;
+            dstKeys[slot] = srcKeys[i];
+            dstValues[slot] = srcValues[i];
+        }
+
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcValues, dstValues);
+    }
+
+    // An odd number of executed passes leaves the result in the scratch buffers
+    if (srcKeys != keys) {
+        std::copy(srcKeys, srcKeys + count, keys);
+        std::copy(srcValues, srcValues + count, values);
+    }
+}
+
+} // namespace RTXMath
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace RTXMath {
+    // Stable LSD radix sort of 64-bit keys carrying a 32-bit value each,
+    // 8 bits per pass. Passes where every key has the same byte are skipped,
+    // so keys that only use their low bits cost proportionally less.
+    // The scratch vectors are resized as needed and can be reused across calls.
+    void RadixSort64(uint64_t* keys, uint32_t* values, size_t count,
+                     std::vector<uint64_t>& keyScratch, std::vector<uint32_t>& valueScratch);
+
+    // Order-preserving mapping of a float onto an unsigned integer
+    inline uint32_t FloatToSortableBits(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+}
@@ -0,0 +1,48 @@
+#include "spatial_buckets.hpp"
+#include "chunk_key.hpp"
+#include "radix_sort.hpp"
+#include <cmath>
+
+namespace RTXMath {
+
+void BucketPointsByCell(const float* points, size_t count, float cellSize, BucketResult& out) {
+    out.order.clear();
+    out.buckets.clear();
+    out.skipped = 0;
+
+    const float inverseCell = cellSize > 0.0f ? 1.0f / cellSize : 1.0f;
+
+    std::vector<uint64_t> keys;
+    keys.reserve(count);
+    out.order.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const float* p = points + i * 3;
+        int32_t x, y, z;
+        if (!ToChunkCoord(p[0], inverseCell, x) || !ToChunkCoord(p[1], inverseCell, y) ||
+            !ToChunkCoord(p[2], inverseCell, z)) {
+            out.skipped++;
+            continue;
+        }
+        keys.push_back(static_cast<uint64_t>(PackChunkKey(x, y, z)));
+        out.order.push_back(static_cast<uint32_t>(i));
+    }
+
+    std::vector<uint64_t> keyScratch;
+    std::vector<uint32_t> orderScratch;
+    RadixSort64(keys.data(), out.order.data(), keys.size(), keyScratch, orderScratch);
+
+    for (size_t i = 0; i < keys.size();) {
+        size_t end = i + 1;
+        while (end < keys.size() && keys[end] == keys[i]) end++;
+
+        CellBucket bucket;
+        bucket.key = static_cast<int64_t>(keys[i]);
+        UnpackChunkKey(bucket.key, bucket.x, bucket.y, bucket.z);
+        bucket.first = static_cast<uint32_t>(i);
+        bucket.count = static_cast<uint32_t>(end - i);
+        out.buckets.push_back(bucket);
+        i = end;
+    }
+}
+
+} // namespace RTXMath
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace RTXMath {
+    // One run of points sharing a cell; first/count index BucketResult::order
+    struct CellBucket {
+        int64_t key;  // PackChunkKey of the cell
+        int32_t x, y, z;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    struct BucketResult {
+        std::vector<uint32_t> order;       // Point indices grouped by cell
+        std::vector<CellBucket> buckets;   // Sorted by key, i.e. by x, y, z
+        size_t skipped = 0;                // Non-finite and out-of-range points left out
+    };
+
+    // Groups points (xyz floats each) by the cubic cell of size cellSize that
+    // contains them: one packed integer key per point, then a radix sort
+    // instead of a hash table of per-cell lists. Points keep their input
+    // order within a bucket.
+    void BucketPointsByCell(const float* points, size_t count, float cellSize, BucketResult& out);
+}
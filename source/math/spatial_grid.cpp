@@ -0,0 +1,254 @@
+#include "spatial_grid.hpp"
+#include "chunk_key.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <queue>
+#include <utility>
+
+namespace RTXMath {
+
+// The grid's own key range. Unlike bucketing, the grid may fold far points
+// into the edge cells: queries clamp their cell range the same way and test
+// every candidate's exact position, so results stay exact.
+static const int32_t kMinCell = kMinChunkCoord;
+static const int32_t kMaxCell = kMaxChunkCoord;
+
+void SpatialGrid::SetCellSize(float cellSize) {
+    m_cellSize = cellSize > 0.0f && std::isfinite(cellSize) ? cellSize : 1024.0f;
+    m_inverseCell = 1.0f / m_cellSize;
+    Clear();
+}
+
+void SpatialGrid::Clear() {
+    m_cells.clear();
+    m_entries.clear();
+    m_count = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        m_occupiedMin[axis] = kMaxCell;
+        m_occupiedMax[axis] = kMinCell;
+    }
+}
+
+int32_t SpatialGrid::CellCoord(float value) const {
+    float cell = std::floor(value * m_inverseCell);
+    return static_cast<int32_t>(std::clamp(cell, static_cast<float>(kMinCell), static_cast<float>(kMaxCell)));
+}
+
+void SpatialGrid::RemoveFromCell(uint32_t id) {
+    Entry& entry = m_entries[id];
+    auto it = m_cells.find(entry.cell);
+    std::vector<uint32_t>& ids = it->second;
+
+    uint32_t moved = ids.back();
+    ids[entry.slot] = moved;
+    m_entries[moved].slot = entry.slot;
+    ids.pop_back();
+    if (ids.empty()) m_cells.erase(it);
+
+    entry.slot = kNoSlot;
+}
+
+void SpatialGrid::Update(uint32_t id, float x, float y, float z) {
+    if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z)) {
+        Remove(id);
+        return;
+    }
+
+    if (id >= m_entries.size()) m_entries.resize(static_cast<size_t>(id) + 1);
+    Entry& entry = m_entries[id];
+
+    const int32_t cx = CellCoord(x), cy = CellCoord(y), cz = CellCoord(z);
+    const int64_t cell = PackChunkKey(cx, cy, cz);
+    entry.x = x;
+    entry.y = y;
+    entry.z = z;
+
+    if (entry.slot != kNoSlot) {
+        if (entry.cell == cell) return;
+        RemoveFromCell(id);
+    } else {
+        m_count++;
+    }
+
+    std::vector<uint32_t>& ids = m_cells[cell];
+    entry.cell = cell;
+    entry.slot = static_cast<uint32_t>(ids.size());
+    ids.push_back(id);
+
+    const int32_t coords[3] = {cx, cy, cz};
+    for (int axis = 0; axis < 3; axis++) {
+        m_occupiedMin[axis] = std::min(m_occupiedMin[axis], coords[axis]);
+        m_occupiedMax[axis] = std::max(m_occupiedMax[axis], coords[axis]);
+    }
+}
+
+bool SpatialGrid::Remove(uint32_t id) {
+    if (!Contains(id)) return false;
+    RemoveFromCell(id);
+    m_count--;
+    return true;
+}
+
+template<typename Visit>
+void SpatialGrid::ForEachCell(const int32_t lo[3], const int32_t hi[3], Visit&& visit) const {
+    int32_t from[3], to[3];
+    uint64_t volume = 1;
+    for (int axis = 0; axis < 3; axis++) {
+        from[axis] = std::max(lo[axis], m_occupiedMin[axis]);
+        to[axis] = std::min(hi[axis], m_occupiedMax[axis]);
+        if (from[axis] > to[axis]) return;
+        volume *= static_cast<uint64_t>(to[axis] - from[axis] + 1);
+    }
+
+    // A range wider than the occupied cell count is cheaper to answer by
+    // walking the occupied cells than by probing the hash per coordinate
+    if (volume > m_cells.size()) {
+        for (const auto& [key, ids] : m_cells) {
+            int32_t x, y, z;
+            UnpackChunkKey(key, x, y, z);
+            if (x >= from[0] && x <= to[0] && y >= from[1] && y <= to[1] && z >= from[2] && z <= to[2]) {
+                visit(ids);
+            }
+        }
+        return;
+    }
+
+    for (int32_t x = from[0]; x <= to[0]; x++) {
+        for (int32_t y = from[1]; y <= to[1]; y++) {
+            for (int32_t z = from[2]; z <= to[2]; z++) {
+                auto it = m_cells.find(PackChunkKey(x, y, z));
+                if (it != m_cells.end()) visit(it->second);
+            }
+        }
+    }
+}
+
+void SpatialGrid::QueryRadius(const float center[3], float radius, std::vector<uint32_t>& ids) const {
+    ids.clear();
+    if (m_count == 0 || !(radius >= 0.0f)) return;
+
+    const float radiusSqr = radius * radius;
+    int32_t lo[3], hi[3];
+    for (int axis = 0; axis < 3; axis++) {
+        lo[axis] = CellCoord(center[axis] - radius);
+        hi[axis] = CellCoord(center[axis] + radius);
+    }
+
+    ForEachCell(lo, hi, [&](const std::vector<uint32_t>& cell) {
+        for (uint32_t id : cell) {
+            const Entry& entry = m_entries[id];
+            float dx = entry.x - center[0];
+            float dy = entry.y - center[1];
+            float dz = entry.z - center[2];
+            if (dx * dx + dy * dy + dz * dz <= radiusSqr) ids.push_back(id);
+        }
+    });
+}
+
+void SpatialGrid::QueryBox(const float mins[3], const float maxs[3], std::vector<uint32_t>& ids) const {
+    ids.clear();
+    if (m_count == 0) return;
+
+    int32_t lo[3], hi[3];
+    for (int axis = 0; axis < 3; axis++) {
+        lo[axis] = CellCoord(mins[axis]);
+        hi[axis] = CellCoord(maxs[axis]);
+    }
+
+    ForEachCell(lo, hi, [&](const std::vector<uint32_t>& cell) {
+        for (uint32_t id : cell) {
+            const Entry& entry = m_entries[id];
+            if (entry.x >= mins[0] && entry.x <= maxs[0] &&
+                entry.y >= mins[1] && entry.y <= maxs[1] &&
+                entry.z >= mins[2] && entry.z <= maxs[2]) {
+                ids.push_back(id);
+            }
+        }
+    });
+}
+
+void SpatialGrid::QueryNearest(const float center[3], size_t k, std::vector<uint32_t>& ids, float maxDistance) const {
+    ids.clear();
+    if (m_count == 0 || k == 0 || !(maxDistance >= 0.0f)) return;
+
+    // Max-heap of the best k so far, worst on top
+    using Candidate = std::pair<float, uint32_t>;
+    std::priority_queue<Candidate> best;
+    const float maxDistanceSqr = maxDistance * maxDistance;
+
+    auto consider = [&](const std::vector<uint32_t>& cell) {
+        for (uint32_t id : cell) {
+            const Entry& entry = m_entries[id];
+            float dx = entry.x - center[0];
+            float dy = entry.y - center[1];
+            float dz = entry.z - center[2];
+            float distanceSqr = dx * dx + dy * dy + dz * dz;
+            if (distanceSqr > maxDistanceSqr) continue;
+
+            Candidate candidate(distanceSqr, id);
+            if (best.size() < k) {
+                best.push(candidate);
+            } else if (candidate < best.top()) {
+                best.pop();
+                best.push(candidate);
+            }
+        }
+    };
+
+    const int32_t c[3] = {CellCoord(center[0]), CellCoord(center[1]), CellCoord(center[2])};
+    int32_t reach = 0;  // Shells needed to cover every occupied cell
+    for (int axis = 0; axis < 3; axis++) {
+        reach = std::max({reach, m_occupiedMax[axis] - c[axis], c[axis] - m_occupiedMin[axis]});
+    }
+
+    uint64_t visitedCells = 0;
+    for (int32_t r = 0; r <= reach; r++) {
+        const uint64_t side = 2 * static_cast<uint64_t>(r) + 1;
+        const uint64_t shellCells = r == 0 ? 1 : side * side * side - (side - 2) * (side - 2) * (side - 2);
+
+        // Sparse grids: once the shells cost more probes than there are
+        // occupied cells, finish with one pass over all of them
+        if (visitedCells + shellCells > m_cells.size()) {
+            best = {};
+            for (const auto& entry : m_cells) consider(entry.second);
+            break;
+        }
+        visitedCells += shellCells;
+
+        for (int32_t dx = -r; dx <= r; dx++) {
+            for (int32_t dy = -r; dy <= r; dy++) {
+                const bool onFace = dx == -r || dx == r || dy == -r || dy == r;
+                for (int32_t dz = -r; dz <= r; dz += onFace ? 1 : std::max(2 * r, 1)) {
+                    const int32_t x = c[0] + dx, y = c[1] + dy, z = c[2] + dz;
+                    if (x < m_occupiedMin[0] || x > m_occupiedMax[0] ||
+                        y < m_occupiedMin[1] || y > m_occupiedMax[1] ||
+                        z < m_occupiedMin[2] || z > m_occupiedMax[2]) {
+                        continue;
+                    }
+                    auto it = m_cells.find(PackChunkKey(x, y, z));
+                    if (it != m_cells.end()) consider(it->second);
+                }
+            }
+        }
+
+        // Anything outside the searched block is at least this far away
+        float outside = FLT_MAX;
+        for (int axis = 0; axis < 3; axis++) {
+            float low = static_cast<float>(c[axis] - r) * m_cellSize;
+            float high = static_cast<float>(c[axis] + r + 1) * m_cellSize;
+            outside = std::min({outside, center[axis] - low, high - center[axis]});
+        }
+        outside = std::max(outside, 0.0f);
+        if (outside > maxDistance) break;
+        if (best.size() == k && best.top().first < outside * outside) break;
+    }
+
+    ids.resize(best.size());
+    for (size_t i = best.size(); i-- > 0;) {
+        ids[i] = best.top().second;
+        best.pop();
+    }
+}
+
+} // namespace RTXMath
@@ -0,0 +1,66 @@
+#pragma once
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace RTXMath {
+    // Uniform grid over moving points identified by small non-negative ids
+    // (entity indices). Cells are hashed by PackChunkKey, so only
+    // occupied cells cost memory; a point that moves within its cell only
+    // has its position rewritten. Query results are ids in no particular
+    // order unless stated otherwise.
+    class SpatialGrid {
+    public:
+        explicit SpatialGrid(float cellSize = 1024.0f) { SetCellSize(cellSize); }
+
+        // Drops every point; the grid has to be refilled afterwards
+        void SetCellSize(float cellSize);
+        float CellSize() const { return m_cellSize; }
+
+        // Inserts the point or moves it. A non-finite position removes it.
+        void Update(uint32_t id, float x, float y, float z);
+        bool Remove(uint32_t id);
+        void Clear();
+
+        bool Contains(uint32_t id) const { return id < m_entries.size() && m_entries[id].slot != kNoSlot; }
+        size_t Size() const { return m_count; }
+        size_t CellCount() const { return m_cells.size(); }
+
+        // Points within radius of center, inclusive
+        void QueryRadius(const float center[3], float radius, std::vector<uint32_t>& ids) const;
+        // Points inside the box, inclusive on every face
+        void QueryBox(const float mins[3], const float maxs[3], std::vector<uint32_t>& ids) const;
+        // Up to k points no further than maxDistance, closest first (ties by
+        // id). Searches outwards one shell of cells at a time.
+        void QueryNearest(const float center[3], size_t k, std::vector<uint32_t>& ids,
+                          float maxDistance = FLT_MAX) const;
+
+    private:
+        static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+        struct Entry {
+            int64_t cell;
+            uint32_t slot = kNoSlot;  // Position in the cell's id list
+            float x, y, z;
+        };
+
+        int32_t CellCoord(float value) const;
+        void RemoveFromCell(uint32_t id);
+        // Visits the occupied cells of an inclusive cell-coordinate range
+        template<typename Visit>
+        void ForEachCell(const int32_t lo[3], const int32_t hi[3], Visit&& visit) const;
+
+        float m_cellSize = 1024.0f;
+        float m_inverseCell = 1.0f / 1024.0f;
+        std::unordered_map<int64_t, std::vector<uint32_t>> m_cells;
+        std::vector<Entry> m_entries;
+        size_t m_count = 0;
+
+        // Cell range that has ever been occupied since the last Clear; only
+        // grows, so it stays a conservative bound for nearest queries
+        int32_t m_occupiedMin[3];
+        int32_t m_occupiedMax[3];
+    };
+}
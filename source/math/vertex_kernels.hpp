@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+
+// Structure-of-arrays vertex kernels with scalar, SSE (4-wide) and AVX2
+// (8-wide) implementations. The best level supported by the CPU is picked
+// at runtime through CPUID; every level evaluates in the scalar reference's
+// order without FMA, so results match it exactly.
+namespace RTXMath {
+    enum class SimdLevel {
+        Scalar = 0,
+        SSE = 1,
+        AVX2 = 2
+    };
+
+    // Row-major 3x4 affine transform: p' = M * (p, 1)
+    struct Matrix3x4 {
+        float m[3][4];
+    };
+
+    struct VertexKernels {
+        const char* name;
+        SimdLevel level;
+
+        // Interleaved xyz (stride 3 floats) <-> separate x/y/z arrays
+        void (*deinterleave)(const float* xyz, size_t count, float* x, float* y, float* z);
+        void (*interleave)(const float* x, const float* y, const float* z, size_t count, float* xyz);
+
+        // Outputs may alias the inputs
+        void (*transformPoints)(const Matrix3x4& m, const float* x, const float* y, const float* z,
+                                size_t count, float* outX, float* outY, float* outZ);
+        void (*transformDirections)(const Matrix3x4& m, const float* x, const float* y, const float* z,
+                                    size_t count, float* outX, float* outY, float* outZ);
+
+        // Zero-length vectors are left untouched
+        void (*renormalize)(float* x, float* y, float* z, size_t count);
+
+        // count == 0 leaves mins at +FLT_MAX and maxs at -FLT_MAX
+        void (*computeBounds)(const float* x, const float* y, const float* z, size_t count,
+                              float mins[3], float maxs[3]);
+    };
+
+    SimdLevel DetectSimdLevel();
+    const char* SimdLevelName(SimdLevel level);
+
+    // Kernels for the best level the CPU supports. On SSE-only CPUs,
+    // transformPoints is the scalar loop when that measured faster.
+    const VertexKernels& GetVertexKernels();
+    // Kernels for a specific level, clamped to what the CPU supports
+    const VertexKernels& GetVertexKernels(SimdLevel level);
+
+    // Interleaved helpers built on the dispatched kernels
+    void RenormalizeInterleaved(float* xyz, size_t count);
+    void ComputeBoundsInterleaved(const float* xyz, size_t count, float mins[3], float maxs[3]);
+}
@@ -0,0 +1,327 @@
+#include "chunk_builder.hpp"
+#include "mesh_simplifier.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace MeshBuilder {
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double MillisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool IsSkyMaterialName(const std::string& name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    return lower.find("tools/toolsskybox") != std::string::npos ||
+           lower.find("skybox/") != std::string::npos ||
+           lower.find("sky_") != std::string::npos;
+}
+
+namespace {
+    bool ShouldSkipFace(const BSPReader::FaceRange& face, const ChunkBuildOptions& options) {
+        const Vec3& c = face.center;
+
+        if (options.hasBounds &&
+            (c.x < options.boundsMins.x || c.x > options.boundsMaxs.x ||
+             c.y < options.boundsMins.y || c.y > options.boundsMaxs.y ||
+             c.z < options.boundsMins.z || c.z > options.boundsMaxs.z)) {
+            return true;
+        }
+
+        if (options.hasExclusionSphere) {
+            float dx = c.x - options.exclusionCenter.x;
+            float dy = c.y - options.exclusionCenter.y;
+            float dz = c.z - options.exclusionCenter.z;
+            if (dx * dx + dy * dy + dz * dz < options.exclusionRadius * options.exclusionRadius) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Face boxes in material stream order
+    void ClassifyWorldRegions(const BSPReader::WorldGeometry& world, const RegionOptions& options,
+                              RegionClassification& out) {
+        std::vector<float> boxes;
+        for (const BSPReader::MaterialStream& stream : world.materials) {
+            for (const BSPReader::FaceRange& face : stream.faces) {
+                boxes.insert(boxes.end(), {face.mins.x, face.mins.y, face.mins.z,
+                                           face.maxs.x, face.maxs.y, face.maxs.z});
+            }
+        }
+        ClassifyRegions(boxes.data(), boxes.size() / 6, options, out);
+    }
+
+    // Simplifies each level from the one before it, so every level only
+    // references vertices of the full mesh
+    void BuildLods(ChunkMesh& mesh, uint32_t levels, const ChunkBuildOptions& options) {
+        std::vector<uint32_t> source, simplified;
+        mesh.indices.CopyTo(source);
+
+        float maxError = std::max(options.lodMaxError, 0.0f);
+        for (uint32_t level = 0; level < levels; level++, maxError *= 2.0f) {
+            SimplifyOptions simplify;
+            simplify.targetIndexCount = source.size() / 2;
+            simplify.maxError = maxError;
+
+            simplified.resize(source.size());
+            simplified.resize(SimplifyMesh(simplified.data(), source.data(), source.size(),
+                                           mesh.vertices.data(), mesh.vertices.size(), simplify));
+            if (simplified.empty() || simplified.size() * 10 > source.size() * 9) break;
+
+            if (options.optimizeMeshes) {
+                source.resize(simplified.size());
+                OptimizeVertexCache(source.data(), simplified.data(), simplified.size(), mesh.vertices.size());
+            } else {
+                source.swap(simplified);
+            }
+
+            mesh.lods.emplace_back();
+            mesh.lods.back().Assign(source, mesh.vertices.size());
+        }
+    }
+}
+
+ChunkBuildPlan::ChunkBuildPlan(const BSPReader::WorldGeometry& world, const ChunkBuildOptions& options)
+    : m_world(world), m_options(options) {
+    auto partitionStart = Clock::now();
+    const float invChunkSize = 1.0f / std::max(options.chunkSize, 1.0f);
+    const uint32_t maxVertices = std::max<uint32_t>(options.maxVertices, 3);
+    const uint32_t maxIndices = options.maxIndices > 0 ? std::max<uint32_t>(options.maxIndices, 3) : maxVertices * 3;
+
+    // Partition faces by chunk key
+    std::vector<FaceRef>& refs = m_refs;
+    refs.reserve(world.faceCount);
+
+    // Regions are classified over every face, sky included, so the main
+    // area is found the same way the Lua mesher finds it
+    RegionClassification regions;
+    if (options.skipSeparateRegions) ClassifyWorldRegions(world, options.regions, regions);
+
+    size_t faceBase = 0;
+    for (uint32_t m = 0; m < world.materials.size(); m++) {
+        const BSPReader::MaterialStream& stream = world.materials[m];
+        const size_t streamBase = faceBase;
+        faceBase += stream.faces.size();
+
+        if (options.skipSkyMaterials && IsSkyMaterialName(stream.material)) {
+            m_stats.skippedFaces += stream.faces.size();
+            continue;
+        }
+
+        for (uint32_t f = 0; f < stream.faces.size(); f++) {
+            const BSPReader::FaceRange& face = stream.faces[f];
+            if (ShouldSkipFace(face, options)) {
+                m_stats.skippedFaces++;
+                continue;
+            }
+
+            if (regions.IsSeparate(streamBase + f)) {
+                m_stats.skippedFaces++;
+                m_stats.separateRegionFaces++;
+                continue;
+            }
+
+            // Faces whose chunk has no key (far outside any map) are dropped
+            int32_t cx, cy, cz;
+            if (!RTXMath::ToChunkCoord(face.center.x, invChunkSize, cx) ||
+                !RTXMath::ToChunkCoord(face.center.y, invChunkSize, cy) ||
+                !RTXMath::ToChunkCoord(face.center.z, invChunkSize, cz)) {
+                m_stats.skippedFaces++;
+                continue;
+            }
+            refs.push_back({RTXMath::PackChunkKey(cx, cy, cz), m, f});
+        }
+    }
+
+    std::sort(refs.begin(), refs.end(), [](const FaceRef& a, const FaceRef& b) {
+        if (a.chunkKey != b.chunkKey) return a.chunkKey < b.chunkKey;
+        if (a.material != b.material) return a.material < b.material;
+        return a.face < b.face;
+    });
+
+    // Cut each group into jobs that respect the vertex budget
+    std::vector<MeshJob>& jobs = m_jobs;
+    size_t groupStart = 0;
+    while (groupStart < refs.size()) {
+        size_t groupEnd = groupStart;
+        while (groupEnd < refs.size() &&
+               refs[groupEnd].chunkKey == refs[groupStart].chunkKey &&
+               refs[groupEnd].material == refs[groupStart].material) {
+            groupEnd++;
+        }
+
+        m_stats.groups++;
+        const BSPReader::MaterialStream& stream = world.materials[refs[groupStart].material];
+
+        MeshJob job = {groupStart, 0, 0, 0, 0};
+        for (size_t i = groupStart; i < groupEnd; i++) {
+            uint32_t faceVerts = stream.faces[refs[i].face].vertexCount;
+            // A fan of n triangles has n + 2 distinct corners
+            uint32_t faceUnique = faceVerts / 3 + 2;
+
+            bool overBudget = options.weldVertices
+                ? job.uniqueCount + faceUnique > maxVertices || job.vertexCount + faceVerts > maxIndices
+                : job.vertexCount + faceVerts > maxVertices;
+            if (job.count > 0 && overBudget) {
+                jobs.push_back(job);
+                job = {i, 0, 0, 0, job.part + 1};
+            }
+            job.count++;
+            job.vertexCount += faceVerts;
+            job.uniqueCount += faceUnique;
+        }
+        if (job.count > 0) jobs.push_back(job);
+
+        groupStart = groupEnd;
+    }
+
+    m_stats.faces = refs.size();
+    m_stats.meshes = jobs.size();
+    for (const MeshJob& job : jobs) {
+        m_stats.sourceVertices += job.vertexCount;
+    }
+    m_stats.partitionMs = MillisecondsSince(partitionStart);
+}
+
+void ChunkBuildPlan::BuildMesh(size_t index, ChunkMesh& mesh, MeshOptimizeStats* optimize) const {
+    const MeshJob& job = m_jobs[index];
+    const FaceRef& head = m_refs[job.first];
+    const BSPReader::MaterialStream& stream = m_world.materials[head.material];
+
+    mesh.chunkKey = head.chunkKey;
+    RTXMath::UnpackChunkKey(head.chunkKey, mesh.chunkX, mesh.chunkY, mesh.chunkZ);
+    mesh.material = head.material;
+    mesh.part = job.part;
+    mesh.mins = {FLT_MAX, FLT_MAX, FLT_MAX};
+    mesh.maxs = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    mesh.vertices.clear();
+    mesh.indices.Clear();
+    mesh.lods.clear();
+    mesh.vertices.reserve(job.vertexCount);
+
+    for (size_t i = job.first; i < job.first + job.count; i++) {
+        const BSPReader::FaceRange& face = stream.faces[m_refs[i].face];
+        const Vertex* begin = stream.vertices.data() + face.firstVertex;
+        mesh.vertices.insert(mesh.vertices.end(), begin, begin + face.vertexCount);
+
+        mesh.mins = {std::min(mesh.mins.x, face.mins.x), std::min(mesh.mins.y, face.mins.y), std::min(mesh.mins.z, face.mins.z)};
+        mesh.maxs = {std::max(mesh.maxs.x, face.maxs.x), std::max(mesh.maxs.y, face.maxs.y), std::max(mesh.maxs.z, face.maxs.z)};
+    }
+
+    if (m_options.weldVertices) {
+        std::vector<Vertex> soup;
+        soup.swap(mesh.vertices);
+        WeldTriangles(soup.data(), soup.size(), m_options.weld, mesh.vertices, mesh.indices);
+
+        if (m_options.optimizeMeshes) {
+            MeshOptimizeStats localOptimize;
+            OptimizeMesh(mesh.vertices, mesh.indices, optimize ? optimize : &localOptimize);
+        }
+
+        const uint32_t lodLevels = std::min(m_options.lodLevels, kMaxChunkLods);
+        if (lodLevels > 0) BuildLods(mesh, lodLevels, m_options);
+    }
+}
+
+void ChunkBuildPlan::AddMeshStats(const ChunkMesh& mesh, ChunkBuildStats& stats) {
+    stats.vertices += mesh.vertices.size();
+    stats.indices += mesh.indices.Size();
+    stats.lodBuffers += mesh.lods.size();
+    for (size_t level = 0; level < mesh.lods.size(); level++) {
+        stats.lodIndices[level] += mesh.lods[level].Size();
+    }
+}
+
+std::vector<ChunkMesh> BuildChunkMeshes(const BSPReader::WorldGeometry& world,
+                                        const ChunkBuildOptions& options,
+                                        WorkerPool* pool,
+                                        ChunkBuildStats* stats) {
+    ChunkBuildPlan plan(world, options);
+    ChunkBuildStats localStats = plan.Stats();
+    localStats.threads = pool ? pool->ThreadCount() + 1 : 1;
+
+    // Build every mesh; each job writes only its own slot so order is fixed
+    auto buildStart = Clock::now();
+    std::vector<ChunkMesh> meshes(plan.MeshCount());
+    std::vector<MeshOptimizeStats> optimizeStats(options.optimizeMeshes ? meshes.size() : 0);
+
+    auto buildJob = [&](size_t j) {
+        plan.BuildMesh(j, meshes[j], options.optimizeMeshes ? &optimizeStats[j] : nullptr);
+    };
+
+    if (pool) {
+        pool->ParallelFor(meshes.size(), buildJob);
+    } else {
+        for (size_t j = 0; j < meshes.size(); j++) buildJob(j);
+    }
+
+    localStats.buildMs = MillisecondsSince(buildStart);
+    for (const auto& mesh : meshes) {
+        ChunkBuildPlan::AddMeshStats(mesh, localStats);
+    }
+    for (const auto& optimize : optimizeStats) {
+        localStats.optimize.Add(optimize);
+    }
+
+    if (stats) *stats = localStats;
+    return meshes;
+}
+
+void GenerateSyntheticWorld(size_t faceCount, size_t materialCount, uint32_t seed,
+                            BSPReader::WorldGeometry& out) {
+    out.Clear();
+    materialCount = std::max<size_t>(materialCount, 1);
+    out.materials.resize(materialCount);
+    for (size_t m = 0; m < materialCount; m++) {
+        out.materials[m].material = "synthetic/material_" + std::to_string(m);
+        out.materials[m].texData = static_cast<int32_t>(m);
+        out.materials[m].surfaceFlags = 0;
+    }
+
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> coord(-15000.0f, 15000.0f);
+    std::uniform_real_distribution<float> extent(8.0f, 256.0f);
+    std::uniform_int_distribution<size_t> pickMaterial(0, materialCount - 1);
+
+    for (size_t i = 0; i < faceCount; i++) {
+        BSPReader::MaterialStream& stream = out.materials[pickMaterial(gen)];
+
+        float x = coord(gen), y = coord(gen), z = coord(gen);
+        float w = extent(gen), h = extent(gen);
+        Vec3 corners[4] = {{x, y, z}, {x + w, y, z}, {x + w, y + h, z}, {x, y + h, z}};
+        const int fan[6] = {0, 1, 2, 0, 2, 3};
+
+        BSPReader::FaceRange range = {};
+        range.faceIndex = static_cast<uint32_t>(i);
+        range.firstVertex = static_cast<uint32_t>(stream.vertices.size());
+        range.vertexCount = 6;
+        range.mins = corners[0];
+        range.maxs = corners[2];
+        range.center = {x + w * 0.5f, y + h * 0.5f, z};
+
+        for (int corner : fan) {
+            Vertex vert;
+            vert.pos = corners[corner];
+            vert.normal = {0, 0, 1};
+            vert.u = corners[corner].x / 128.0f;
+            vert.v = corners[corner].y / 128.0f;
+            stream.vertices.push_back(vert);
+        }
+        stream.faces.push_back(range);
+
+        out.faceCount++;
+        out.triangleCount += 2;
+    }
+}
+
+} // namespace MeshBuilder
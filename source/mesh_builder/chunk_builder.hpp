@@ -0,0 +1,145 @@
+#pragma once
+#include "bsp_reader/bsp_reader.hpp"
+#include "math/chunk_key.hpp"
+#include "mesh_optimizer.hpp"
+#include "region_classifier.hpp"
+#include "vertex_weld.hpp"
+#include "worker_pool.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace MeshBuilder {
+    using Vec3 = BSPReader::Vec3;
+    using Vertex = BSPReader::TriangleVertex;
+
+    // Most simplified index buffers a chunk mesh carries besides its full one
+    const uint32_t kMaxChunkLods = 3;
+
+    // One finished (chunk, material) vertex stream
+    struct ChunkMesh {
+        int64_t chunkKey;  // RTXMath::PackChunkKey of chunkX/Y/Z
+        int32_t chunkX, chunkY, chunkZ;
+        uint32_t material;  // Index into WorldGeometry::materials
+        uint32_t part;      // Sub-mesh index when the group exceeded maxVertices
+        std::vector<Vertex> vertices;
+        IndexBuffer indices;  // Empty unless the build welded vertices
+        // Simplified index buffers over the same vertices, coarsest last
+        std::vector<IndexBuffer> lods;
+        Vec3 mins, maxs;
+    };
+
+    struct ChunkBuildOptions {
+        float chunkSize = 65536.0f;
+        // Per-mesh vertex budget; groups are split on whole faces
+        uint32_t maxVertices = 10000;
+
+        // Weld each mesh into unique vertices plus an index buffer. The vertex
+        // budget then counts unique vertices and maxIndices caps the indices
+        // (0 = 3 * maxVertices).
+        bool weldVertices = false;
+        uint32_t maxIndices = 0;
+        WeldOptions weld;
+
+        // Vertex cache reorder, overdraw sort and fetch remap (needs weldVertices)
+        bool optimizeMeshes = false;
+
+        // Simplified index buffers built per mesh (needs weldVertices, at most
+        // kMaxChunkLods). Each level targets half the previous triangles and
+        // may deviate lodMaxError units from the surface, doubling per level.
+        // A level that saves less than a tenth of the triangles ends the chain.
+        uint32_t lodLevels = 0;
+        float lodMaxError = 4.0f;
+
+        // Faces centered inside this sphere are skipped (3D skybox area)
+        bool hasExclusionSphere = false;
+        Vec3 exclusionCenter = {0, 0, 0};
+        float exclusionRadius = 0.0f;
+
+        // Faces centered outside these bounds are skipped
+        bool hasBounds = false;
+        Vec3 boundsMins = {0, 0, 0};
+        Vec3 boundsMaxs = {0, 0, 0};
+
+        // Skip tools/toolsskybox, skybox/ and sky_ materials like the Lua mesher
+        bool skipSkyMaterials = true;
+
+        // Skip faces in regions ClassifyRegions flags as separate from the
+        // main play area, like the Lua mesher's IsInSeparateRegion check
+        bool skipSeparateRegions = true;
+        RegionOptions regions;
+    };
+
+    struct ChunkBuildStats {
+        size_t groups = 0;
+        size_t meshes = 0;
+        size_t faces = 0;
+        size_t skippedFaces = 0;
+        size_t separateRegionFaces = 0;  // Of skippedFaces
+        size_t vertices = 0;
+        size_t sourceVertices = 0;  // Before welding
+        size_t indices = 0;
+        MeshOptimizeStats optimize;
+        size_t lodBuffers = 0;
+        size_t lodIndices[kMaxChunkLods] = {};  // Summed per level
+        double partitionMs = 0.0;
+        double buildMs = 0.0;
+        unsigned threads = 0;
+    };
+
+    // Faces of a map partitioned by chunk and cut into one job per output
+    // mesh, so the meshes can be built in any order and at any pace. Keeps
+    // a reference to world, which must not change while the plan is in use.
+    class ChunkBuildPlan {
+    public:
+        ChunkBuildPlan(const BSPReader::WorldGeometry& world, const ChunkBuildOptions& options);
+
+        // Meshes come out sorted by (chunk key, material, part)
+        size_t MeshCount() const { return m_jobs.size(); }
+
+        // Builds mesh index into mesh. Safe to call concurrently for
+        // different indices.
+        void BuildMesh(size_t index, ChunkMesh& mesh, MeshOptimizeStats* optimize = nullptr) const;
+
+        // Partition counters and timing; the per-mesh counters are left to
+        // AddMeshStats as meshes are built
+        const ChunkBuildStats& Stats() const { return m_stats; }
+        static void AddMeshStats(const ChunkMesh& mesh, ChunkBuildStats& stats);
+
+    private:
+        // A face assigned to a (chunk, material) group
+        struct FaceRef {
+            int64_t chunkKey;
+            uint32_t material;
+            uint32_t face;  // Index into MaterialStream::faces
+        };
+
+        // A contiguous run of sorted FaceRefs that becomes one ChunkMesh
+        struct MeshJob {
+            size_t first;
+            size_t count;
+            uint32_t vertexCount;   // Unwelded triangle list vertices
+            uint32_t uniqueCount;   // Upper bound on welded vertices
+            uint32_t part;
+        };
+
+        const BSPReader::WorldGeometry& m_world;
+        ChunkBuildOptions m_options;
+        std::vector<FaceRef> m_refs;
+        std::vector<MeshJob> m_jobs;
+        ChunkBuildStats m_stats;
+    };
+
+    // Partitions every face by chunk and builds all (chunk, material) streams.
+    // Output is sorted by (chunk key, material, part) regardless of thread count.
+    // pool == nullptr builds serially on the calling thread.
+    std::vector<ChunkMesh> BuildChunkMeshes(const BSPReader::WorldGeometry& world,
+                                            const ChunkBuildOptions& options,
+                                            WorkerPool* pool,
+                                            ChunkBuildStats* stats = nullptr);
+
+    bool IsSkyMaterialName(const std::string& name);
+
+    // Random axis-aligned quads spread over a map-sized volume, for benchmarking
+    void GenerateSyntheticWorld(size_t faceCount, size_t materialCount, uint32_t seed,
+                                BSPReader::WorldGeometry& out);
+}
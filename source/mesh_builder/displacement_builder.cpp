@@ -0,0 +1,337 @@
+#include "displacement_builder.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+
+namespace MeshBuilder {
+
+using Vec3 = BSPReader::Vec3;
+using TriangleVertex = BSPReader::TriangleVertex;
+
+namespace {
+    Vec3 Sub(const Vec3& a, const Vec3& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+    Vec3 Add(const Vec3& a, const Vec3& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+    Vec3 Scale(const Vec3& a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+    float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    Vec3 Cross(const Vec3& a, const Vec3& b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+    Vec3 Lerp(const Vec3& a, const Vec3& b, float t) { return Add(a, Scale(Sub(b, a), t)); }
+
+    // One displacement face expanded to its (2^power + 1)^2 vertex grid
+    struct DispGrid {
+        uint32_t face;
+        int32_t texInfo;
+        int size = 0;  // Vertices per side
+        bool valid = false;
+        Vec3 center = {0, 0, 0};
+        std::vector<TriangleVertex> grid;  // Normals hold unnormalized sums until emitted
+        std::vector<TriangleVertex> triangles;
+    };
+
+    // An edge or corner grid vertex, keyed by its position on a 1/8 unit lattice
+    struct EdgeVertex {
+        int32_t key[3];
+        uint32_t disp;
+        uint32_t vertex;
+
+        bool operator<(const EdgeVertex& other) const {
+            if (key[0] != other.key[0]) return key[0] < other.key[0];
+            if (key[1] != other.key[1]) return key[1] < other.key[1];
+            if (key[2] != other.key[2]) return key[2] < other.key[2];
+            return disp < other.disp;
+        }
+        bool SamePosition(const EdgeVertex& other) const {
+            return key[0] == other.key[0] && key[1] == other.key[1] && key[2] == other.key[2];
+        }
+    };
+
+    // Quads alternate their diagonal in a checkerboard like the engine does
+    template<typename Fn>
+    void ForEachTriangle(int size, Fn&& fn) {
+        for (int i = 0; i + 1 < size; i++) {
+            for (int j = 0; j + 1 < size; j++) {
+                uint32_t a = i * size + j;          // (i, j)
+                uint32_t b = (i + 1) * size + j;    // (i + 1, j)
+                uint32_t c = (i + 1) * size + j + 1;
+                uint32_t d = i * size + j + 1;
+
+                if ((i + j) & 1) {
+                    fn(a, b, d);
+                    fn(b, c, d);
+                } else {
+                    fn(a, b, c);
+                    fn(a, c, d);
+                }
+            }
+        }
+    }
+}
+
+void BuildDisplacements(const BSPReader::Map& map, const BSPReader::DecodeOptions& options,
+                        BSPReader::WorldGeometry& world, WorkerPool* pool,
+                        DisplacementStats* stats) {
+    auto start = std::chrono::high_resolution_clock::now();
+    DisplacementStats localStats;
+
+    size_t faceCount, planeCount, texInfoCount, texDataCount, modelCount, dispInfoCount, dispVertCount;
+    const BSPReader::DFace* faces = map.GetLump<BSPReader::DFace>(BSPReader::LUMP_FACES, faceCount);
+    const BSPReader::DPlane* planes = map.GetLump<BSPReader::DPlane>(BSPReader::LUMP_PLANES, planeCount);
+    const BSPReader::DTexInfo* texInfos = map.GetLump<BSPReader::DTexInfo>(BSPReader::LUMP_TEXINFO, texInfoCount);
+    const BSPReader::DTexData* texDatas = map.GetLump<BSPReader::DTexData>(BSPReader::LUMP_TEXDATA, texDataCount);
+    const BSPReader::DModel* models = map.GetLump<BSPReader::DModel>(BSPReader::LUMP_MODELS, modelCount);
+    const BSPReader::DDispInfo* dispInfos = map.GetLump<BSPReader::DDispInfo>(BSPReader::LUMP_DISPINFO, dispInfoCount);
+    const BSPReader::DDispVert* dispVerts = map.GetLump<BSPReader::DDispVert>(BSPReader::LUMP_DISP_VERTS, dispVertCount);
+
+    if (options.skipDisplacements || !faces || !planes || !texInfos || !dispInfos || !dispVerts) {
+        if (stats) *stats = localStats;
+        return;
+    }
+
+    size_t firstFace = 0;
+    size_t lastFace = faceCount;
+    if (options.worldOnly && models && modelCount > 0) {
+        firstFace = static_cast<size_t>(std::max(models[0].firstface, 0));
+        lastFace = std::min(faceCount, firstFace + static_cast<size_t>(std::max(models[0].numfaces, 0)));
+    }
+
+    std::vector<DispGrid> disps;
+    for (size_t f = firstFace; f < lastFace; f++) {
+        const BSPReader::DFace& face = faces[f];
+        if (face.dispinfo < 0) continue;
+
+        if (static_cast<size_t>(face.dispinfo) >= dispInfoCount || face.texinfo < 0 ||
+            static_cast<size_t>(face.texinfo) >= texInfoCount || face.planenum >= planeCount ||
+            (static_cast<uint32_t>(texInfos[face.texinfo].flags) & options.skipSurfaceFlags)) {
+            localStats.skipped++;
+            continue;
+        }
+
+        DispGrid disp;
+        disp.face = static_cast<uint32_t>(f);
+        disp.texInfo = face.texinfo;
+        disps.push_back(std::move(disp));
+    }
+
+    // Build each grid: positions, UVs and per-grid normal sums
+    auto buildGrid = [&](size_t d) {
+        DispGrid& disp = disps[d];
+        const BSPReader::DFace& face = faces[disp.face];
+        const BSPReader::DDispInfo& info = dispInfos[face.dispinfo];
+
+        if (info.power < 2 || info.power > 4) return;
+        const int segments = 1 << info.power;
+        const int size = segments + 1;
+        if (info.dispVertStart < 0 ||
+            static_cast<size_t>(info.dispVertStart) + static_cast<size_t>(size * size) > dispVertCount) {
+            return;
+        }
+
+        std::vector<Vec3> corners;
+        if (!map.GetFacePolygon(disp.face, corners) || corners.size() != 4) return;
+
+        // The grid starts at the corner nearest startPosition, keeping face winding
+        size_t first = 0;
+        float bestDist = FLT_MAX;
+        for (size_t c = 0; c < 4; c++) {
+            Vec3 delta = Sub(corners[c], info.startPosition);
+            float dist = Dot(delta, delta);
+            if (dist < bestDist) {
+                bestDist = dist;
+                first = c;
+            }
+        }
+        Vec3 p[4];
+        for (size_t c = 0; c < 4; c++) p[c] = corners[(first + c) % 4];
+
+        Vec3 planeNormal = planes[face.planenum].normal;
+        if (face.side) planeNormal = Scale(planeNormal, -1.0f);
+
+        // Orient triangle normals by how the base quad winds against its plane
+        const float orientation = Dot(Cross(Sub(p[1], p[0]), Sub(p[2], p[0])), planeNormal) >= 0.0f ? 1.0f : -1.0f;
+
+        const BSPReader::DTexInfo& texInfo = texInfos[disp.texInfo];
+        float width = 1.0f, height = 1.0f;
+        if (texDatas && texInfo.texdata >= 0 && static_cast<size_t>(texInfo.texdata) < texDataCount) {
+            width = static_cast<float>(std::max(texDatas[texInfo.texdata].width, 1));
+            height = static_cast<float>(std::max(texDatas[texInfo.texdata].height, 1));
+        }
+        const float* s = texInfo.textureVecs[0];
+        const float* t = texInfo.textureVecs[1];
+
+        disp.size = size;
+        disp.grid.resize(size * size);
+        disp.center = Scale(Add(Add(p[0], p[1]), Add(p[2], p[3])), 0.25f);
+
+        const float inv = 1.0f / segments;
+        for (int i = 0; i < size; i++) {
+            Vec3 edgeA = Lerp(p[0], p[1], i * inv);
+            Vec3 edgeB = Lerp(p[3], p[2], i * inv);
+
+            for (int j = 0; j < size; j++) {
+                Vec3 base = Lerp(edgeA, edgeB, j * inv);
+                const BSPReader::DDispVert& offset = dispVerts[info.dispVertStart + i * size + j];
+
+                TriangleVertex& vert = disp.grid[i * size + j];
+                vert.pos = Add(base, Scale(offset.vec, offset.dist));
+                vert.normal = {0, 0, 0};
+                // Texture coordinates follow the undisplaced surface, as in the engine
+                vert.u = (s[0] * base.x + s[1] * base.y + s[2] * base.z + s[3]) / width;
+                vert.v = (t[0] * base.x + t[1] * base.y + t[2] * base.z + t[3]) / height;
+
+                const Vec3& pos = vert.pos;
+                if (!std::isfinite(pos.x) || !std::isfinite(pos.y) || !std::isfinite(pos.z) ||
+                    std::fabs(pos.x) > options.maxCoord || std::fabs(pos.y) > options.maxCoord ||
+                    std::fabs(pos.z) > options.maxCoord) {
+                    disp.grid.clear();
+                    return;
+                }
+            }
+        }
+
+        // Area-weighted normal sums from every triangle touching a vertex
+        ForEachTriangle(size, [&](uint32_t a, uint32_t b, uint32_t c) {
+            Vec3 n = Scale(Cross(Sub(disp.grid[b].pos, disp.grid[a].pos),
+                                 Sub(disp.grid[c].pos, disp.grid[a].pos)), orientation);
+            disp.grid[a].normal = Add(disp.grid[a].normal, n);
+            disp.grid[b].normal = Add(disp.grid[b].normal, n);
+            disp.grid[c].normal = Add(disp.grid[c].normal, n);
+        });
+
+        disp.valid = true;
+    };
+
+    if (pool) {
+        pool->ParallelFor(disps.size(), buildGrid);
+    } else {
+        for (size_t d = 0; d < disps.size(); d++) buildGrid(d);
+    }
+
+    // Stitch: coincident edge vertices of different displacements share one normal sum
+    std::vector<EdgeVertex> edges;
+    for (uint32_t d = 0; d < disps.size(); d++) {
+        const DispGrid& disp = disps[d];
+        if (!disp.valid) continue;
+
+        for (int i = 0; i < disp.size; i++) {
+            for (int j = 0; j < disp.size; j++) {
+                if (i != 0 && j != 0 && i != disp.size - 1 && j != disp.size - 1) continue;
+
+                const Vec3& pos = disp.grid[i * disp.size + j].pos;
+                EdgeVertex edge;
+                edge.key[0] = static_cast<int32_t>(std::floor(pos.x * 8.0f + 0.5f));
+                edge.key[1] = static_cast<int32_t>(std::floor(pos.y * 8.0f + 0.5f));
+                edge.key[2] = static_cast<int32_t>(std::floor(pos.z * 8.0f + 0.5f));
+                edge.disp = d;
+                edge.vertex = static_cast<uint32_t>(i * disp.size + j);
+                edges.push_back(edge);
+            }
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    for (size_t groupStart = 0; groupStart < edges.size();) {
+        size_t groupEnd = groupStart + 1;
+        while (groupEnd < edges.size() && edges[groupEnd].SamePosition(edges[groupStart])) groupEnd++;
+
+        if (groupEnd - groupStart > 1 && edges[groupStart].disp != edges[groupEnd - 1].disp) {
+            Vec3 sum = {0, 0, 0};
+            for (size_t e = groupStart; e < groupEnd; e++) {
+                sum = Add(sum, disps[edges[e].disp].grid[edges[e].vertex].normal);
+            }
+            for (size_t e = groupStart; e < groupEnd; e++) {
+                disps[edges[e].disp].grid[edges[e].vertex].normal = sum;
+            }
+            localStats.stitchedVertices += groupEnd - groupStart;
+        }
+        groupStart = groupEnd;
+    }
+
+    // Normalize and expand each grid into a triangle list
+    auto emitTriangles = [&](size_t d) {
+        DispGrid& disp = disps[d];
+        if (!disp.valid) return;
+
+        for (TriangleVertex& vert : disp.grid) {
+            float length = std::sqrt(Dot(vert.normal, vert.normal));
+            vert.normal = length > 0.0f ? Scale(vert.normal, 1.0f / length) : Vec3{0, 0, 1};
+        }
+
+        disp.triangles.reserve((disp.size - 1) * (disp.size - 1) * 6);
+        ForEachTriangle(disp.size, [&](uint32_t a, uint32_t b, uint32_t c) {
+            disp.triangles.push_back(disp.grid[a]);
+            disp.triangles.push_back(disp.grid[b]);
+            disp.triangles.push_back(disp.grid[c]);
+        });
+    };
+
+    if (pool) {
+        pool->ParallelFor(disps.size(), emitTriangles);
+    } else {
+        for (size_t d = 0; d < disps.size(); d++) emitTriangles(d);
+    }
+
+    // Append to the material streams in face order so the output is deterministic
+    std::unordered_map<int32_t, size_t> streamByTexData;
+    for (size_t m = 0; m < world.materials.size(); m++) {
+        streamByTexData.emplace(world.materials[m].texData, m);
+    }
+
+    for (DispGrid& disp : disps) {
+        if (!disp.valid) {
+            localStats.skipped++;
+            continue;
+        }
+
+        const BSPReader::DTexInfo& texInfo = texInfos[disp.texInfo];
+        auto it = streamByTexData.find(texInfo.texdata);
+        if (it == streamByTexData.end()) {
+            BSPReader::MaterialStream stream;
+            const char* name = map.GetTexDataName(texInfo.texdata);
+            stream.material = name ? name : "";
+            stream.texData = texInfo.texdata;
+            stream.surfaceFlags = 0;
+            it = streamByTexData.emplace(texInfo.texdata, world.materials.size()).first;
+            world.materials.push_back(std::move(stream));
+        }
+
+        BSPReader::MaterialStream& stream = world.materials[it->second];
+        stream.surfaceFlags |= static_cast<uint32_t>(texInfo.flags);
+
+        BSPReader::FaceRange range = {};
+        range.faceIndex = disp.face;
+        range.texInfo = static_cast<uint32_t>(disp.texInfo);
+        range.firstVertex = static_cast<uint32_t>(stream.vertices.size());
+        range.vertexCount = static_cast<uint32_t>(disp.triangles.size());
+        range.center = disp.center;
+        range.mins = {FLT_MAX, FLT_MAX, FLT_MAX};
+        range.maxs = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        for (const TriangleVertex& vert : disp.grid) {
+            const Vec3& p = vert.pos;
+            range.mins = {std::min(range.mins.x, p.x), std::min(range.mins.y, p.y), std::min(range.mins.z, p.z)};
+            range.maxs = {std::max(range.maxs.x, p.x), std::max(range.maxs.y, p.y), std::max(range.maxs.z, p.z)};
+        }
+
+        stream.vertices.insert(stream.vertices.end(), disp.triangles.begin(), disp.triangles.end());
+        stream.faces.push_back(range);
+
+        world.faceCount++;
+        world.triangleCount += disp.triangles.size() / 3;
+
+        localStats.displacements++;
+        localStats.vertices += disp.grid.size();
+        localStats.triangles += disp.triangles.size() / 3;
+
+        // Release per-grid memory as we go; large maps carry thousands of these
+        std::vector<TriangleVertex>().swap(disp.grid);
+        std::vector<TriangleVertex>().swap(disp.triangles);
+    }
+
+    localStats.milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    if (stats) *stats = localStats;
+}
+
+} // namespace MeshBuilder
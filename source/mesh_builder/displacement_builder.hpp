@@ -0,0 +1,25 @@
+#pragma once
+#include "bsp_reader/bsp_reader.hpp"
+#include "worker_pool.hpp"
+#include <cstddef>
+
+namespace MeshBuilder {
+    struct DisplacementStats {
+        size_t displacements = 0;
+        size_t skipped = 0;
+        size_t vertices = 0;          // Grid vertices before triangulation
+        size_t triangles = 0;
+        size_t stitchedVertices = 0;  // Edge vertices whose normal was shared with a neighbour
+        double milliseconds = 0.0;
+    };
+
+    // Tessellates every displacement face of the map into its power-2 grid
+    // and appends the triangles to the material streams of world, one
+    // FaceRange per displacement, so BuildChunkMeshes picks them up like
+    // brush faces. Normals are smoothed within each grid and across
+    // neighbouring displacements that share edge or corner vertices.
+    // pool == nullptr runs on the calling thread.
+    void BuildDisplacements(const BSPReader::Map& map, const BSPReader::DecodeOptions& options,
+                            BSPReader::WorldGeometry& world, WorkerPool* pool,
+                            DisplacementStats* stats = nullptr);
+}
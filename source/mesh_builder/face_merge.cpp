@@ -0,0 +1,369 @@
+#include "face_merge.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+#include <unordered_map>
+
+namespace MeshBuilder {
+
+using Vec3 = BSPReader::Vec3;
+using Vertex = BSPReader::TriangleVertex;
+
+namespace {
+    Vec3 Sub(const Vec3& a, const Vec3& b) {
+        return {a.x - b.x, a.y - b.y, a.z - b.z};
+    }
+
+    Vec3 Cross(const Vec3& a, const Vec3& b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+
+    float Dot(const Vec3& a, const Vec3& b) {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    float Length(const Vec3& v) {
+        return std::sqrt(Dot(v, v));
+    }
+
+    uint32_t FloatBits(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    // Corners compare by exact bits: brush faces read them from the shared
+    // vertex lump, so both faces of a shared edge carry identical positions
+    struct PositionKey {
+        uint32_t x, y, z;
+        bool operator==(const PositionKey& other) const {
+            return x == other.x && y == other.y && z == other.z;
+        }
+    };
+
+    PositionKey KeyOf(const Vec3& p) {
+        return {FloatBits(p.x), FloatBits(p.y), FloatBits(p.z)};
+    }
+
+    struct EdgeKey {
+        PositionKey from, to;
+        bool operator==(const EdgeKey& other) const {
+            return from == other.from && to == other.to;
+        }
+    };
+
+    struct EdgeKeyHash {
+        size_t operator()(const EdgeKey& edge) const {
+            uint64_t h = 0xCBF29CE484222325ull;
+            const uint32_t words[6] = {edge.from.x, edge.from.y, edge.from.z, edge.to.x, edge.to.y, edge.to.z};
+            for (uint32_t word : words) {
+                h ^= word;
+                h *= 0x100000001B3ull;
+            }
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+    };
+
+    EdgeKey EdgeOf(const Vertex& from, const Vertex& to) {
+        return {KeyOf(from.pos), KeyOf(to.pos)};
+    }
+
+    // Faces that may merge: same texinfo and the same plane
+    struct GroupKey {
+        uint32_t texInfo;
+        uint32_t nx, ny, nz;
+        int64_t distance;  // Plane distance in 1/8 units
+
+        bool operator<(const GroupKey& other) const {
+            return std::tie(texInfo, nx, ny, nz, distance) <
+                   std::tie(other.texInfo, other.nx, other.ny, other.nz, other.distance);
+        }
+        bool operator==(const GroupKey& other) const {
+            return !(*this < other) && !(other < *this);
+        }
+    };
+
+    struct Polygon {
+        std::vector<Vertex> corners;
+        bool alive = true;
+        bool changed = false;  // Differs from the source face and must be re-fanned
+    };
+
+    // A fan is v0 v1 v2, then v0 v(i) v(i+1) for every further corner
+    bool PolygonFromFan(const Vertex* vertices, size_t count, std::vector<Vertex>& out) {
+        if (count < 3 || count % 3 != 0) return false;
+
+        out.assign(vertices, vertices + 3);
+        for (size_t t = 3; t < count; t += 3) {
+            if (!(KeyOf(vertices[t].pos) == KeyOf(out[0].pos)) ||
+                !(KeyOf(vertices[t + 1].pos) == KeyOf(out.back().pos))) {
+                return false;
+            }
+            out.push_back(vertices[t + 2]);
+        }
+        return true;
+    }
+
+    Vec3 NewellNormal(const std::vector<Vertex>& corners) {
+        Vec3 n = {0, 0, 0};
+        for (size_t i = 0; i < corners.size(); i++) {
+            const Vec3& a = corners[i].pos;
+            const Vec3& b = corners[(i + 1) % corners.size()].pos;
+            n.x += (a.y - b.y) * (a.z + b.z);
+            n.y += (a.z - b.z) * (a.x + b.x);
+            n.z += (a.x - b.x) * (a.y + b.y);
+        }
+        return n;
+    }
+
+    enum class Corner { Convex, Straight, Reflex };
+
+    Corner ClassifyCorner(const Vec3& prev, const Vec3& at, const Vec3& next, const Vec3& normal,
+                          float tolerance) {
+        Vec3 in = Sub(at, prev);
+        Vec3 out = Sub(next, at);
+        float lengths = Length(in) * Length(out) * Length(normal);
+        if (lengths <= 0.0f) return Corner::Reflex;
+
+        float sine = Dot(Cross(in, out), normal) / lengths;
+        if (sine > tolerance) return Corner::Convex;
+        if (sine >= -tolerance && Dot(in, out) > 0.0f) return Corner::Straight;
+        return Corner::Reflex;
+    }
+
+    // Joins p and q across p's edge k (A -> B), which q holds reversed at edge
+    // m (B -> A). Fails when the result would not be convex or too large.
+    bool TryMerge(const std::vector<Vertex>& p, size_t k, const std::vector<Vertex>& q, size_t m,
+                  const FaceMergeOptions& options, std::vector<Vertex>& merged, size_t& removed) {
+        const size_t n = p.size();
+        const size_t count = q.size();
+
+        // B ... A along p, then q's corners strictly between A and B
+        merged.clear();
+        for (size_t i = 0; i < n; i++) merged.push_back(p[(k + 1 + i) % n]);
+        for (size_t i = 0; i + 2 < count; i++) merged.push_back(q[(m + 2 + i) % count]);
+
+        Vec3 mins = merged[0].pos, maxs = merged[0].pos;
+        for (const Vertex& v : merged) {
+            mins = {std::min(mins.x, v.pos.x), std::min(mins.y, v.pos.y), std::min(mins.z, v.pos.z)};
+            maxs = {std::max(maxs.x, v.pos.x), std::max(maxs.y, v.pos.y), std::max(maxs.z, v.pos.z)};
+        }
+        if (maxs.x - mins.x > options.maxExtent || maxs.y - mins.y > options.maxExtent ||
+            maxs.z - mins.z > options.maxExtent) {
+            return false;
+        }
+
+        // Only the two corners on the joined edge change their angle
+        const Vec3 normal = NewellNormal(p);
+        const size_t a = n - 1;
+        const size_t size = merged.size();
+        Corner atA = ClassifyCorner(merged[a - 1].pos, merged[a].pos, merged[(a + 1) % size].pos,
+                                    normal, options.collinearTolerance);
+        Corner atB = ClassifyCorner(merged[size - 1].pos, merged[0].pos, merged[1].pos,
+                                    normal, options.collinearTolerance);
+        if (atA == Corner::Reflex || atB == Corner::Reflex) return false;
+
+        removed = 0;
+        if (atA == Corner::Straight) {
+            merged.erase(merged.begin() + a);
+            removed++;
+        }
+        if (atB == Corner::Straight) {
+            merged.erase(merged.begin());
+            removed++;
+        }
+        return merged.size() >= 3;
+    }
+
+    void AppendFan(const std::vector<Vertex>& corners, std::vector<Vertex>& out) {
+        for (size_t i = 1; i + 1 < corners.size(); i++) {
+            out.push_back(corners[0]);
+            out.push_back(corners[i]);
+            out.push_back(corners[i + 1]);
+        }
+    }
+
+    void MergeStream(BSPReader::MaterialStream& stream, const FaceMergeOptions& options, FaceMergeStats& stats) {
+        const size_t faceCount = stream.faces.size();
+        stats.facesBefore = faceCount;
+        for (const auto& face : stream.faces) stats.trianglesBefore += face.vertexCount / 3;
+
+        std::vector<Polygon> polygons(faceCount);
+        std::vector<std::pair<GroupKey, uint32_t>> keyed;
+        keyed.reserve(faceCount);
+        for (size_t f = 0; f < faceCount; f++) {
+            const BSPReader::FaceRange& face = stream.faces[f];
+            Polygon& polygon = polygons[f];
+            if (!PolygonFromFan(stream.vertices.data() + face.firstVertex, face.vertexCount, polygon.corners)) {
+                // Kept as is; only fans take part in merging
+                polygon.corners.clear();
+                polygon.alive = false;
+                continue;
+            }
+
+            const Vertex& first = polygon.corners[0];
+            GroupKey key;
+            key.texInfo = face.texInfo;
+            key.nx = FloatBits(first.normal.x);
+            key.ny = FloatBits(first.normal.y);
+            key.nz = FloatBits(first.normal.z);
+            key.distance = std::llround(static_cast<double>(Dot(first.normal, first.pos)) * 8.0);
+            keyed.emplace_back(key, static_cast<uint32_t>(f));
+        }
+        std::sort(keyed.begin(), keyed.end());
+
+        std::unordered_map<EdgeKey, uint32_t, EdgeKeyHash> owners;
+        auto addEdges = [&](uint32_t i) {
+            const std::vector<Vertex>& c = polygons[i].corners;
+            for (size_t e = 0; e < c.size(); e++) owners[EdgeOf(c[e], c[(e + 1) % c.size()])] = i;
+        };
+        auto removeEdges = [&](uint32_t i) {
+            const std::vector<Vertex>& c = polygons[i].corners;
+            for (size_t e = 0; e < c.size(); e++) {
+                auto it = owners.find(EdgeOf(c[e], c[(e + 1) % c.size()]));
+                if (it != owners.end() && it->second == i) owners.erase(it);
+            }
+        };
+
+        std::vector<Vertex> merged;
+        std::vector<uint32_t> pending;
+        for (size_t start = 0; start < keyed.size();) {
+            size_t end = start + 1;
+            while (end < keyed.size() && keyed[end].first == keyed[start].first) end++;
+            if (end - start < 2) {
+                start = end;
+                continue;
+            }
+
+            owners.clear();
+            pending.clear();
+            for (size_t g = start; g < end; g++) {
+                addEdges(keyed[g].second);
+                pending.push_back(keyed[g].second);
+            }
+
+            // Greedy: a polygon that absorbed a neighbour is revisited until
+            // none of its edges can be joined any more
+            while (!pending.empty()) {
+                uint32_t i = pending.back();
+                pending.pop_back();
+                if (!polygons[i].alive) continue;
+
+                const std::vector<Vertex>& p = polygons[i].corners;
+                for (size_t k = 0; k < p.size(); k++) {
+                    const Vertex& a = p[k];
+                    const Vertex& b = p[(k + 1) % p.size()];
+                    auto it = owners.find(EdgeOf(b, a));
+                    if (it == owners.end() || it->second == i || !polygons[it->second].alive) continue;
+
+                    uint32_t j = it->second;
+                    const std::vector<Vertex>& q = polygons[j].corners;
+                    size_t m = 0;
+                    while (m < q.size() && !(KeyOf(q[m].pos) == KeyOf(b.pos) &&
+                                             KeyOf(q[(m + 1) % q.size()].pos) == KeyOf(a.pos))) {
+                        m++;
+                    }
+                    if (m == q.size()) continue;
+
+                    size_t removed = 0;
+                    if (!TryMerge(p, k, q, m, options, merged, removed)) continue;
+
+                    removeEdges(i);
+                    removeEdges(j);
+                    polygons[i].corners.swap(merged);
+                    polygons[i].changed = true;
+                    polygons[j].alive = false;
+                    addEdges(i);
+
+                    stats.merges++;
+                    stats.removedVertices += removed;
+                    pending.push_back(i);
+                    break;
+                }
+            }
+            start = end;
+        }
+
+        if (stats.merges == 0) {
+            stats.facesAfter = stats.facesBefore;
+            stats.trianglesAfter = stats.trianglesBefore;
+            return;
+        }
+
+        // Rebuild in source order; untouched faces are copied verbatim
+        std::vector<Vertex> vertices;
+        std::vector<BSPReader::FaceRange> faces;
+        vertices.reserve(stream.vertices.size());
+        faces.reserve(faceCount);
+        for (size_t f = 0; f < faceCount; f++) {
+            const Polygon& polygon = polygons[f];
+            BSPReader::FaceRange face = stream.faces[f];
+            bool mergeable = !polygon.corners.empty();
+            if (mergeable && !polygon.alive) continue;
+
+            uint32_t firstVertex = static_cast<uint32_t>(vertices.size());
+            if (polygon.changed) {
+                AppendFan(polygon.corners, vertices);
+
+                Vec3 center = {0, 0, 0};
+                face.mins = polygon.corners[0].pos;
+                face.maxs = polygon.corners[0].pos;
+                for (const Vertex& v : polygon.corners) {
+                    const Vec3& p = v.pos;
+                    face.mins = {std::min(face.mins.x, p.x), std::min(face.mins.y, p.y), std::min(face.mins.z, p.z)};
+                    face.maxs = {std::max(face.maxs.x, p.x), std::max(face.maxs.y, p.y), std::max(face.maxs.z, p.z)};
+                    center = {center.x + p.x, center.y + p.y, center.z + p.z};
+                }
+                float inv = 1.0f / static_cast<float>(polygon.corners.size());
+                face.center = {center.x * inv, center.y * inv, center.z * inv};
+            } else {
+                vertices.insert(vertices.end(), stream.vertices.begin() + face.firstVertex,
+                                stream.vertices.begin() + face.firstVertex + face.vertexCount);
+            }
+            face.firstVertex = firstVertex;
+            face.vertexCount = static_cast<uint32_t>(vertices.size()) - firstVertex;
+            faces.push_back(face);
+            stats.trianglesAfter += face.vertexCount / 3;
+        }
+        stats.facesAfter = faces.size();
+
+        stream.vertices.swap(vertices);
+        stream.faces.swap(faces);
+    }
+}
+
+void MergeCoplanarFaces(BSPReader::WorldGeometry& world, const FaceMergeOptions& options,
+                        WorkerPool* pool, FaceMergeStats* stats) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<FaceMergeStats> streamStats(world.materials.size());
+    auto mergeStream = [&](size_t m) {
+        MergeStream(world.materials[m], options, streamStats[m]);
+    };
+    if (pool) {
+        pool->ParallelFor(world.materials.size(), mergeStream);
+    } else {
+        for (size_t m = 0; m < world.materials.size(); m++) mergeStream(m);
+    }
+
+    FaceMergeStats total;
+    for (const FaceMergeStats& s : streamStats) {
+        total.facesBefore += s.facesBefore;
+        total.facesAfter += s.facesAfter;
+        total.trianglesBefore += s.trianglesBefore;
+        total.trianglesAfter += s.trianglesAfter;
+        total.merges += s.merges;
+        total.removedVertices += s.removedVertices;
+    }
+
+    world.faceCount -= total.facesBefore - total.facesAfter;
+    world.triangleCount -= total.trianglesBefore - total.trianglesAfter;
+
+    total.milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    if (stats) *stats = total;
+}
+
+} // namespace MeshBuilder
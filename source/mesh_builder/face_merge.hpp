@@ -0,0 +1,35 @@
+#pragma once
+#include "bsp_reader/bsp_reader.hpp"
+#include "worker_pool.hpp"
+#include <cstddef>
+
+namespace MeshBuilder {
+    struct FaceMergeOptions {
+        // Merged polygons never grow past this on any axis, so chunk
+        // assignment and culling bounds stay as tight as the source faces
+        float maxExtent = 2048.0f;
+        // Sine of the angle below which a corner left on a merged edge is
+        // treated as straight and dropped
+        float collinearTolerance = 1e-4f;
+    };
+
+    struct FaceMergeStats {
+        size_t facesBefore = 0;
+        size_t facesAfter = 0;
+        size_t trianglesBefore = 0;
+        size_t trianglesAfter = 0;
+        size_t merges = 0;
+        size_t removedVertices = 0;  // Corners dropped from merged edges
+        double milliseconds = 0.0;
+    };
+
+    // Merges adjacent brush faces of each material stream that share a plane
+    // and texinfo into larger convex polygons and re-fans them. Faces only
+    // join across a full shared edge, and a shared texinfo means both sides
+    // use the same texture projection, so UVs stay continuous. Every output
+    // corner is an input corner with its original UV and normal.
+    // Expects the fan-triangulated faces DecodeWorld emits: run it before
+    // BuildDisplacements. pool == nullptr runs on the calling thread.
+    void MergeCoplanarFaces(BSPReader::WorldGeometry& world, const FaceMergeOptions& options,
+                            WorkerPool* pool, FaceMergeStats* stats = nullptr);
+}
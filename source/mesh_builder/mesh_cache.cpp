@@ -0,0 +1,376 @@
+#include "mesh_cache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace MeshBuilder {
+
+namespace {
+    const char kCacheMagic[4] = {'R', 'T', 'X', 'C'};
+
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t mapCRC;
+        uint32_t paramsHash;
+        uint64_t mapSize;
+        uint32_t materialCount;
+        uint32_t meshCount;
+        uint64_t payloadSize;  // Bytes following the header
+        uint32_t payloadCRC;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(CacheHeader) == 48, "CacheHeader must be 48 bytes");
+
+    struct CacheMaterialRecord {
+        uint32_t surfaceFlags;
+        uint32_t nameOffset;  // Into the string blob
+        uint32_t nameLength;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(CacheMaterialRecord) == 16, "CacheMaterialRecord must be 16 bytes");
+
+    struct CacheMeshRecord {
+        int64_t chunkKey;
+        int32_t chunkX, chunkY, chunkZ;
+        uint32_t material;
+        uint32_t part;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t indexSize;
+        Vec3 mins, maxs;
+        uint64_t vertexOffset;  // From the start of the file
+        uint64_t indexOffset;
+        uint32_t lodCount;
+        uint32_t lodIndexCount[kMaxChunkLods];  // Same index size as the full mesh
+        uint64_t lodIndexOffset[kMaxChunkLods];
+    };
+    static_assert(sizeof(CacheMeshRecord) == 120, "CacheMeshRecord must be 120 bytes");
+    static_assert(sizeof(Vertex) == 32, "cached vertex layout changed, bump kChunkCacheVersion");
+
+    size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    void WriteIndices(std::vector<uint8_t>& file, uint64_t offset, const IndexBuffer& indices) {
+        if (indices.Is16Bit() && !indices.Empty()) {
+            std::memcpy(&file[offset], indices.Indices16().data(), indices.Size() * sizeof(uint16_t));
+        } else if (!indices.Empty()) {
+            std::memcpy(&file[offset], indices.Indices32().data(), indices.Size() * sizeof(uint32_t));
+        }
+    }
+
+    // Every index must address one of the mesh's vertices; a file that
+    // passes the CRC can still have been written wrong or on purpose
+    template<typename Index>
+    bool IndicesInRange(const uint8_t* data, uint32_t count, uint32_t vertexCount) {
+        const Index* indices = reinterpret_cast<const Index*>(data);
+        for (uint32_t i = 0; i < count; i++) {
+            if (indices[i] >= vertexCount) return false;
+        }
+        return true;
+    }
+
+    bool IndicesInRange(const uint8_t* data, uint32_t count, uint32_t indexSize, uint32_t vertexCount) {
+        if (count % 3 != 0) return false;
+        return indexSize == 2 ? IndicesInRange<uint16_t>(data, count, vertexCount)
+                              : IndicesInRange<uint32_t>(data, count, vertexCount);
+    }
+
+    struct Crc32Table {
+        uint32_t entries[256];
+        Crc32Table() {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                entries[i] = c;
+            }
+        }
+    };
+
+    // FNV-1a over explicitly listed fields, so struct padding never leaks in
+    struct OptionHasher {
+        uint32_t hash = 2166136261u;
+
+        void Bytes(const void* data, size_t size) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; i++) {
+                hash ^= bytes[i];
+                hash *= 16777619u;
+            }
+        }
+        template<typename T>
+        void Value(T value) { Bytes(&value, sizeof(value)); }
+        void Vector(const Vec3& v) { Value(v.x); Value(v.y); Value(v.z); }
+    };
+}
+
+uint32_t Crc32(const void* data, size_t size, uint32_t crc) {
+    static const Crc32Table table;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table.entries[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t HashChunkBuildOptions(const ChunkBuildOptions& options) {
+    OptionHasher hasher;
+    hasher.Value(options.chunkSize);
+    hasher.Value(options.maxVertices);
+    hasher.Value(options.weldVertices);
+    hasher.Value(options.maxIndices);
+    hasher.Value(options.weld.positionTolerance);
+    hasher.Value(options.weld.normalTolerance);
+    hasher.Value(options.weld.uvTolerance);
+    hasher.Value(options.optimizeMeshes);
+    hasher.Value(options.lodLevels);
+    if (options.lodLevels > 0) hasher.Value(options.lodMaxError);
+
+    hasher.Value(options.hasExclusionSphere);
+    if (options.hasExclusionSphere) {
+        hasher.Vector(options.exclusionCenter);
+        hasher.Value(options.exclusionRadius);
+    }
+
+    hasher.Value(options.hasBounds);
+    if (options.hasBounds) {
+        hasher.Vector(options.boundsMins);
+        hasher.Vector(options.boundsMaxs);
+    }
+
+    hasher.Value(options.skipSkyMaterials);
+    hasher.Value(options.skipSeparateRegions);
+    if (options.skipSeparateRegions) {
+        hasher.Value(options.regions.gap);
+        hasher.Value(options.regions.separationDistance);
+    }
+    return hasher.hash;
+}
+
+bool WriteChunkMeshCache(const std::string& path, const ChunkCacheKey& key,
+                         const std::vector<CachedMaterial>& materials,
+                         const std::vector<ChunkMesh>& meshes, std::string& error) {
+    // Lay out records, string blob, then 16-byte aligned vertex/index blocks
+    size_t offset = sizeof(CacheHeader);
+    const size_t materialOffset = offset;
+    offset += materials.size() * sizeof(CacheMaterialRecord);
+    const size_t meshOffset = offset;
+    offset += meshes.size() * sizeof(CacheMeshRecord);
+
+    const size_t stringOffset = offset;
+    for (const CachedMaterial& material : materials) offset += material.name.size();
+
+    std::vector<CacheMeshRecord> records(meshes.size());
+    for (size_t i = 0; i < meshes.size(); i++) {
+        const ChunkMesh& mesh = meshes[i];
+        CacheMeshRecord& record = records[i];
+        std::memset(&record, 0, sizeof(record));
+
+        record.chunkKey = mesh.chunkKey;
+        record.chunkX = mesh.chunkX;
+        record.chunkY = mesh.chunkY;
+        record.chunkZ = mesh.chunkZ;
+        record.material = mesh.material;
+        record.part = mesh.part;
+        record.mins = mesh.mins;
+        record.maxs = mesh.maxs;
+        record.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+        record.indexCount = static_cast<uint32_t>(mesh.indices.Size());
+        record.indexSize = static_cast<uint32_t>(mesh.indices.IndexSize());
+
+        offset = AlignUp(offset, 16);
+        record.vertexOffset = offset;
+        offset += mesh.vertices.size() * sizeof(Vertex);
+
+        offset = AlignUp(offset, 16);
+        record.indexOffset = offset;
+        offset += mesh.indices.Size() * mesh.indices.IndexSize();
+
+        record.lodCount = static_cast<uint32_t>(std::min<size_t>(mesh.lods.size(), kMaxChunkLods));
+        for (uint32_t level = 0; level < record.lodCount; level++) {
+            offset = AlignUp(offset, 16);
+            record.lodIndexCount[level] = static_cast<uint32_t>(mesh.lods[level].Size());
+            record.lodIndexOffset[level] = offset;
+            offset += mesh.lods[level].Size() * mesh.lods[level].IndexSize();
+        }
+    }
+
+    std::vector<uint8_t> file(offset, 0);
+
+    for (size_t i = 0, nameCursor = stringOffset; i < materials.size(); i++) {
+        CacheMaterialRecord record = {};
+        record.surfaceFlags = materials[i].surfaceFlags;
+        record.nameOffset = static_cast<uint32_t>(nameCursor);
+        record.nameLength = static_cast<uint32_t>(materials[i].name.size());
+        std::memcpy(&file[materialOffset + i * sizeof(record)], &record, sizeof(record));
+        std::memcpy(&file[nameCursor], materials[i].name.data(), record.nameLength);
+        nameCursor += record.nameLength;
+    }
+
+    for (size_t i = 0; i < meshes.size(); i++) {
+        const ChunkMesh& mesh = meshes[i];
+        const CacheMeshRecord& record = records[i];
+        std::memcpy(&file[meshOffset + i * sizeof(record)], &record, sizeof(record));
+
+        if (!mesh.vertices.empty()) {
+            std::memcpy(&file[record.vertexOffset], mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+        }
+        WriteIndices(file, record.indexOffset, mesh.indices);
+        for (uint32_t level = 0; level < record.lodCount; level++) {
+            WriteIndices(file, record.lodIndexOffset[level], mesh.lods[level]);
+        }
+    }
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, kCacheMagic, sizeof(kCacheMagic));
+    header.version = kChunkCacheVersion;
+    header.mapCRC = key.mapCRC;
+    header.paramsHash = key.paramsHash;
+    header.mapSize = key.mapSize;
+    header.materialCount = static_cast<uint32_t>(materials.size());
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+    header.payloadSize = file.size() - sizeof(CacheHeader);
+    header.payloadCRC = Crc32(file.data() + sizeof(CacheHeader), header.payloadSize);
+    std::memcpy(file.data(), &header, sizeof(header));
+
+    const std::string tempPath = path + ".tmp";
+    FILE* out = std::fopen(tempPath.c_str(), "wb");
+    if (!out) {
+        error = "cannot open " + tempPath + " for writing";
+        return false;
+    }
+
+    bool written = std::fwrite(file.data(), 1, file.size(), out) == file.size();
+    written = std::fclose(out) == 0 && written;
+    if (!written) {
+        std::remove(tempPath.c_str());
+        error = "failed to write " + tempPath;
+        return false;
+    }
+
+    // rename() does not replace an existing file on Windows
+    std::remove(path.c_str());
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        error = "failed to move the cache into place at " + path;
+        return false;
+    }
+
+    return true;
+}
+
+bool ChunkMeshCache::Open(const std::string& path, const ChunkCacheKey& key, std::string& error) {
+    Close();
+
+    if (!m_file.Open(path)) {
+        error = "no cache file";
+        return false;
+    }
+
+    auto fail = [&](const char* reason) {
+        error = reason;
+        Close();
+        return false;
+    };
+
+    const uint8_t* data = m_file.Data();
+    const size_t size = m_file.Size();
+    if (size < sizeof(CacheHeader)) return fail("cache file is truncated");
+
+    CacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, kCacheMagic, sizeof(kCacheMagic)) != 0) return fail("not a chunk cache file");
+    if (header.version != kChunkCacheVersion) return fail("cache was written by a different version");
+    if (header.mapCRC != key.mapCRC || header.mapSize != key.mapSize) return fail("map has changed since the cache was written");
+    if (header.paramsHash != key.paramsHash) return fail("builder settings have changed");
+    if (header.payloadSize != size - sizeof(CacheHeader)) return fail("cache file is truncated");
+    if (Crc32(data + sizeof(CacheHeader), header.payloadSize) != header.payloadCRC) return fail("cache checksum mismatch");
+
+    const uint64_t tableBytes = static_cast<uint64_t>(header.materialCount) * sizeof(CacheMaterialRecord) +
+                                static_cast<uint64_t>(header.meshCount) * sizeof(CacheMeshRecord);
+    if (tableBytes > header.payloadSize) return fail("cache tables are out of bounds");
+
+    const uint8_t* materialRecords = data + sizeof(CacheHeader);
+    m_materials.resize(header.materialCount);
+    for (uint32_t i = 0; i < header.materialCount; i++) {
+        CacheMaterialRecord record;
+        std::memcpy(&record, materialRecords + i * sizeof(record), sizeof(record));
+        if (static_cast<uint64_t>(record.nameOffset) + record.nameLength > size) return fail("material name is out of bounds");
+
+        m_materials[i].name.assign(reinterpret_cast<const char*>(data + record.nameOffset), record.nameLength);
+        m_materials[i].surfaceFlags = record.surfaceFlags;
+    }
+
+    const uint8_t* meshRecords = materialRecords + header.materialCount * sizeof(CacheMaterialRecord);
+    m_meshes.resize(header.meshCount);
+    for (uint32_t i = 0; i < header.meshCount; i++) {
+        CacheMeshRecord record;
+        std::memcpy(&record, meshRecords + i * sizeof(record), sizeof(record));
+
+        const uint64_t vertexBytes = static_cast<uint64_t>(record.vertexCount) * sizeof(Vertex);
+        const uint64_t indexBytes = static_cast<uint64_t>(record.indexCount) * record.indexSize;
+        if (record.material >= header.materialCount ||
+            (record.indexCount > 0 && record.indexSize != 2 && record.indexSize != 4) ||
+            record.vertexOffset % 16 != 0 || record.indexOffset % 4 != 0 ||
+            record.vertexOffset > size || vertexBytes > size - record.vertexOffset ||
+            record.indexOffset > size || indexBytes > size - record.indexOffset) {
+            return fail("mesh record is out of bounds");
+        }
+
+        if (record.lodCount > kMaxChunkLods || (record.lodCount > 0 && record.indexCount == 0)) {
+            return fail("mesh record is out of bounds");
+        }
+        for (uint32_t level = 0; level < record.lodCount; level++) {
+            const uint64_t lodBytes = static_cast<uint64_t>(record.lodIndexCount[level]) * record.indexSize;
+            if (record.lodIndexOffset[level] % 4 != 0 || record.lodIndexOffset[level] > size ||
+                lodBytes > size - record.lodIndexOffset[level]) {
+                return fail("mesh record is out of bounds");
+            }
+        }
+
+        if (!IndicesInRange(data + record.indexOffset, record.indexCount, record.indexSize, record.vertexCount)) {
+            return fail("mesh indices are out of range");
+        }
+        for (uint32_t level = 0; level < record.lodCount; level++) {
+            if (!IndicesInRange(data + record.lodIndexOffset[level], record.lodIndexCount[level], record.indexSize,
+                                record.vertexCount)) {
+                return fail("mesh indices are out of range");
+            }
+        }
+
+        CachedChunkMesh& mesh = m_meshes[i];
+        mesh.chunkKey = record.chunkKey;
+        mesh.chunkX = record.chunkX;
+        mesh.chunkY = record.chunkY;
+        mesh.chunkZ = record.chunkZ;
+        mesh.material = record.material;
+        mesh.part = record.part;
+        mesh.mins = record.mins;
+        mesh.maxs = record.maxs;
+        mesh.vertices = reinterpret_cast<const Vertex*>(data + record.vertexOffset);
+        mesh.vertexCount = record.vertexCount;
+        mesh.indices = record.indexCount ? data + record.indexOffset : nullptr;
+        mesh.indexCount = record.indexCount;
+        mesh.indexSize = record.indexSize;
+        mesh.lodCount = record.lodCount;
+        for (uint32_t level = 0; level < kMaxChunkLods; level++) {
+            bool present = level < record.lodCount;
+            mesh.lodIndices[level] = present ? data + record.lodIndexOffset[level] : nullptr;
+            mesh.lodIndexCounts[level] = present ? record.lodIndexCount[level] : 0;
+        }
+    }
+
+    return true;
+}
+
+void ChunkMeshCache::Close() {
+    m_meshes.clear();
+    m_materials.clear();
+    m_file.Close();
+}
+
+} // namespace MeshBuilder
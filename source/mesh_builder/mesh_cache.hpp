@@ -0,0 +1,70 @@
+#pragma once
+#include "chunk_builder.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Versioned on-disk cache of built chunk meshes. The file is memory-mapped
+// on load and the vertex/index data is used in place; anything that does not
+// match the expected map or builder parameters is treated as a miss.
+namespace MeshBuilder {
+    // Bump whenever the file layout or the builder output changes
+    const uint32_t kChunkCacheVersion = 4;
+
+    uint32_t Crc32(const void* data, size_t size, uint32_t crc = 0);
+
+    // Stable hash over every option that affects the built meshes
+    uint32_t HashChunkBuildOptions(const ChunkBuildOptions& options);
+
+    struct ChunkCacheKey {
+        uint32_t mapCRC = 0;
+        uint64_t mapSize = 0;
+        uint32_t paramsHash = 0;
+    };
+
+    struct CachedMaterial {
+        std::string name;
+        uint32_t surfaceFlags;
+    };
+
+    // A ChunkMesh whose vertex and index data live inside the mapped file
+    struct CachedChunkMesh {
+        int64_t chunkKey;
+        int32_t chunkX, chunkY, chunkZ;
+        uint32_t material;  // Index into ChunkMeshCache::Materials()
+        uint32_t part;
+        Vec3 mins, maxs;
+
+        const Vertex* vertices;
+        uint32_t vertexCount;
+        const void* indices;  // nullptr when the mesh is not indexed
+        uint32_t indexCount;
+        uint32_t indexSize;   // 2 or 4
+
+        // Simplified index buffers, same index size as indices
+        uint32_t lodCount;
+        const void* lodIndices[kMaxChunkLods];
+        uint32_t lodIndexCounts[kMaxChunkLods];
+    };
+
+    // Writes to a temporary file first and renames it over path
+    bool WriteChunkMeshCache(const std::string& path, const ChunkCacheKey& key,
+                             const std::vector<CachedMaterial>& materials,
+                             const std::vector<ChunkMesh>& meshes, std::string& error);
+
+    class ChunkMeshCache {
+    public:
+        // Fails on a missing, corrupt or stale file; error says which
+        bool Open(const std::string& path, const ChunkCacheKey& key, std::string& error);
+        void Close();
+
+        bool IsOpen() const { return m_file.Data() != nullptr; }
+        const std::vector<CachedMaterial>& Materials() const { return m_materials; }
+        const std::vector<CachedChunkMesh>& Meshes() const { return m_meshes; }
+
+    private:
+        BSPReader::MappedFile m_file;
+        std::vector<CachedMaterial> m_materials;
+        std::vector<CachedChunkMesh> m_meshes;
+    };
+}
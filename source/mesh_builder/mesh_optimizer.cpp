@@ -0,0 +1,332 @@
+#include "mesh_optimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace MeshBuilder {
+
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount,
+                                    size_t vertexCount, unsigned cacheSize) {
+    VertexCacheStats stats;
+    stats.triangles = indexCount / 3;
+
+    // A vertex is in the FIFO while fewer than cacheSize misses happened since it entered
+    std::vector<size_t> timestamps(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+    size_t time = cacheSize + 1;
+
+    for (size_t i = 0; i < indexCount; i++) {
+        uint32_t index = indices[i];
+        if (time - timestamps[index] > cacheSize) {
+            timestamps[index] = time++;
+            stats.misses++;
+        }
+        if (!referenced[index]) {
+            referenced[index] = true;
+            stats.vertices++;
+        }
+    }
+
+    return stats;
+}
+
+namespace {
+    const int kCacheSize = 32;
+
+    // Scores from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+    float VertexScore(int cachePosition, uint32_t remainingTriangles) {
+        if (remainingTriangles == 0) return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // The last triangle's vertices get a fixed score so it is not reused immediately
+                score = 0.75f;
+            } else {
+                const float scaler = 1.0f / (kCacheSize - 3);
+                score = std::pow(1.0f - (cachePosition - 3) * scaler, 1.5f);
+            }
+        }
+
+        // Favour vertices with few triangles left so lone triangles are not stranded
+        score += 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+        return score;
+    }
+}
+
+void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+                         size_t vertexCount) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) return;
+
+    // Vertex -> triangle adjacency in CSR form
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) offsets[indices[i] + 1]++;
+    for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) {
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+        }
+    }
+
+    std::vector<uint32_t> remaining(vertexCount);
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        remaining[v] = offsets[v + 1] - offsets[v];
+        vertexScore[v] = VertexScore(-1, remaining[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+                           vertexScore[indices[t * 3 + 2]];
+    }
+
+    // LRU cache with room for the three vertices pushed by each new triangle
+    uint32_t cache[kCacheSize + 3];
+    int cacheCount = 0;
+
+    size_t input = 0;
+    size_t output = 0;
+    int64_t current = 0;
+
+    // Start from the best-scoring triangle overall
+    for (size_t t = 1; t < triangleCount; t++) {
+        if (triangleScore[t] > triangleScore[current]) current = static_cast<int64_t>(t);
+    }
+
+    while (current >= 0) {
+        const uint32_t* tri = &indices[current * 3];
+        destination[output++] = tri[0];
+        destination[output++] = tri[1];
+        destination[output++] = tri[2];
+        emitted[current] = true;
+
+        // Move the triangle's vertices to the front of the cache
+        uint32_t newCache[kCacheSize + 3];
+        int newCount = 0;
+        for (int k = 0; k < 3; k++) newCache[newCount++] = tri[k];
+        for (int c = 0; c < cacheCount; c++) {
+            uint32_t v = cache[c];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) newCache[newCount++] = v;
+        }
+
+        // Detach the emitted triangle from its vertices
+        for (int k = 0; k < 3; k++) {
+            uint32_t v = tri[k];
+            uint32_t* begin = &adjacency[offsets[v]];
+            uint32_t* end = begin + remaining[v];
+            uint32_t* found = std::find(begin, end, static_cast<uint32_t>(current));
+            if (found != end) {
+                std::swap(*found, *(end - 1));
+                remaining[v]--;
+            }
+        }
+
+        // Rescore every vertex that was or is in the cache, and the triangles they touch
+        int64_t best = -1;
+        float bestScore = -1.0f;
+        for (int c = 0; c < newCount; c++) {
+            uint32_t v = newCache[c];
+            int position = c < kCacheSize ? c : -1;
+            cachePosition[v] = position;
+
+            float score = VertexScore(position, remaining[v]);
+            float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+
+            for (uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; a++) {
+                uint32_t t = adjacency[a];
+                triangleScore[t] += delta;
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, kCacheSize);
+        std::copy(newCache, newCache + cacheCount, cache);
+
+        // Nothing in the cache has triangles left: continue with the next unemitted one
+        if (best < 0) {
+            while (input < triangleCount && emitted[input]) input++;
+            best = input < triangleCount ? static_cast<int64_t>(input) : -1;
+        }
+        current = best;
+    }
+}
+
+namespace {
+    struct Cluster {
+        size_t first;  // First index
+        size_t count;  // Index count
+        float sortKey;
+    };
+
+    // Cache misses of triangle t in a FIFO simulation sharing timestamps
+    unsigned TriangleMisses(const uint32_t* tri, std::vector<size_t>& timestamps, size_t& time,
+                            unsigned cacheSize) {
+        unsigned misses = 0;
+        for (int k = 0; k < 3; k++) {
+            if (time - timestamps[tri[k]] > cacheSize) {
+                timestamps[tri[k]] = time++;
+                misses++;
+            }
+        }
+        return misses;
+    }
+}
+
+void OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+                      const Vertex* vertices, size_t vertexCount, float threshold) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) return;
+
+    const unsigned cacheSize = 16;
+
+    // Hard boundaries: triangles whose three vertices all miss start a new cluster
+    std::vector<size_t> hard;
+    {
+        std::vector<size_t> timestamps(vertexCount, 0);
+        size_t time = cacheSize + 1;
+        for (size_t t = 0; t < triangleCount; t++) {
+            if (TriangleMisses(&indices[t * 3], timestamps, time, cacheSize) == 3) hard.push_back(t);
+        }
+        if (hard.empty() || hard[0] != 0) hard.insert(hard.begin(), 0);
+    }
+
+    // Soft boundaries: cut a hard cluster wherever the running ACMR of the
+    // current piece is within threshold of the whole cluster's ACMR
+    std::vector<Cluster> clusters;
+    std::vector<size_t> timestamps(vertexCount, 0);
+    size_t time = cacheSize + 1;
+
+    for (size_t h = 0; h < hard.size(); h++) {
+        size_t start = hard[h];
+        size_t end = h + 1 < hard.size() ? hard[h + 1] : triangleCount;
+
+        time += cacheSize + 1;
+        size_t clusterMisses = 0;
+        for (size_t t = start; t < end; t++) {
+            clusterMisses += TriangleMisses(&indices[t * 3], timestamps, time, cacheSize);
+        }
+        float clusterThreshold = threshold * static_cast<float>(clusterMisses) / (end - start);
+
+        time += cacheSize + 1;
+        size_t last = start;
+        size_t misses = 0;
+        for (size_t t = start; t < end; t++) {
+            misses += TriangleMisses(&indices[t * 3], timestamps, time, cacheSize);
+            if (t + 1 < end && static_cast<float>(misses) / (t - last + 1) <= clusterThreshold) {
+                clusters.push_back({last * 3, (t - last + 1) * 3, 0.0f});
+                last = t + 1;
+                misses = 0;
+                time += cacheSize + 1;
+            }
+        }
+        clusters.push_back({last * 3, (end - last) * 3, 0.0f});
+    }
+
+    // Mesh centroid over referenced vertices
+    double meshCenter[3] = {0, 0, 0};
+    for (size_t i = 0; i < indexCount; i++) {
+        const Vec3& p = vertices[indices[i]].pos;
+        meshCenter[0] += p.x;
+        meshCenter[1] += p.y;
+        meshCenter[2] += p.z;
+    }
+    for (double& c : meshCenter) c /= static_cast<double>(indexCount);
+
+    // Area-weighted cluster centroid and normal; clusters facing away from
+    // the mesh center occlude the rest and are drawn first
+    for (Cluster& cluster : clusters) {
+        double center[3] = {0, 0, 0};
+        double normal[3] = {0, 0, 0};
+        double totalArea = 0.0;
+
+        for (size_t i = cluster.first; i < cluster.first + cluster.count; i += 3) {
+            const Vec3& a = vertices[indices[i]].pos;
+            const Vec3& b = vertices[indices[i + 1]].pos;
+            const Vec3& c = vertices[indices[i + 2]].pos;
+
+            double e1[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+            double e2[3] = {c.x - a.x, c.y - a.y, c.z - a.z};
+            double n[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                           e1[2] * e2[0] - e1[0] * e2[2],
+                           e1[0] * e2[1] - e1[1] * e2[0]};
+            double area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+            center[0] += (a.x + b.x + c.x) / 3.0 * area;
+            center[1] += (a.y + b.y + c.y) / 3.0 * area;
+            center[2] += (a.z + b.z + c.z) / 3.0 * area;
+            normal[0] += n[0];
+            normal[1] += n[1];
+            normal[2] += n[2];
+            totalArea += area;
+        }
+
+        double normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (totalArea <= 0.0 || normalLength <= 0.0) continue;
+
+        double key = 0.0;
+        for (int k = 0; k < 3; k++) {
+            key += (center[k] / totalArea - meshCenter[k]) * (normal[k] / normalLength);
+        }
+        cluster.sortKey = static_cast<float>(key);
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+        return a.sortKey > b.sortKey;
+    });
+
+    size_t output = 0;
+    for (const Cluster& cluster : clusters) {
+        std::copy(indices + cluster.first, indices + cluster.first + cluster.count, destination + output);
+        output += cluster.count;
+    }
+}
+
+size_t OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    const uint32_t unassigned = ~0u;
+    std::vector<uint32_t> remap(vertices.size(), unassigned);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+
+    for (uint32_t& index : indices) {
+        if (remap[index] == unassigned) {
+            remap[index] = static_cast<uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    vertices.swap(reordered);
+    return vertices.size();
+}
+
+void OptimizeMesh(std::vector<Vertex>& vertices, IndexBuffer& indices, MeshOptimizeStats* stats) {
+    std::vector<uint32_t> source;
+    indices.CopyTo(source);
+    if (source.size() < 3) return;
+
+    MeshOptimizeStats local;
+    local.before = AnalyzeVertexCache(source.data(), source.size(), vertices.size());
+
+    std::vector<uint32_t> ordered(source.size());
+    OptimizeVertexCache(ordered.data(), source.data(), source.size(), vertices.size());
+    OptimizeOverdraw(source.data(), ordered.data(), ordered.size(), vertices.data(), vertices.size());
+    OptimizeVertexFetch(vertices, source);
+
+    local.after = AnalyzeVertexCache(source.data(), source.size(), vertices.size());
+    indices.Assign(source, vertices.size());
+
+    if (stats) stats->Add(local);
+}
+
+} // namespace MeshBuilder
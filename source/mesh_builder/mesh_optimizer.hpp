@@ -0,0 +1,57 @@
+#pragma once
+#include "vertex_weld.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace MeshBuilder {
+    // Post-transform cache efficiency of an index buffer, measured against a
+    // simulated FIFO cache. ACMR = misses per triangle (0.5 is ideal for a
+    // regular grid, 3.0 is no reuse), ATVR = misses per referenced vertex
+    // (1.0 is ideal).
+    struct VertexCacheStats {
+        size_t triangles = 0;
+        size_t vertices = 0;
+        size_t misses = 0;
+
+        float ACMR() const { return triangles ? static_cast<float>(misses) / triangles : 0.0f; }
+        float ATVR() const { return vertices ? static_cast<float>(misses) / vertices : 0.0f; }
+
+        void Add(const VertexCacheStats& other) {
+            triangles += other.triangles;
+            vertices += other.vertices;
+            misses += other.misses;
+        }
+    };
+
+    VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount,
+                                        size_t vertexCount, unsigned cacheSize = 16);
+
+    // Forsyth's linear-speed vertex cache reorder. destination must not alias indices.
+    void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+                             size_t vertexCount);
+
+    // Splits a cache-optimized index buffer into clusters at points where
+    // the cache efficiency stays within threshold of the original, then orders
+    // the clusters so outward-facing ones are drawn first. destination must
+    // not alias indices.
+    void OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+                          const Vertex* vertices, size_t vertexCount, float threshold = 1.05f);
+
+    // Reorders vertices into first-use order and rewrites the indices to match.
+    // Unreferenced vertices are dropped. Returns the new vertex count.
+    size_t OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    struct MeshOptimizeStats {
+        VertexCacheStats before;
+        VertexCacheStats after;
+
+        void Add(const MeshOptimizeStats& other) {
+            before.Add(other.before);
+            after.Add(other.after);
+        }
+    };
+
+    // Runs the cache reorder, overdraw sort and fetch remap on an indexed mesh
+    void OptimizeMesh(std::vector<Vertex>& vertices, IndexBuffer& indices,
+                      MeshOptimizeStats* stats = nullptr);
+}
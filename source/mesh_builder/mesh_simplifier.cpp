@@ -0,0 +1,270 @@
+#include "mesh_simplifier.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+namespace MeshBuilder {
+
+namespace {
+    // Symmetric 4x4 plane quadric stored as its 10 unique terms, plus the
+    // accumulated triangle area so the error can be normalized to units
+    struct Quadric {
+        double a00 = 0, a11 = 0, a22 = 0, a01 = 0, a02 = 0, a12 = 0;
+        double b0 = 0, b1 = 0, b2 = 0, c = 0;
+        double weight = 0;
+
+        void AddPlane(double nx, double ny, double nz, double d, double w) {
+            a00 += w * nx * nx; a11 += w * ny * ny; a22 += w * nz * nz;
+            a01 += w * nx * ny; a02 += w * nx * nz; a12 += w * ny * nz;
+            b0 += w * nx * d; b1 += w * ny * d; b2 += w * nz * d;
+            c += w * d * d;
+            weight += w;
+        }
+
+        void Add(const Quadric& o) {
+            a00 += o.a00; a11 += o.a11; a22 += o.a22;
+            a01 += o.a01; a02 += o.a02; a12 += o.a12;
+            b0 += o.b0; b1 += o.b1; b2 += o.b2;
+            c += o.c;
+            weight += o.weight;
+        }
+
+        // Area-weighted sum of squared plane distances at p
+        double Evaluate(const Vec3& p) const {
+            double x = p.x, y = p.y, z = p.z;
+            double r = a00 * x * x + a11 * y * y + a22 * z * z +
+                       2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                       2.0 * (b0 * x + b1 * y + b2 * z) + c;
+            return std::max(r, 0.0);
+        }
+    };
+
+    struct Collapse {
+        uint32_t from;   // Vertex that moves
+        uint32_t to;     // Vertex it lands on
+        float error;     // RMS plane distance in units
+    };
+
+    uint64_t EdgeKey(uint32_t a, uint32_t b) {
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    size_t CountEdge(const std::vector<uint64_t>& sortedEdges, uint32_t a, uint32_t b) {
+        auto range = std::equal_range(sortedEdges.begin(), sortedEdges.end(), EdgeKey(a, b));
+        return static_cast<size_t>(range.second - range.first);
+    }
+
+    Vec3 TriangleCross(const Vec3& a, const Vec3& b, const Vec3& c) {
+        Vec3 e1 = {b.x - a.x, b.y - a.y, b.z - a.z};
+        Vec3 e2 = {c.x - a.x, c.y - a.y, c.z - a.z};
+        return {e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x};
+    }
+
+    // Maps every vertex to the first vertex sharing its exact position and
+    // counts the vertices (wedges) at each position
+    void BuildPositionIds(const Vertex* vertices, size_t vertexCount,
+                          std::vector<uint32_t>& positionId, std::vector<uint32_t>& wedges) {
+        std::vector<uint32_t> order(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++) order[i] = static_cast<uint32_t>(i);
+
+        auto bits = [&](uint32_t v) {
+            uint32_t out[3];
+            std::memcpy(out, &vertices[v].pos, sizeof(out));
+            return std::make_tuple(out[0], out[1], out[2]);
+        };
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            auto ka = bits(a), kb = bits(b);
+            return ka != kb ? ka < kb : a < b;
+        });
+
+        positionId.assign(vertexCount, 0);
+        wedges.assign(vertexCount, 0);
+        for (size_t i = 0; i < vertexCount;) {
+            size_t end = i + 1;
+            while (end < vertexCount && bits(order[end]) == bits(order[i])) end++;
+            for (size_t k = i; k < end; k++) positionId[order[k]] = order[i];
+            wedges[order[i]] = static_cast<uint32_t>(end - i);
+            i = end;
+        }
+    }
+}
+
+size_t SimplifyMesh(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+                    const Vertex* vertices, size_t vertexCount,
+                    const SimplifyOptions& options, SimplifyStats* stats) {
+    SimplifyStats localStats;
+    indexCount -= indexCount % 3;
+
+    std::vector<uint32_t> current(indices, indices + indexCount);
+    std::vector<uint32_t> positionId, wedges;
+    BuildPositionIds(vertices, vertexCount, positionId, wedges);
+
+    // Lock positions on open or non-manifold edges and on attribute seams
+    std::vector<uint64_t> edges;
+    edges.reserve(indexCount);
+    for (size_t t = 0; t < indexCount; t += 3) {
+        for (int e = 0; e < 3; e++) {
+            uint32_t a = positionId[current[t + e]];
+            uint32_t b = positionId[current[t + (e + 1) % 3]];
+            if (a != b) edges.push_back(EdgeKey(a, b));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    std::vector<uint8_t> locked(vertexCount, 0);
+    for (size_t i = 0; i < vertexCount; i++) {
+        if (wedges[positionId[i]] > 1) locked[positionId[i]] = 1;
+    }
+    for (size_t i = 0; i < edges.size();) {
+        size_t end = i + 1;
+        while (end < edges.size() && edges[end] == edges[i]) end++;
+
+        uint32_t a = static_cast<uint32_t>(edges[i] >> 32);
+        uint32_t b = static_cast<uint32_t>(edges[i] & 0xFFFFFFFFu);
+        if (end - i > 1 || CountEdge(edges, b, a) != 1) {
+            locked[a] = 1;
+            locked[b] = 1;
+        }
+        i = end;
+    }
+    for (size_t i = 0; i < vertexCount; i++) {
+        if (positionId[i] == i && locked[i]) localStats.lockedVertices++;
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t t = 0; t < indexCount; t += 3) {
+        const Vec3& p0 = vertices[current[t]].pos;
+        Vec3 n = TriangleCross(p0, vertices[current[t + 1]].pos, vertices[current[t + 2]].pos);
+        double length = std::sqrt(static_cast<double>(n.x) * n.x + static_cast<double>(n.y) * n.y +
+                                  static_cast<double>(n.z) * n.z);
+        if (length <= 0.0) continue;
+
+        double nx = n.x / length, ny = n.y / length, nz = n.z / length;
+        double d = -(nx * p0.x + ny * p0.y + nz * p0.z);
+        for (int k = 0; k < 3; k++) {
+            quadrics[positionId[current[t + k]]].AddPlane(nx, ny, nz, d, length * 0.5);
+        }
+    }
+
+    std::vector<uint32_t> triangleStart(vertexCount + 1);
+    std::vector<uint32_t> triangleList;
+    std::vector<uint8_t> touched(vertexCount);
+    std::vector<uint32_t> collapseTo(vertexCount);
+    std::vector<Collapse> collapses;
+
+    const size_t target = options.targetIndexCount - options.targetIndexCount % 3;
+    while (current.size() > target) {
+        // Triangles around each vertex
+        std::fill(triangleStart.begin(), triangleStart.end(), 0);
+        for (uint32_t index : current) triangleStart[index + 1]++;
+        for (size_t v = 0; v < vertexCount; v++) triangleStart[v + 1] += triangleStart[v];
+        triangleList.resize(current.size());
+        {
+            std::vector<uint32_t> fill(triangleStart.begin(), triangleStart.end() - 1);
+            for (size_t i = 0; i < current.size(); i++) {
+                triangleList[fill[current[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        // Every free vertex may move onto any vertex it shares an edge with
+        collapses.clear();
+        for (size_t t = 0; t < current.size(); t += 3) {
+            for (int e = 0; e < 3; e++) {
+                for (int dir = 0; dir < 2; dir++) {
+                    uint32_t from = current[t + (dir ? (e + 1) % 3 : e)];
+                    uint32_t to = current[t + (dir ? e : (e + 1) % 3)];
+                    if (locked[positionId[from]] || positionId[from] == positionId[to]) continue;
+
+                    Quadric q = quadrics[positionId[from]];
+                    q.Add(quadrics[positionId[to]]);
+                    double error = q.weight > 0.0 ? std::sqrt(q.Evaluate(vertices[to].pos) / q.weight) : 0.0;
+                    if (error <= options.maxError) {
+                        collapses.push_back({from, to, static_cast<float>(error)});
+                    }
+                }
+            }
+        }
+        if (collapses.empty()) break;
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+            if (a.error != b.error) return a.error < b.error;
+            if (a.from != b.from) return a.from < b.from;
+            return a.to < b.to;
+        });
+
+        // Take collapses cheapest first; each one locks its 1-ring for the pass
+        std::fill(touched.begin(), touched.end(), 0);
+        for (size_t v = 0; v < vertexCount; v++) collapseTo[v] = static_cast<uint32_t>(v);
+
+        size_t remaining = current.size();
+        size_t applied = 0;
+        for (const Collapse& collapse : collapses) {
+            if (remaining <= target) break;
+
+            uint32_t from = collapse.from, to = collapse.to;
+            if (touched[positionId[from]] || touched[positionId[to]]) continue;
+
+            const Vec3& landing = vertices[to].pos;
+            bool flips = false;
+            size_t removed = 0;
+            for (uint32_t k = triangleStart[from]; k < triangleStart[from + 1] && !flips; k++) {
+                const uint32_t* tri = &current[triangleList[k] * 3];
+                bool hasTo = false;
+                for (int c = 0; c < 3; c++) hasTo |= positionId[tri[c]] == positionId[to];
+                if (hasTo) {
+                    removed += 3;
+                    continue;
+                }
+
+                Vec3 before[3], after[3];
+                for (int c = 0; c < 3; c++) {
+                    before[c] = vertices[tri[c]].pos;
+                    after[c] = tri[c] == from ? landing : before[c];
+                }
+                Vec3 n0 = TriangleCross(before[0], before[1], before[2]);
+                Vec3 n1 = TriangleCross(after[0], after[1], after[2]);
+                double dot = static_cast<double>(n0.x) * n1.x + static_cast<double>(n0.y) * n1.y +
+                             static_cast<double>(n0.z) * n1.z;
+                double len0 = std::sqrt(static_cast<double>(n0.x) * n0.x + static_cast<double>(n0.y) * n0.y +
+                                        static_cast<double>(n0.z) * n0.z);
+                double len1 = std::sqrt(static_cast<double>(n1.x) * n1.x + static_cast<double>(n1.y) * n1.y +
+                                        static_cast<double>(n1.z) * n1.z);
+                // Reject flips and near-degenerate slivers (over ~78 degrees of rotation)
+                flips = dot <= 0.2 * len0 * len1;
+            }
+            if (flips || removed == 0) continue;
+
+            for (uint32_t k = triangleStart[from]; k < triangleStart[from + 1]; k++) {
+                const uint32_t* tri = &current[triangleList[k] * 3];
+                for (int c = 0; c < 3; c++) touched[positionId[tri[c]]] = 1;
+            }
+            collapseTo[from] = to;
+            quadrics[positionId[to]].Add(quadrics[positionId[from]]);
+            localStats.error = std::max(localStats.error, collapse.error);
+            remaining -= removed;
+            applied++;
+        }
+        if (applied == 0) break;
+        localStats.collapses += applied;
+
+        // Rewrite the indices and drop triangles that lost an edge
+        size_t write = 0;
+        for (size_t t = 0; t < current.size(); t += 3) {
+            uint32_t a = collapseTo[current[t]], b = collapseTo[current[t + 1]], c = collapseTo[current[t + 2]];
+            uint32_t pa = positionId[a], pb = positionId[b], pc = positionId[c];
+            if (pa == pb || pb == pc || pa == pc) continue;
+            current[write++] = a;
+            current[write++] = b;
+            current[write++] = c;
+        }
+        current.resize(write);
+    }
+
+    std::copy(current.begin(), current.end(), destination);
+    if (stats) *stats = localStats;
+    return current.size();
+}
+
+} // namespace MeshBuilder
@@ -0,0 +1,30 @@
+#pragma once
+#include "vertex_weld.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace MeshBuilder {
+    struct SimplifyOptions {
+        // Stop once the index count is at or below this
+        size_t targetIndexCount = 0;
+        // Largest allowed deviation from the input surface, in units
+        float maxError = 1.0f;
+    };
+
+    struct SimplifyStats {
+        size_t collapses = 0;
+        size_t lockedVertices = 0;  // Unique positions that may not move
+        float error = 0.0f;         // Deviation of the worst collapse taken
+    };
+
+    // Garland-Heckbert quadric error edge collapse over an indexed triangle
+    // list. Vertices only collapse onto existing vertices, so the vertex
+    // buffer is shared with the input. Positions on open edges, attribute
+    // seams and non-manifold edges are locked: mesh borders keep every
+    // vertex and neighbouring meshes still meet without cracks. Collapses
+    // that would flip a triangle are rejected. Writes the simplified indices
+    // to destination (at most indexCount) and returns their count.
+    size_t SimplifyMesh(uint32_t* destination, const uint32_t* indices, size_t indexCount,
+                        const Vertex* vertices, size_t vertexCount,
+                        const SimplifyOptions& options, SimplifyStats* stats = nullptr);
+}
@@ -0,0 +1,137 @@
+#include "mesh_splitter.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace MeshBuilder {
+
+std::vector<std::vector<uint32_t>> SplitTriangles(const float* positions, size_t vertexCount,
+                                                  const uint32_t* indices, size_t triangleCount,
+                                                  const SplitOptions& options, SplitStats* stats) {
+    std::vector<std::vector<uint32_t>> parts;
+    SplitStats localStats;
+    localStats.triangles = triangleCount;
+
+    if (triangleCount == 0) {
+        if (stats) *stats = localStats;
+        return parts;
+    }
+
+    const size_t maxVertices = std::max<uint32_t>(options.maxVertices, 3);
+    const size_t maxIndices = options.maxIndices > 0 ? std::max<uint32_t>(options.maxIndices, 3) : maxVertices * 3;
+
+    auto corner = [&](size_t triangle, int k) -> uint32_t {
+        return indices ? indices[triangle * 3 + k] : static_cast<uint32_t>(triangle * 3 + k);
+    };
+
+    std::vector<float> centroids(triangleCount * 3);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int axis = 0; axis < 3; axis++) {
+            centroids[t * 3 + axis] = (positions[corner(t, 0) * 3 + axis] +
+                                       positions[corner(t, 1) * 3 + axis] +
+                                       positions[corner(t, 2) * 3 + axis]) / 3.0f;
+        }
+    }
+
+    std::vector<uint32_t> order(triangleCount);
+    std::iota(order.begin(), order.end(), 0u);
+
+    // Generation stamps count the unique vertices of a range without clearing
+    std::vector<uint32_t> stamps(indices ? vertexCount : 0, 0);
+    uint32_t stamp = 0;
+
+    auto countVertices = [&](size_t begin, size_t end) -> size_t {
+        if (!indices) return (end - begin) * 3;
+
+        stamp++;
+        size_t unique = 0;
+        for (size_t i = begin; i < end; i++) {
+            for (int k = 0; k < 3; k++) {
+                uint32_t vertex = indices[order[i] * 3 + k];
+                if (stamps[vertex] != stamp) {
+                    stamps[vertex] = stamp;
+                    unique++;
+                }
+            }
+        }
+        return unique;
+    };
+
+    struct Range {
+        size_t begin, end;
+    };
+    std::vector<Range> pending = {{0, triangleCount}};
+
+    while (!pending.empty()) {
+        Range range = pending.back();
+        pending.pop_back();
+
+        const size_t count = range.end - range.begin;
+        const size_t vertices = countVertices(range.begin, range.end);
+
+        if ((vertices <= maxVertices && count * 3 <= maxIndices) || count == 1) {
+            // Keep the input order inside a part; it may already be cache-optimized
+            std::vector<uint32_t> part(order.begin() + range.begin, order.begin() + range.end);
+            std::sort(part.begin(), part.end());
+            parts.push_back(std::move(part));
+            localStats.vertices += vertices;
+            continue;
+        }
+
+        // Split off floor(n/2) of the n parts the range needs, so a range of
+        // three budgets becomes 1 + 2 parts instead of rounding up to four.
+        // Parts are sized for 7/8 of the vertex budget because every cut
+        // duplicates the shared vertices along it.
+        const size_t vertexTarget = std::max<size_t>(maxVertices - maxVertices / 8, 3);
+        size_t needed = std::max((vertices + vertexTarget - 1) / vertexTarget,
+                                 (count * 3 + maxIndices - 1) / maxIndices);
+        needed = std::max<size_t>(needed, 2);
+        size_t split = range.begin + count * (needed / 2) / needed;
+        split = std::min(std::max(split, range.begin + 1), range.end - 1);
+
+        float mins[3] = {centroids[order[range.begin] * 3 + 0], centroids[order[range.begin] * 3 + 1],
+                         centroids[order[range.begin] * 3 + 2]};
+        float maxs[3] = {mins[0], mins[1], mins[2]};
+        for (size_t i = range.begin + 1; i < range.end; i++) {
+            const float* centroid = &centroids[order[i] * 3];
+            for (int axis = 0; axis < 3; axis++) {
+                mins[axis] = std::min(mins[axis], centroid[axis]);
+                maxs[axis] = std::max(maxs[axis], centroid[axis]);
+            }
+        }
+
+        int axis = 0;
+        for (int k = 1; k < 3; k++) {
+            if (maxs[k] - mins[k] > maxs[axis] - mins[axis]) axis = k;
+        }
+
+        // Coincident centroids leave the current order, which is still a valid split
+        if (maxs[axis] > mins[axis]) {
+            std::nth_element(order.begin() + range.begin, order.begin() + split, order.begin() + range.end,
+                             [&](uint32_t a, uint32_t b) {
+                                 return centroids[a * 3 + axis] < centroids[b * 3 + axis];
+                             });
+        }
+
+        // Lower half is popped first so parts come out in spatial order
+        pending.push_back({split, range.end});
+        pending.push_back({range.begin, split});
+    }
+
+    localStats.parts = parts.size();
+    if (indices) {
+        stamp++;
+        size_t referenced = 0;
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            if (stamps[indices[i]] != stamp) {
+                stamps[indices[i]] = stamp;
+                referenced++;
+            }
+        }
+        localStats.duplicatedVertices = localStats.vertices - referenced;
+    }
+
+    if (stats) *stats = localStats;
+    return parts;
+}
+
+} // namespace MeshBuilder
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MeshBuilder {
+    struct SplitOptions {
+        // Vertices per part; the default keeps every part 16-bit indexable
+        uint32_t maxVertices = 0x10000;
+        // Indices per part (0 = 3 * maxVertices)
+        uint32_t maxIndices = 0;
+    };
+
+    struct SplitStats {
+        size_t parts = 0;
+        size_t triangles = 0;
+        size_t vertices = 0;            // Summed over parts
+        size_t duplicatedVertices = 0;  // Extra copies of indexed vertices shared between parts
+    };
+
+    // Partitions a triangle list into parts that each fit the budgets without
+    // cutting a triangle. Oversized ranges are split recursively at the
+    // centroid median of their longest axis, so every part stays spatially
+    // compact. positions holds xyz floats per vertex; indices == nullptr
+    // treats them as an unindexed soup of triangleCount * 3 vertices.
+    // Returns the input triangle numbers of each part.
+    std::vector<std::vector<uint32_t>> SplitTriangles(const float* positions, size_t vertexCount,
+                                                      const uint32_t* indices, size_t triangleCount,
+                                                      const SplitOptions& options,
+                                                      SplitStats* stats = nullptr);
+}
@@ -0,0 +1,175 @@
+#include "region_classifier.hpp"
+#include "chunk_builder.hpp"
+#include "math/radix_sort.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace MeshBuilder {
+
+namespace {
+    // Union by size with path halving
+    class DisjointSet {
+    public:
+        explicit DisjointSet(size_t count) : m_parent(count), m_size(count, 1) {
+            for (size_t i = 0; i < count; i++) m_parent[i] = static_cast<uint32_t>(i);
+        }
+
+        uint32_t Find(uint32_t x) {
+            while (m_parent[x] != x) {
+                m_parent[x] = m_parent[m_parent[x]];
+                x = m_parent[x];
+            }
+            return x;
+        }
+
+        void Union(uint32_t a, uint32_t b) {
+            a = Find(a);
+            b = Find(b);
+            if (a == b) return;
+            if (m_size[a] < m_size[b]) std::swap(a, b);
+            m_parent[b] = a;
+            m_size[a] += m_size[b];
+        }
+
+    private:
+        std::vector<uint32_t> m_parent;
+        std::vector<uint32_t> m_size;
+    };
+
+    bool IsFiniteBox(const float* box) {
+        for (int i = 0; i < 6; i++) {
+            if (!std::isfinite(box[i])) return false;
+        }
+        return true;
+    }
+}
+
+void ClassifyRegions(const float* boxes, size_t faceCount, const RegionOptions& options,
+                     RegionClassification& out) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    out.regions.clear();
+    out.faceRegions.assign(faceCount, RegionClassification::InvalidRegion);
+    out.cells = 0;
+    out.cellRefs = 0;
+
+    const float gap = std::max(options.gap, 64.0f);
+    const float half = gap * 0.5f;
+    const float inverseCell = 1.0f / gap;
+
+    // One (cell, face) pair per cell each face's half-gap expanded box covers;
+    // two expanded boxes that overlap always cover a common cell
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> faces;
+    keys.reserve(faceCount * 8);
+    faces.reserve(faceCount * 8);
+
+    for (size_t f = 0; f < faceCount; f++) {
+        const float* box = boxes + f * 6;
+        if (!IsFiniteBox(box)) continue;
+
+        // A face reaching past the key range ends up in a region of its own
+        // rather than sharing the edge cells with unrelated faces
+        int32_t x0, x1, y0, y1, z0, z1;
+        if (!RTXMath::ToChunkCoord(box[0] - half, inverseCell, x0) || !RTXMath::ToChunkCoord(box[3] + half, inverseCell, x1) ||
+            !RTXMath::ToChunkCoord(box[1] - half, inverseCell, y0) || !RTXMath::ToChunkCoord(box[4] + half, inverseCell, y1) ||
+            !RTXMath::ToChunkCoord(box[2] - half, inverseCell, z0) || !RTXMath::ToChunkCoord(box[5] + half, inverseCell, z1)) {
+            continue;
+        }
+
+        for (int32_t x = x0; x <= x1; x++) {
+            for (int32_t y = y0; y <= y1; y++) {
+                for (int32_t z = z0; z <= z1; z++) {
+                    keys.push_back(static_cast<uint64_t>(RTXMath::PackChunkKey(x, y, z)));
+                    faces.push_back(static_cast<uint32_t>(f));
+                }
+            }
+        }
+    }
+    out.cellRefs = keys.size();
+
+    std::vector<uint64_t> keyScratch;
+    std::vector<uint32_t> faceScratch;
+    RTXMath::RadixSort64(keys.data(), faces.data(), keys.size(), keyScratch, faceScratch);
+
+    // Every face in a run of equal cells joins the run's first face
+    DisjointSet sets(faceCount);
+    for (size_t i = 0; i < keys.size();) {
+        size_t end = i + 1;
+        while (end < keys.size() && keys[end] == keys[i]) {
+            sets.Union(faces[i], faces[end]);
+            end++;
+        }
+        out.cells++;
+        i = end;
+    }
+
+    // Accumulate each root's bounds, then renumber by descending face count
+    std::vector<uint32_t> rootRegion(faceCount, RegionClassification::InvalidRegion);
+    std::vector<uint32_t> roots;
+    std::vector<Region> regions;
+    for (size_t f = 0; f < faceCount; f++) {
+        const float* box = boxes + f * 6;
+        if (!IsFiniteBox(box)) continue;
+
+        uint32_t root = sets.Find(static_cast<uint32_t>(f));
+        uint32_t& id = rootRegion[root];
+        if (id == RegionClassification::InvalidRegion) {
+            id = static_cast<uint32_t>(regions.size());
+            Region region;
+            region.mins = {box[0], box[1], box[2]};
+            region.maxs = {box[3], box[4], box[5]};
+            regions.push_back(region);
+        }
+
+        Region& region = regions[id];
+        region.mins.x = std::min(region.mins.x, box[0]);
+        region.mins.y = std::min(region.mins.y, box[1]);
+        region.mins.z = std::min(region.mins.z, box[2]);
+        region.maxs.x = std::max(region.maxs.x, box[3]);
+        region.maxs.y = std::max(region.maxs.y, box[4]);
+        region.maxs.z = std::max(region.maxs.z, box[5]);
+        region.faceCount++;
+        out.faceRegions[f] = id;
+    }
+
+    std::vector<uint32_t> order(regions.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = static_cast<uint32_t>(i);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return regions[a].faceCount > regions[b].faceCount;
+    });
+
+    std::vector<uint32_t> remap(regions.size());
+    out.regions.reserve(regions.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        remap[order[i]] = static_cast<uint32_t>(i);
+        out.regions.push_back(regions[order[i]]);
+    }
+    for (uint32_t& id : out.faceRegions) {
+        if (id != RegionClassification::InvalidRegion) id = remap[id];
+    }
+
+    // Distinct regions are never within the gap of each other, so distance
+    // from the main region alone decides which ones are separate
+    if (!out.regions.empty()) {
+        const Region& main = out.regions[0];
+        float mainX = (main.mins.x + main.maxs.x) * 0.5f;
+        float mainY = (main.mins.y + main.maxs.y) * 0.5f;
+        float mainZ = (main.mins.z + main.maxs.z) * 0.5f;
+        float limitSq = options.separationDistance * options.separationDistance;
+
+        for (size_t i = 1; i < out.regions.size(); i++) {
+            Region& region = out.regions[i];
+            float dx = (region.mins.x + region.maxs.x) * 0.5f - mainX;
+            float dy = (region.mins.y + region.maxs.y) * 0.5f - mainY;
+            float dz = (region.mins.z + region.maxs.z) * 0.5f - mainZ;
+            region.separate = dx * dx + dy * dy + dz * dz > limitSq;
+        }
+    }
+
+    out.milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+}
+
+} // namespace MeshBuilder
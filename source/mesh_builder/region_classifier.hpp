@@ -0,0 +1,47 @@
+#pragma once
+#include "bsp_reader/bsp_reader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MeshBuilder {
+    struct RegionOptions {
+        // Faces closer than this on every axis always share a region; the grid
+        // cells are this size, so faces up to twice as far apart may merge too.
+        // Clamped to at least 64 units to bound the cells a face can cover.
+        float gap = 1024.0f;
+        // Regions whose center is further than this from the main region's
+        // center are flagged as separate (skybox, off-map rooms)
+        float separationDistance = 4096.0f;
+    };
+
+    struct Region {
+        BSPReader::Vec3 mins, maxs;
+        uint32_t faceCount = 0;
+        bool separate = false;
+    };
+
+    struct RegionClassification {
+        // Sorted by face count, largest first: regions[0] is the main region
+        std::vector<Region> regions;
+        // Region of each input face; InvalidRegion for non-finite bounds
+        std::vector<uint32_t> faceRegions;
+        size_t cells = 0;       // Occupied grid cells
+        size_t cellRefs = 0;    // (cell, face) pairs hashed
+        double milliseconds = 0.0;
+
+        static constexpr uint32_t InvalidRegion = 0xFFFFFFFFu;
+
+        bool IsSeparate(size_t face) const {
+            uint32_t region = face < faceRegions.size() ? faceRegions[face] : InvalidRegion;
+            return region != InvalidRegion && regions[region].separate;
+        }
+    };
+
+    // Groups faces into connected regions: every face AABB (mins xyz, maxs xyz
+    // per face) is hashed into the uniform grid cells it covers, and faces
+    // sharing a cell are merged with union-find. Runs in O(faces + cells)
+    // instead of comparing each face against every region found so far.
+    void ClassifyRegions(const float* boxes, size_t faceCount, const RegionOptions& options,
+                         RegionClassification& out);
+}
@@ -0,0 +1,155 @@
+#include "vertex_weld.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace MeshBuilder {
+
+void IndexBuffer::Assign(const std::vector<uint32_t>& indices, size_t vertexCount) {
+    Clear();
+    if (vertexCount <= 0x10000) {
+        m_indices16.assign(indices.begin(), indices.end());
+    } else {
+        m_indices32 = indices;
+    }
+}
+
+void IndexBuffer::Assign(const void* data, size_t count, size_t indexSize) {
+    Clear();
+    if (indexSize == sizeof(uint16_t)) {
+        const uint16_t* indices = static_cast<const uint16_t*>(data);
+        m_indices16.assign(indices, indices + count);
+    } else {
+        const uint32_t* indices = static_cast<const uint32_t*>(data);
+        m_indices32.assign(indices, indices + count);
+    }
+}
+
+void IndexBuffer::Clear() {
+    std::vector<uint16_t>().swap(m_indices16);
+    std::vector<uint32_t>().swap(m_indices32);
+}
+
+void IndexBuffer::CopyTo(std::vector<uint32_t>& out) const {
+    if (Is16Bit()) {
+        out.assign(m_indices16.begin(), m_indices16.end());
+    } else {
+        out = m_indices32;
+    }
+}
+
+static int32_t QuantizeValue(float value, float inverseTolerance) {
+    return static_cast<int32_t>(std::floor(value * inverseTolerance + 0.5f));
+}
+
+VertexWelder::VertexWelder(const WeldOptions& options, size_t expectedVertices)
+    : m_invPosition(1.0f / std::max(options.positionTolerance, 1e-6f)),
+      m_invNormal(1.0f / std::max(options.normalTolerance, 1e-6f)),
+      m_invUV(1.0f / std::max(options.uvTolerance, 1e-6f)) {
+    // Keep the load factor at or below one half
+    size_t capacity = 16;
+    while (capacity < expectedVertices * 2) capacity <<= 1;
+    m_table.assign(capacity, 0);
+    m_mask = capacity - 1;
+
+    m_keys.reserve(expectedVertices);
+    m_vertices.reserve(expectedVertices);
+}
+
+bool VertexWelder::Key::operator==(const Key& other) const {
+    return std::memcmp(q, other.q, sizeof(q)) == 0;
+}
+
+VertexWelder::Key VertexWelder::Quantize(const Vertex& vertex) const {
+    Key key;
+    key.q[0] = QuantizeValue(vertex.pos.x, m_invPosition);
+    key.q[1] = QuantizeValue(vertex.pos.y, m_invPosition);
+    key.q[2] = QuantizeValue(vertex.pos.z, m_invPosition);
+    key.q[3] = QuantizeValue(vertex.normal.x, m_invNormal);
+    key.q[4] = QuantizeValue(vertex.normal.y, m_invNormal);
+    key.q[5] = QuantizeValue(vertex.normal.z, m_invNormal);
+    key.q[6] = QuantizeValue(vertex.u, m_invUV);
+    key.q[7] = QuantizeValue(vertex.v, m_invUV);
+    return key;
+}
+
+uint64_t VertexWelder::Hash(const Key& key) {
+    uint64_t h = 0x9E3779B97F4A7C15ull;
+    for (int32_t value : key.q) {
+        h ^= static_cast<uint32_t>(value);
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+void VertexWelder::Grow() {
+    std::vector<uint32_t> table(m_table.size() * 2, 0);
+    size_t mask = table.size() - 1;
+
+    for (uint32_t i = 0; i < m_keys.size(); i++) {
+        size_t slot = Hash(m_keys[i]) & mask;
+        while (table[slot] != 0) slot = (slot + 1) & mask;
+        table[slot] = i + 1;
+    }
+
+    m_table.swap(table);
+    m_mask = mask;
+}
+
+uint32_t VertexWelder::Insert(const Vertex& vertex) {
+    Key key = Quantize(vertex);
+    size_t slot = Hash(key) & m_mask;
+
+    while (m_table[slot] != 0) {
+        uint32_t index = m_table[slot] - 1;
+        if (m_keys[index] == key) return index;
+        slot = (slot + 1) & m_mask;
+    }
+
+    uint32_t index = static_cast<uint32_t>(m_vertices.size());
+    m_table[slot] = index + 1;
+    m_keys.push_back(key);
+    m_vertices.push_back(vertex);
+
+    if (m_vertices.size() * 2 > m_table.size()) Grow();
+    return index;
+}
+
+void WeldTriangles(const Vertex* vertices, size_t count, const WeldOptions& options,
+                   std::vector<Vertex>& outVertices, IndexBuffer& outIndices,
+                   WeldStats* stats) {
+    const size_t triangleCount = count / 3;
+    VertexWelder welder(options, triangleCount * 3);
+
+    std::vector<uint32_t> indices;
+    indices.reserve(triangleCount * 3);
+    size_t degenerate = 0;
+
+    for (size_t t = 0; t < triangleCount; t++) {
+        uint32_t a = welder.Insert(vertices[t * 3 + 0]);
+        uint32_t b = welder.Insert(vertices[t * 3 + 1]);
+        uint32_t c = welder.Insert(vertices[t * 3 + 2]);
+
+        if (a == b || b == c || a == c) {
+            degenerate++;
+            continue;
+        }
+
+        indices.push_back(a);
+        indices.push_back(b);
+        indices.push_back(c);
+    }
+
+    outVertices.swap(welder.Vertices());
+    outIndices.Assign(indices, outVertices.size());
+
+    if (stats) {
+        stats->inputVertices += count;
+        stats->outputVertices += outVertices.size();
+        stats->indices += indices.size();
+        stats->degenerateTriangles += degenerate;
+    }
+}
+
+} // namespace MeshBuilder
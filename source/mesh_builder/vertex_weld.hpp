@@ -0,0 +1,83 @@
+#pragma once
+#include "bsp_reader/bsp_reader.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace MeshBuilder {
+    using Vec3 = BSPReader::Vec3;
+    using Vertex = BSPReader::TriangleVertex;
+
+    // Index buffer stored as 16-bit indices whenever the vertex count allows it
+    class IndexBuffer {
+    public:
+        void Assign(const std::vector<uint32_t>& indices, size_t vertexCount);
+        // Copies raw indices of indexSize bytes (2 or 4) as they are
+        void Assign(const void* data, size_t count, size_t indexSize);
+        void Clear();
+        void CopyTo(std::vector<uint32_t>& out) const;
+
+        bool Empty() const { return Size() == 0; }
+        bool Is16Bit() const { return m_indices32.empty(); }
+        size_t Size() const { return Is16Bit() ? m_indices16.size() : m_indices32.size(); }
+        size_t IndexSize() const { return Is16Bit() ? sizeof(uint16_t) : sizeof(uint32_t); }
+
+        uint32_t operator[](size_t i) const {
+            return Is16Bit() ? m_indices16[i] : m_indices32[i];
+        }
+
+        const std::vector<uint16_t>& Indices16() const { return m_indices16; }
+        const std::vector<uint32_t>& Indices32() const { return m_indices32; }
+
+    private:
+        std::vector<uint16_t> m_indices16;
+        std::vector<uint32_t> m_indices32;
+    };
+
+    // Vertices whose attributes quantize to the same grid cell are merged
+    struct WeldOptions {
+        float positionTolerance = 1.0f / 32.0f;  // Hammer units
+        float normalTolerance = 1.0f / 512.0f;
+        float uvTolerance = 1.0f / 4096.0f;
+    };
+
+    struct WeldStats {
+        size_t inputVertices = 0;
+        size_t outputVertices = 0;
+        size_t indices = 0;
+        size_t degenerateTriangles = 0;  // Triangles dropped because two corners merged
+    };
+
+    // Open-addressing (linear probing) hash over quantized position, normal
+    // and UV. Each unique vertex keeps the attributes of its first occurrence.
+    class VertexWelder {
+    public:
+        VertexWelder(const WeldOptions& options, size_t expectedVertices);
+
+        // Returns the index of the matching unique vertex, adding it if new
+        uint32_t Insert(const Vertex& vertex);
+
+        std::vector<Vertex>& Vertices() { return m_vertices; }
+
+    private:
+        struct Key {
+            int32_t q[8];
+            bool operator==(const Key& other) const;
+        };
+
+        Key Quantize(const Vertex& vertex) const;
+        static uint64_t Hash(const Key& key);
+        void Grow();
+
+        float m_invPosition, m_invNormal, m_invUV;
+        std::vector<uint32_t> m_table;  // Unique vertex index + 1, 0 = empty
+        std::vector<Key> m_keys;
+        std::vector<Vertex> m_vertices;
+        size_t m_mask = 0;
+    };
+
+    // Welds an unindexed triangle list (count a multiple of 3) into unique
+    // vertices and an index buffer. Collapsed triangles are dropped.
+    void WeldTriangles(const Vertex* vertices, size_t count, const WeldOptions& options,
+                       std::vector<Vertex>& outVertices, IndexBuffer& outIndices,
+                       WeldStats* stats = nullptr);
+}
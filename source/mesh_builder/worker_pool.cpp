@@ -0,0 +1,125 @@
+#include "worker_pool.hpp"
+#include <algorithm>
+#include <exception>
+#include <memory>
+
+namespace MeshBuilder {
+
+WorkerPool::WorkerPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        unsigned hardware = std::thread::hardware_concurrency();
+        threadCount = hardware > 1 ? hardware - 1 : 0;
+    }
+
+    m_threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; i++) {
+        m_threads.emplace_back(&WorkerPool::WorkerMain, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    Shutdown();
+}
+
+void WorkerPool::Shutdown() {
+    if (m_threads.empty()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) thread.join();
+    }
+    m_threads.clear();
+}
+
+void WorkerPool::Submit(std::function<void()> task) {
+    if (m_threads.empty()) {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_wake.notify_one();
+}
+
+void WorkerPool::WorkerMain() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping && m_tasks.empty()) return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void WorkerPool::ParallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+
+    // Shared with the helpers so late starters can safely find nothing to do
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> completed{0};
+        size_t count = 0;
+        const std::function<void(size_t)>* fn = nullptr;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    auto state = std::make_shared<State>();
+    state->count = count;
+    state->fn = &fn;
+
+    auto run = [state]() {
+        for (;;) {
+            size_t index = state->next.fetch_add(1);
+            if (index >= state->count) return;
+
+            try {
+                (*state->fn)(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) state->error = std::current_exception();
+            }
+
+            if (state->completed.fetch_add(1) + 1 == state->count) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(static_cast<size_t>(m_threads.size()), count - 1);
+    if (helpers > 0) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (size_t i = 0; i < helpers; i++) {
+                m_tasks.push_back(run);
+            }
+        }
+        m_wake.notify_all();
+    }
+
+    run();
+
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [&] { return state->completed.load() == state->count; });
+    }
+
+    if (state->error) std::rethrow_exception(state->error);
+}
+
+} // namespace MeshBuilder
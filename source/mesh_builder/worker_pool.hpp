@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MeshBuilder {
+    // Small fixed-size thread pool used by the native world mesh builders.
+    // The calling thread always takes part in ParallelFor, so a pool with
+    // zero workers degrades to a plain serial loop.
+    // The shared instance must be shut down explicitly before the module is
+    // unloaded: joining threads from a static destructor runs under the
+    // Windows loader lock and can deadlock.
+    class WorkerPool {
+    public:
+        static WorkerPool& Instance() {
+            static WorkerPool instance;
+            return instance;
+        }
+
+        // threadCount == 0 picks hardware_concurrency() - 1 workers
+        explicit WorkerPool(unsigned threadCount = 0);
+        ~WorkerPool();
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        unsigned ThreadCount() const { return static_cast<unsigned>(m_threads.size()); }
+
+        // Finishes queued tasks and joins every worker; afterwards the pool
+        // runs everything on the calling thread. Safe to call more than once.
+        void Shutdown();
+
+        void Submit(std::function<void()> task);
+
+        // Runs fn(i) for every i in [0, count) and returns once all calls finished.
+        // Exceptions thrown by fn are rethrown on the calling thread.
+        void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+    private:
+        void WorkerMain();
+
+        std::vector<std::thread> m_threads;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+    };
+}
@@ -10,6 +10,7 @@
 #include "rtx_light_manager/rtx_light_manager.hpp"
 #include "math/math.hpp"
 #include "entity_manager/entity_manager.hpp"
+#include "entity_manager/remix_world_meshes.hpp"
 #include "shader_fixes/shader_hooks.h"
 #include "prop_fixes.h" 
 
@@ -178,8 +179,13 @@ GMOD_MODULE_CLOSE() {
             }
         }
 
-        // Cleanup RTX Light Manager
+        // Stop the native world builder and its threads before the DLL unloads
+        EntityManager::Shutdown();
+
+        // Release Remix lights and world meshes while the interface is still alive
         RTXLightManager::Instance().Cleanup();
+        EntityManager::RemixWorldMeshes::Instance().Clear();
+        EntityManager::RemixMaterialCache::Instance().DestroyAll();
 
         if (g_remix) {
             delete g_remix;
@@ -0,0 +1,139 @@
+// Standalone tests for RTXMath::BoxBVH: radius queries must match a
+// brute-force scan and frustum queries the flat culling kernel over random
+// boxes and points, including boxes exactly on the query edges. Exits
+// non-zero on a failed check.
+#include "math/box_bvh.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace RTXMath;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+static void TestMatchesScan(size_t count) {
+    std::mt19937 rng(31337);
+    std::uniform_real_distribution<float> coord(-15000.0f, 15000.0f);
+    std::uniform_real_distribution<float> size(0.0f, 200.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    // Mostly small props, some bare points and a pile of duplicates
+    std::vector<float> mins(count * 3), maxs(count * 3);
+    for (size_t i = 0; i < count; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            float c = i % 50 == 0 ? 100.0f : coord(rng);
+            float e = i % 3 == 0 ? 0.0f : size(rng);
+            mins[i * 3 + axis] = c - e;
+            maxs[i * 3 + axis] = c + e;
+        }
+    }
+
+    // A point exactly on the query radius
+    const float center[3] = {250.0f, -750.0f, 64.0f};
+    const float radius = 4096.0f;
+    mins[3] = maxs[3] = center[0] + radius;
+    mins[4] = maxs[4] = center[1];
+    mins[5] = maxs[5] = center[2];
+
+    BoxBVH bvh;
+    bvh.Build(mins.data(), maxs.data(), count);
+    CHECK(bvh.Size() == count);
+
+    std::vector<uint32_t> found, expected;
+    bvh.QueryRadius(center, radius, found);
+    for (size_t i = 0; i < count; i++) {
+        float d2 = 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            float c = (mins[i * 3 + axis] + maxs[i * 3 + axis]) * 0.5f;
+            float e = std::fabs(maxs[i * 3 + axis] - mins[i * 3 + axis]) * 0.5f;
+            float d = std::max(std::fabs(c - center[axis]) - e, 0.0f);
+            d2 += d * d;
+        }
+        if (d2 <= radius * radius) expected.push_back(static_cast<uint32_t>(i));
+    }
+    CHECK(found == expected);
+    CHECK(std::binary_search(found.begin(), found.end(), 1u));
+
+    // Frustum queries must match the flat culling kernel box for box
+    CullBoxSet boxes;
+    for (size_t i = 0; i < count; i++) boxes.Add(&mins[i * 3], &maxs[i * 3]);
+    std::vector<uint32_t> flat(count);
+
+    size_t views = 0, mismatches = 0, paddingLost = 0;
+    for (int view = 0; view < 16; view++) {
+        float forward[3] = {unit(rng), unit(rng), unit(rng) * 0.3f};
+        float length = std::sqrt(forward[0] * forward[0] + forward[1] * forward[1] + forward[2] * forward[2]);
+        if (length < 1e-3f) continue;
+        for (float& f : forward) f /= length;
+
+        // Right = forward x world up, up = right x forward
+        float right[3] = {forward[1], -forward[0], 0.0f};
+        float rightLength = std::sqrt(right[0] * right[0] + right[1] * right[1]);
+        if (rightLength < 1e-3f) continue;
+        right[0] /= rightLength;
+        right[1] /= rightLength;
+        float up[3] = {right[1] * forward[2] - right[2] * forward[1],
+                       right[2] * forward[0] - right[0] * forward[2],
+                       right[0] * forward[1] - right[1] * forward[0]};
+
+        const float origin[3] = {coord(rng), coord(rng), coord(rng) * 0.1f};
+        ViewFrustum frustum = BuildViewFrustum(origin, forward, right, up, 90.0f, 16.0f / 9.0f, 0.0f,
+                                               view % 2 ? 8000.0f : 0.0f);
+
+        bvh.QueryFrustum(frustum, found);
+        size_t visible = CullBoxes(boxes, frustum, flat.data(), SimdLevel::Scalar);
+        if (found.size() != visible || !std::equal(found.begin(), found.end(), flat.begin())) mismatches++;
+
+        // Padding may only add boxes
+        std::vector<uint32_t> padded;
+        bvh.QueryFrustum(frustum, padded, 256.0f);
+        if (!std::includes(padded.begin(), padded.end(), found.begin(), found.end())) paddingLost++;
+        views++;
+    }
+    CHECK(views > 0);
+    CHECK(mismatches == 0);
+    CHECK(paddingLost == 0);
+
+    std::printf("%zu boxes: %zu nodes, depth %d, %zu radius hits, %zu views\n", count, bvh.NodeCount(),
+                bvh.Depth(), expected.size(), views);
+}
+
+static void TestEmpty() {
+    BoxBVH bvh;
+    bvh.Build(nullptr, nullptr, 0);
+    CHECK(bvh.Size() == 0);
+
+    const float center[3] = {0.0f, 0.0f, 0.0f};
+    std::vector<uint32_t> found = {7};
+    bvh.QueryRadius(center, 1000.0f, found);
+    CHECK(found.empty());
+
+    const float box[3] = {1.0f, 2.0f, 3.0f};
+    bvh.Build(box, box, 1);
+    bvh.QueryRadius(center, 1000.0f, found);
+    CHECK(found.size() == 1 && found[0] == 0);
+    bvh.Clear();
+    CHECK(bvh.Size() == 0 && bvh.NodeCount() == 0);
+}
+
+int main() {
+    TestMatchesScan(20000);
+    TestEmpty();
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all box BVH checks passed\n");
+    return 0;
+}
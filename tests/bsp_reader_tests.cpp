@@ -0,0 +1,192 @@
+// Standalone tests for BSPReader against data/sample.bsp (see
+// data/make_sample_bsp.py for what the map holds). Exits non-zero on the
+// first failed check.
+#include "bsp_reader/bsp_reader.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifndef SAMPLE_BSP_PATH
+#define SAMPLE_BSP_PATH "data/sample.bsp"
+#endif
+
+using namespace BSPReader;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+static std::vector<uint8_t> ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void TestOpen(const std::string& path) {
+    Map map;
+    std::string error;
+    CHECK(map.Open(path, error));
+    CHECK(map.IsOpen());
+    CHECK(map.Version() == 20);
+    CHECK(map.Revision() == 1);
+
+    size_t count;
+    CHECK(map.GetLump<DFace>(LUMP_FACES, count) && count == 16);
+    CHECK(map.GetLump<DModel>(LUMP_MODELS, count) && count == 2);
+    CHECK(map.GetLump<DNode>(LUMP_NODES, count) && count == 12);
+    CHECK(map.GetLumpVersion(LUMP_LEAFS) == 1);
+    CHECK(!map.GetLump<DDispInfo>(LUMP_DISPINFO, count) && count == 0);
+
+    size_t bytes;
+    const uint8_t* entities = map.GetLumpData(LUMP_ENTITIES, bytes);
+    CHECK(entities && bytes > 0 && std::strstr(reinterpret_cast<const char*>(entities), "worldspawn"));
+
+    CHECK(map.GetTexDataName(0) && std::strcmp(map.GetTexDataName(0), "DEV/FLOOR") == 0);
+    CHECK(map.GetTexDataName(2) && std::strcmp(map.GetTexDataName(2), "TOOLS/TOOLSNODRAW") == 0);
+    CHECK(!map.GetTexDataName(3));
+    CHECK(!map.GetTexDataName(-1));
+
+    CHECK(!map.Open(path + ".missing", error));
+    CHECK(!map.IsOpen());
+}
+
+static void TestRejectsBadFiles(const std::vector<uint8_t>& sample) {
+    Map map;
+    std::string error;
+
+    CHECK(!map.OpenFromMemory(std::vector<uint8_t>(sample.begin(), sample.begin() + 100), error));
+
+    std::vector<uint8_t> bad = sample;
+    bad[0] = 'X';
+    CHECK(!map.OpenFromMemory(std::move(bad), error));
+
+    // Version 21 stores lump headers as {version, fileofs, filelen}
+    for (int32_t version : {18, 21}) {
+        bad = sample;
+        std::memcpy(&bad[4], &version, sizeof(version));
+        CHECK(!map.OpenFromMemory(std::move(bad), error));
+    }
+
+    // A lump running past the end of the file reads as missing
+    bad = sample;
+    FileHeader header;
+    std::memcpy(&header, bad.data(), sizeof(header));
+    header.lumps[LUMP_FACES].filelen = static_cast<int32_t>(bad.size());
+    std::memcpy(bad.data(), &header, sizeof(header));
+    CHECK(map.OpenFromMemory(std::move(bad), error));
+    size_t count;
+    CHECK(!map.GetLump<DFace>(LUMP_FACES, count) && count == 0);
+
+    // LZMA compressed lumps are reported as missing
+    bad = sample;
+    std::memcpy(&header, bad.data(), sizeof(header));
+    std::memcpy(&bad[header.lumps[LUMP_PLANES].fileofs], "LZMA", 4);
+    CHECK(map.OpenFromMemory(std::move(bad), error));
+    CHECK(!map.GetLump<DPlane>(LUMP_PLANES, count));
+    CHECK(map.GetLump<DNode>(LUMP_NODES, count) && count == 12);
+}
+
+static void TestFaces(const std::vector<uint8_t>& sample) {
+    Map map;
+    std::string error;
+    CHECK(map.OpenFromMemory(std::vector<uint8_t>(sample), error));
+
+    // Floors are walked with every other edge reversed
+    std::vector<Vec3> polygon;
+    CHECK(map.GetFacePolygon(2, polygon));
+    CHECK(polygon.size() == 4);
+    if (polygon.size() == 4) {
+        CHECK(polygon[0].x == 512.0f && polygon[0].y == 0.0f);
+        CHECK(polygon[1].x == 768.0f && polygon[1].y == 0.0f);
+        CHECK(polygon[2].x == 768.0f && polygon[2].y == 256.0f);
+        CHECK(polygon[3].x == 512.0f && polygon[3].y == 256.0f);
+    }
+    CHECK(!map.GetFacePolygon(14, polygon));
+    CHECK(!map.GetFacePolygon(16, polygon));
+
+    std::vector<TriangleVertex> triangles;
+    Vec3 center;
+    CHECK(map.DecodeFace(2, triangles, &center));
+    CHECK(triangles.size() == 6);
+    CHECK(center.x == 640.0f && center.y == 128.0f && center.z == 0.0f);
+    for (const auto& vert : triangles) {
+        CHECK(vert.normal.x == 0.0f && vert.normal.y == 0.0f && vert.normal.z == 1.0f);
+        CHECK(vert.u == vert.pos.x / 256.0f && vert.v == vert.pos.y / 256.0f);
+    }
+
+    // The ceiling's plane faces down already
+    triangles.clear();
+    CHECK(map.DecodeFace(12, triangles));
+    CHECK(!triangles.empty() && triangles[0].normal.z == -1.0f);
+}
+
+static void TestDecodeWorld(const std::vector<uint8_t>& sample) {
+    Map map;
+    std::string error;
+    CHECK(map.OpenFromMemory(std::vector<uint8_t>(sample), error));
+
+    // Floors only: the nodraw ceiling and degenerate face are skipped, the
+    // displacement is left to the displacement builder
+    WorldGeometry world;
+    CHECK(map.DecodeWorld(world));
+    CHECK(world.faceCount == 12);
+    CHECK(world.triangleCount == 24);
+    CHECK(world.skippedFaces == 2);
+    CHECK(world.materials.size() == 2);
+    for (const auto& stream : world.materials) {
+        CHECK(stream.material == "DEV/FLOOR" || stream.material == "DEV/WALL");
+        CHECK(stream.faces.size() == 6);
+        CHECK(stream.vertices.size() == 36);
+        for (const auto& face : stream.faces) {
+            CHECK(face.faceIndex < 12 && static_cast<int32_t>(face.faceIndex % 2) == stream.texData);
+            CHECK(face.mins.x == face.faceIndex * 256.0f && face.maxs.x == face.mins.x + 256.0f);
+            CHECK(face.mins.z == 0.0f && face.maxs.z == 0.0f);
+        }
+    }
+
+    DecodeOptions options;
+    options.skipDisplacements = true;
+    CHECK(map.DecodeWorld(world, options));
+    CHECK(world.faceCount == 12 && world.skippedFaces == 3);
+
+    // The brush entity's wall joins in when every model is decoded
+    options = DecodeOptions();
+    options.worldOnly = false;
+    CHECK(map.DecodeWorld(world, options));
+    CHECK(world.faceCount == 13);
+
+    options = DecodeOptions();
+    options.maxCoord = 1024.0f;
+    CHECK(map.DecodeWorld(world, options));
+    CHECK(world.faceCount == 4 && world.skippedFaces == 10);
+}
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : SAMPLE_BSP_PATH;
+    const std::vector<uint8_t> sample = ReadFile(path);
+    if (sample.empty()) {
+        std::printf("could not read %s\n", path.c_str());
+        return 1;
+    }
+
+    TestOpen(path);
+    TestRejectsBadFiles(sample);
+    TestFaces(sample);
+    TestDecodeWorld(sample);
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all BSP reader checks passed\n");
+    return 0;
+}
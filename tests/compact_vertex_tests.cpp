@@ -0,0 +1,209 @@
+// Standalone tests for the compact vertex layout: half-float conversion,
+// octahedral normal error, absolute UV error over realistic world texture
+// coordinates and the offset choice that keeps meshes with wide UV ranges
+// in float. Exits non-zero on a failed check.
+#include "math/compact_vertex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace RTXMath;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+// Octahedral snorm16 normals stay within this many degrees of the input
+static const double kNormalBoundDegrees = 0.01;
+
+static void TestHalfConversion() {
+    CHECK(FloatToHalf(0.0f) == 0x0000 && FloatToHalf(-0.0f) == 0x8000);
+    CHECK(FloatToHalf(1.0f) == 0x3C00 && FloatToHalf(-2.0f) == 0xC000);
+    CHECK(FloatToHalf(65504.0f) == 0x7BFF);
+    CHECK(FloatToHalf(65520.0f) == 0x7C00);  // Rounds up to infinity
+    CHECK(FloatToHalf(INFINITY) == 0x7C00 && FloatToHalf(-INFINITY) == 0xFC00);
+    CHECK((FloatToHalf(NAN) & 0x7C00) == 0x7C00 && (FloatToHalf(NAN) & 0x3FF) != 0);
+
+    // Smallest subnormal, and ties to even around it
+    CHECK(FloatToHalf(5.9604645e-8f) == 0x0001);
+    CHECK(FloatToHalf(2.9802322e-8f) == 0x0000);
+    CHECK(FloatToHalf(8.9406967e-8f) == 0x0002);
+    CHECK(FloatToHalf(1.0f + 1.0f / 2048.0f) == 0x3C00);
+    CHECK(FloatToHalf(1.0f + 3.0f / 2048.0f) == 0x3C02);
+
+    // Every finite half survives the round trip
+    for (uint32_t bits = 0; bits < 0x10000; bits++) {
+        const uint16_t half = static_cast<uint16_t>(bits);
+        if ((half & 0x7C00) == 0x7C00) continue;
+        CHECK(FloatToHalf(HalfToFloat(half)) == half);
+    }
+}
+
+// Angle between two unit vectors; atan2 of |a x b| and a . b stays accurate
+// for tiny angles, unlike acos
+static double AngleDegrees(const float* a, const float* b) {
+    const double cross[3] = {
+        static_cast<double>(a[1]) * b[2] - static_cast<double>(a[2]) * b[1],
+        static_cast<double>(a[2]) * b[0] - static_cast<double>(a[0]) * b[2],
+        static_cast<double>(a[0]) * b[1] - static_cast<double>(a[1]) * b[0]
+    };
+    const double dot = static_cast<double>(a[0]) * b[0] + static_cast<double>(a[1]) * b[1] +
+                       static_cast<double>(a[2]) * b[2];
+    return std::atan2(std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]), dot) *
+           57.29577951308232;
+}
+
+static void TestNormalsAndPositions() {
+    std::vector<float> normals = {
+        // Axis-aligned normals and fold edges, which brush geometry hits constantly
+        1, 0, 0, -1, 0, 0, 0, 1, 0, 0, -1, 0, 0, 0, 1, 0, 0, -1,
+        0.70710678f, 0.70710678f, 0, -0.70710678f, 0, -0.70710678f,
+        0.57735027f, -0.57735027f, -0.57735027f, 0, 0.70710678f, -0.70710678f
+    };
+
+    std::mt19937 gen(4242);
+    std::normal_distribution<float> direction(0.0f, 1.0f);
+    while (normals.size() < 3 * 100000) {
+        float n[3] = {direction(gen), direction(gen), direction(gen)};
+        float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length < 1e-6f) continue;
+        normals.insert(normals.end(), {n[0] / length, n[1] / length, n[2] / length});
+    }
+
+    const size_t count = normals.size() / 3;
+    std::uniform_real_distribution<float> coord(-16384.0f, 16384.0f);
+    std::vector<float> positions(count * 3), uvs(count * 2, 0.25f);
+    for (float& p : positions) p = coord(gen);
+
+    const float noOffset[2] = {0.0f, 0.0f};
+    std::vector<CompactVertex> compact(count);
+    EncodeCompactVertices(positions.data(), normals.data(), uvs.data(), count, noOffset, compact.data());
+
+    std::vector<float> decodedPositions(count * 3), decodedNormals(count * 3);
+    DecodeCompactVertices(compact.data(), count, noOffset, decodedPositions.data(), decodedNormals.data(), nullptr);
+
+    CHECK(decodedPositions == positions);
+    double worst = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        worst = std::max(worst, AngleDegrees(&normals[i * 3], &decodedNormals[i * 3]));
+    }
+    CHECK(worst <= kNormalBoundDegrees);
+    std::printf("worst normal error over %zu normals: %.5f degrees\n", count, worst);
+
+    // Zero vectors decode as +Z
+    const float zero[3] = {0.0f, 0.0f, 0.0f};
+    int16_t encoded[2];
+    float decoded[3];
+    EncodeOctahedral(zero, encoded);
+    DecodeOctahedral(encoded, decoded);
+    CHECK(decoded[0] == 0.0f && decoded[1] == 0.0f && decoded[2] == 1.0f);
+}
+
+// Largest |decoded - original| over the UVs after a round trip at offset
+static double RoundTripUVError(const std::vector<float>& uvs, const float offset[2]) {
+    const size_t count = uvs.size() / 2;
+    std::vector<float> positions(count * 3, 0.0f), normals(count * 3, 0.0f);
+    for (size_t i = 0; i < count; i++) normals[i * 3 + 2] = 1.0f;
+
+    std::vector<CompactVertex> compact(count);
+    EncodeCompactVertices(positions.data(), normals.data(), uvs.data(), count, offset, compact.data());
+
+    std::vector<float> decoded(count * 2);
+    DecodeCompactVertices(compact.data(), count, offset, nullptr, nullptr, decoded.data());
+
+    double error = 0.0;
+    for (size_t i = 0; i < uvs.size(); i++) {
+        error = std::max(error, std::fabs(static_cast<double>(decoded[i]) - uvs[i]));
+    }
+    return error;
+}
+
+// World faces map 128 to 512 units onto a tile, so a 16384-unit map spans
+// up to a few hundred tiles; small meshes sit anywhere in that range
+static void TestRealisticUVRanges() {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> center(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> span(0.0f, 2.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    size_t accepted = 0;
+    double worst = 0.0;
+    for (int mesh = 0; mesh < 2000; mesh++) {
+        const float cu = center(gen), cv = center(gen);
+        const float su = span(gen), sv = span(gen);
+
+        std::vector<float> uvs;
+        for (int i = 0; i < 64; i++) {
+            uvs.push_back(cu + (unit(gen) - 0.5f) * su);
+            uvs.push_back(cv + (unit(gen) - 0.5f) * sv);
+        }
+
+        float offset[2];
+        if (!ChooseCompactUVOffset(uvs.data(), uvs.size() / 2, offset)) {
+            // Anything within one tile must fit
+            CHECK(su > 1.0f || sv > 1.0f);
+            continue;
+        }
+        accepted++;
+        CHECK(offset[0] == std::round(offset[0]) && offset[1] == std::round(offset[1]));
+        worst = std::max(worst, RoundTripUVError(uvs, offset));
+    }
+
+    CHECK(accepted > 500);
+    CHECK(worst <= kCompactUVAbsoluteBound);
+    std::printf("worst UV error over %zu meshes: %.3g tiles (%.3f texels at 1024)\n", accepted, worst,
+                worst * 1024.0);
+}
+
+static void TestWideRangesKeepFloats() {
+    // A chunk mesh whose UVs run over 300 tiles
+    std::vector<float> uvs;
+    for (int i = 0; i <= 300; i++) {
+        uvs.push_back(i + 0.3f);
+        uvs.push_back(-0.5f * i);
+    }
+
+    float offset[2];
+    CHECK(!ChooseCompactUVOffset(uvs.data(), uvs.size() / 2, offset));
+
+    // Encoded anyway, the far end would be off by tens of texels
+    const float floorOffset[2] = {0.0f, -150.0f};
+    CHECK(RoundTripUVError(uvs, floorOffset) * 1024.0 > 16.0);
+
+    // Edges of the accepted extent
+    const float edge[] = {-3.0f, 7.0f, -1.0f, 9.0f};
+    CHECK(ChooseCompactUVOffset(edge, 2, offset));
+    CHECK(offset[0] == -2.0f && offset[1] == 8.0f);
+    CHECK(RoundTripUVError(std::vector<float>(edge, edge + 4), offset) <= kCompactUVAbsoluteBound);
+
+    const float tooWide[] = {-3.0f, 7.0f, -0.9f, 9.0f};
+    CHECK(!ChooseCompactUVOffset(tooWide, 2, offset));
+
+    const float notFinite[] = {0.0f, 0.0f, NAN, 0.5f};
+    CHECK(!ChooseCompactUVOffset(notFinite, 2, offset));
+
+    CHECK(ChooseCompactUVOffset(nullptr, 0, offset));
+    CHECK(offset[0] == 0.0f && offset[1] == 0.0f);
+}
+
+int main() {
+    TestHalfConversion();
+    TestNormalsAndPositions();
+    TestRealisticUVRanges();
+    TestWideRangesKeepFloats();
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all compact vertex checks passed\n");
+    return 0;
+}
@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+# Writes sample.bsp, the tiny vised map the native tests run against.
+#
+# Twelve 256-unit rooms in a row along +x, each its own leaf and cluster,
+# split by the planes x = 0, 256, ..., 2816; everything at x < 0 is one
+# solid leaf. Each cluster sees itself and its two neighbours, so rows have
+# zero bytes and the run-length path of the vis decoder is exercised.
+#
+# World faces (model 0):
+#   0-11  floor of each room, alternating DEV/FLOOR and DEV/WALL
+#   12    ceiling of room 0 with a nodraw texture
+#   13    displacement face over room 3 (no DISPINFO lump, never decoded)
+#   14    degenerate two-edge face
+# Model 1 (a brush entity) owns face 15, a wall in room 5.
+#
+# Usage: python3 make_sample_bsp.py [out.bsp]
+
+import struct
+import sys
+
+ROOMS = 12
+ROOM = 256
+
+SURF_NODRAW = 0x0080
+
+LUMP_ENTITIES = 0
+LUMP_PLANES = 1
+LUMP_TEXDATA = 2
+LUMP_VERTEXES = 3
+LUMP_VISIBILITY = 4
+LUMP_NODES = 5
+LUMP_TEXINFO = 6
+LUMP_FACES = 7
+LUMP_LEAFS = 10
+LUMP_EDGES = 12
+LUMP_SURFEDGES = 13
+LUMP_MODELS = 14
+LUMP_TEXDATA_STRING_DATA = 43
+LUMP_TEXDATA_STRING_TABLE = 44
+HEADER_LUMPS = 64
+
+
+def planes():
+    out = [struct.pack("<3ffi", 1.0, 0.0, 0.0, float(i * ROOM), 0) for i in range(ROOMS)]
+    out.append(struct.pack("<3ffi", 0.0, 0.0, 1.0, 0.0, 2))  # Floors
+    out.append(struct.pack("<3ffi", 0.0, 0.0, -1.0, -float(ROOM), 2))  # Ceiling
+    out.append(struct.pack("<3ffi", 0.0, 1.0, 0.0, 128.0, 1))  # Brush entity wall
+    return b"".join(out)
+
+
+FLOOR_PLANE = ROOMS
+CEILING_PLANE = ROOMS + 1
+WALL_PLANE = ROOMS + 2
+
+
+def nodes():
+    # Node 0 splits off the solid leaf 0; node i (1..11) splits room i - 1
+    # (leaf i) from the rest. Children are written after their parent.
+    out = []
+    for i in range(ROOMS):
+        back = -1 if i == 0 else -(i + 1)
+        front = i + 1 if i + 1 < ROOMS else -(ROOMS + 1)
+        out.append(struct.pack("<i2i3h3hHHhh", i, front, back,
+                               i * ROOM - ROOM, 0, 0, ROOMS * ROOM, ROOM, ROOM, 0, 0, 0, 0))
+    return b"".join(out)
+
+
+def leaves():
+    # Version 1 leaves; leaf 0 is solid, leaf k + 1 is room k
+    out = [struct.pack("<ihh3h3hHHHHhh", 1, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1, 0)]
+    for k in range(ROOMS):
+        out.append(struct.pack("<ihh3h3hHHHHhh", 0, k, 0,
+                               k * ROOM, 0, 0, (k + 1) * ROOM, ROOM, ROOM, 0, 0, 0, 0, -1, 0))
+    return b"".join(out)
+
+
+def compress_row(row):
+    out = bytearray()
+    i = 0
+    while i < len(row):
+        if row[i]:
+            out.append(row[i])
+            i += 1
+            continue
+        run = 0
+        while i < len(row) and row[i] == 0 and run < 255:
+            run += 1
+            i += 1
+        out += bytes((0, run))
+    return bytes(out)
+
+
+def visibility():
+    row_bytes = (ROOMS + 7) // 8
+    rows = []
+    for c in range(ROOMS):
+        row = bytearray(row_bytes)
+        for seen in (c - 1, c, c + 1):
+            if 0 <= seen < ROOMS:
+                row[seen >> 3] |= 1 << (seen & 7)
+        rows.append(compress_row(bytes(row)))
+
+    offset = 4 + ROOMS * 8
+    table = bytearray(struct.pack("<i", ROOMS))
+    for row in rows:
+        table += struct.pack("<ii", offset, offset)
+        offset += len(row)
+    return bytes(table) + b"".join(rows)
+
+
+MATERIALS = ["DEV/FLOOR", "DEV/WALL", "TOOLS/TOOLSNODRAW"]
+
+
+def texture_lumps():
+    strings = bytearray()
+    table = []
+    texdata = []
+    for i, name in enumerate(MATERIALS):
+        table.append(struct.pack("<i", len(strings)))
+        strings += name.encode("ascii") + b"\0"
+        texdata.append(struct.pack("<3fi4i", 0.5, 0.5, 0.5, i, ROOM, ROOM, ROOM, ROOM))
+
+    texinfo = []
+    for i in range(len(MATERIALS)):
+        flags = SURF_NODRAW if MATERIALS[i].startswith("TOOLS/") else 0
+        texinfo.append(struct.pack("<8f8fii", 1, 0, 0, 0, 0, 1, 0, 0,
+                                   0, 0, 0, 0, 0, 0, 0, 0, flags, i))
+    return bytes(strings), b"".join(table), b"".join(texdata), b"".join(texinfo)
+
+
+class Geometry:
+    def __init__(self):
+        self.verts = []
+        self.edges = [(0, 0)]  # Edge 0 is never referenced
+        self.surfedges = []
+        self.faces = []
+
+    def add_face(self, corners, plane, texinfo, dispinfo=-1):
+        firstedge = len(self.surfedges)
+        first = len(self.verts)
+        self.verts += corners
+        n = len(corners)
+        for i in range(n):
+            a, b = first + i, first + (i + 1) % n
+            # Every other edge is stored reversed and walked backwards
+            if i % 2:
+                self.surfedges.append(-len(self.edges))
+                self.edges.append((b, a))
+            else:
+                self.surfedges.append(len(self.edges))
+                self.edges.append((a, b))
+        self.faces.append(struct.pack("<HBBihhhh4Bif2i2iiHHI",
+                                      plane, 0, 0, firstedge, n, texinfo, dispinfo, -1,
+                                      0, 255, 255, 255, -1, float(ROOM * ROOM), 0, 0, 0, 0, -1, 0, 0, 0))
+
+    def add_degenerate(self, plane, texinfo):
+        firstedge = len(self.surfedges)
+        first = len(self.verts)
+        self.verts += [(0.0, 0.0, 0.0), (1.0, 0.0, 0.0)]
+        self.surfedges += [len(self.edges), -len(self.edges)]
+        self.edges.append((first, first + 1))
+        self.faces.append(struct.pack("<HBBihhhh4Bif2i2iiHHI",
+                                      plane, 0, 0, firstedge, 2, texinfo, -1, -1,
+                                      0, 255, 255, 255, -1, 0.0, 0, 0, 0, 0, -1, 0, 0, 0))
+
+
+def room_quad(k, z):
+    x0, x1 = float(k * ROOM), float((k + 1) * ROOM)
+    return [(x0, 0.0, z), (x1, 0.0, z), (x1, float(ROOM), z), (x0, float(ROOM), z)]
+
+
+def geometry():
+    geo = Geometry()
+    for k in range(ROOMS):
+        geo.add_face(room_quad(k, 0.0), FLOOR_PLANE, k % 2)
+    geo.add_face(room_quad(0, float(ROOM)), CEILING_PLANE, 2)
+    geo.add_face(room_quad(3, 0.0), FLOOR_PLANE, 0, dispinfo=0)
+    geo.add_degenerate(FLOOR_PLANE, 0)
+    world_faces = len(geo.faces)
+
+    x0, x1 = 5.0 * ROOM, 6.0 * ROOM
+    geo.add_face([(x0, 128.0, 0.0), (x1, 128.0, 0.0), (x1, 128.0, 128.0), (x0, 128.0, 128.0)],
+                 WALL_PLANE, 1)
+
+    models = struct.pack("<9fiii", 0, 0, 0, ROOMS * ROOM, ROOM, ROOM, 0, 0, 0, 0, 0, world_faces)
+    models += struct.pack("<9fiii", x0, 128, 0, x1, 128, 128, 0, 0, 0, -1, world_faces, 1)
+
+    verts = b"".join(struct.pack("<3f", *v) for v in geo.verts)
+    edges = b"".join(struct.pack("<2H", *e) for e in geo.edges)
+    surfedges = b"".join(struct.pack("<i", e) for e in geo.surfedges)
+    return verts, edges, surfedges, b"".join(geo.faces), models
+
+
+def main():
+    out_path = sys.argv[1] if len(sys.argv) > 1 else "sample.bsp"
+
+    strings, table, texdata, texinfo = texture_lumps()
+    verts, edges, surfedges, faces, models = geometry()
+    lumps = {
+        LUMP_ENTITIES: (b'{\n"classname" "worldspawn"\n}\n\0', 0),
+        LUMP_PLANES: (planes(), 0),
+        LUMP_TEXDATA: (texdata, 0),
+        LUMP_VERTEXES: (verts, 0),
+        LUMP_VISIBILITY: (visibility(), 0),
+        LUMP_NODES: (nodes(), 0),
+        LUMP_TEXINFO: (texinfo, 0),
+        LUMP_FACES: (faces, 1),
+        LUMP_LEAFS: (leaves(), 1),
+        LUMP_EDGES: (edges, 0),
+        LUMP_SURFEDGES: (surfedges, 0),
+        LUMP_MODELS: (models, 0),
+        LUMP_TEXDATA_STRING_DATA: (strings, 0),
+        LUMP_TEXDATA_STRING_TABLE: (table, 0),
+    }
+
+    header_size = 8 + HEADER_LUMPS * 16 + 4
+    body = bytearray()
+    directory = []
+    for index in range(HEADER_LUMPS):
+        data, version = lumps.get(index, (b"", 0))
+        if not data:
+            directory.append(struct.pack("<iii4s", 0, 0, 0, b"\0\0\0\0"))
+            continue
+        while len(body) % 4:
+            body.append(0)
+        directory.append(struct.pack("<iii4s", header_size + len(body), len(data), version, b"\0\0\0\0"))
+        body += data
+
+    with open(out_path, "wb") as f:
+        f.write(b"VBSP" + struct.pack("<i", 20))
+        f.write(b"".join(directory))
+        f.write(struct.pack("<i", 1))
+        f.write(body)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,348 @@
+// Standalone tests for EntityManager::EntityTable: random adds, moves and
+// removals plus a sync must agree with a map-based reference, radius and box
+// queries with a brute-force filter, and render bounds must follow their
+// entity. Grid queries are also timed against linear scans over clustered
+// entities. Exits non-zero on a failed check.
+#include "entity_manager/entity_registry.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace EntityManager;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+struct Reference {
+    uint16_t classId;
+    float x, y, z;
+    int handle;
+};
+
+using ReferenceMap = std::map<int32_t, Reference>;
+
+static bool RowsMatch(const EntityTable& table, const ReferenceMap& reference) {
+    if (table.Size() != reference.size()) return false;
+    for (const auto& [index, ref] : reference) {
+        uint32_t row = table.Find(index);
+        if (row == EntityTable::kNoRow || table.Indices()[row] != index ||
+            table.ClassIds()[row] != ref.classId || table.Handles()[row] != ref.handle ||
+            table.X()[row] != ref.x || table.Y()[row] != ref.y || table.Z()[row] != ref.z) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Random adds, moves and removals; every Remove must report what the
+// reference holds
+static void FillRandom(EntityTable& table, ReferenceMap& reference, size_t count) {
+    std::mt19937 rng(4242);
+    std::uniform_int_distribution<int32_t> pickIndex(0, static_cast<int32_t>(std::max<size_t>(count, 1) * 2));
+    std::uniform_real_distribution<float> coord(-8192.0f, 8192.0f);
+    std::uniform_int_distribution<int> pickOp(0, 9);
+
+    size_t badRemovals = 0;
+    for (size_t op = 0; op < count * 4; op++) {
+        int32_t index = pickIndex(rng);
+        if (pickOp(rng) < 2) {
+            int handle = -1;
+            bool removed = table.Remove(index, &handle);
+            auto it = reference.find(index);
+            if (removed != (it != reference.end()) || (removed && handle != it->second.handle)) badRemovals++;
+            if (it != reference.end()) reference.erase(it);
+        } else {
+            Reference ref = {static_cast<uint16_t>(index % 17), coord(rng), coord(rng), coord(rng), static_cast<int>(op)};
+            table.Set(index, ref.classId, ref.x, ref.y, ref.z, ref.handle);
+            reference[index] = ref;
+        }
+    }
+    CHECK(badRemovals == 0);
+    CHECK(RowsMatch(table, reference));
+}
+
+static void TestQueries(size_t count) {
+    EntityTable table;
+    ReferenceMap reference;
+    FillRandom(table, reference, count);
+
+    // Points on the query edges must be included
+    const float center[3] = {0.0f, 0.0f, 0.0f};
+    const float radius = 2048.0f;
+    const float mins[3] = {-1024.0f, -4096.0f, -512.0f};
+    const float maxs[3] = {3072.0f, 1024.0f, 4096.0f};
+    CHECK(table.Set(-5, 0, 1.0f, 2.0f, 3.0f, 0) == EntityTable::kNoRow);  // Negative indices are ignored
+    table.Set(static_cast<int32_t>(count * 2 + 1), 1, radius, 0.0f, 0.0f, 1);
+    reference[static_cast<int32_t>(count * 2 + 1)] = {1, radius, 0.0f, 0.0f, 1};
+    table.Set(static_cast<int32_t>(count * 2 + 2), 2, mins[0], maxs[1], mins[2], 2);
+    reference[static_cast<int32_t>(count * 2 + 2)] = {2, mins[0], maxs[1], mins[2], 2};
+    CHECK(RowsMatch(table, reference));
+
+    std::vector<uint32_t> rows, scanned;
+    std::vector<int32_t> found, expected;
+
+    table.QueryRadius(center, radius, rows);
+    for (uint32_t row : rows) found.push_back(table.Indices()[row]);
+    for (const auto& [index, ref] : reference) {
+        if (ref.x * ref.x + ref.y * ref.y + ref.z * ref.z <= radius * radius) expected.push_back(index);
+    }
+    std::sort(found.begin(), found.end());
+    CHECK(found == expected);
+    CHECK(std::binary_search(found.begin(), found.end(), static_cast<int32_t>(count * 2 + 1)));
+
+    table.ScanRadius(center, radius, scanned);
+    std::sort(rows.begin(), rows.end());
+    CHECK(rows == scanned);
+
+    found.clear();
+    expected.clear();
+    table.QueryBox(mins, maxs, rows);
+    for (uint32_t row : rows) found.push_back(table.Indices()[row]);
+    for (const auto& [index, ref] : reference) {
+        if (ref.x >= mins[0] && ref.x <= maxs[0] && ref.y >= mins[1] && ref.y <= maxs[1] &&
+            ref.z >= mins[2] && ref.z <= maxs[2]) {
+            expected.push_back(index);
+        }
+    }
+    std::sort(found.begin(), found.end());
+    CHECK(found == expected);
+    CHECK(std::binary_search(found.begin(), found.end(), static_cast<int32_t>(count * 2 + 2)));
+
+    table.ScanBox(mins, maxs, scanned);
+    std::sort(rows.begin(), rows.end());
+    CHECK(rows == scanned);
+}
+
+static void TestSync(size_t count) {
+    EntityTable table;
+    ReferenceMap reference;
+    FillRandom(table, reference, count);
+
+    // A sync that only touches every other entity drops the rest
+    std::vector<int32_t> kept, dropped;
+    bool keep = true;
+    for (const auto& entry : reference) {
+        (keep ? kept : dropped).push_back(entry.first);
+        keep = !keep;
+    }
+
+    table.BeginSync();
+    for (int32_t index : kept) {
+        Reference& ref = reference[index];
+        ref.z += 1.0f;
+        table.Set(index, ref.classId, ref.x, ref.y, ref.z, ref.handle);
+    }
+    std::vector<int> removedHandles;
+    CHECK(table.EndSync(&removedHandles) == dropped.size());
+    CHECK(removedHandles.size() == dropped.size());
+
+    std::vector<int> expectedHandles;
+    for (int32_t index : dropped) {
+        expectedHandles.push_back(reference[index].handle);
+        reference.erase(index);
+    }
+    std::sort(removedHandles.begin(), removedHandles.end());
+    std::sort(expectedHandles.begin(), expectedHandles.end());
+    CHECK(removedHandles == expectedHandles);
+    CHECK(RowsMatch(table, reference));
+
+    // An empty sync drops everything
+    table.BeginSync();
+    CHECK(table.EndSync() == reference.size());
+    CHECK(table.Size() == 0);
+}
+
+static void TestRenderBounds(size_t count) {
+    EntityTable table;
+    ReferenceMap reference;
+    FillRandom(table, reference, count);
+
+    // Render bounds are recorded once, survive moves and row shuffles, and
+    // are gone for an index that was removed and added again
+    const float boundsMins[3] = {-64.0f, -64.0f, -64.0f};
+    const float boundsMaxs[3] = {64.0f, 64.0f, 64.0f};
+    const float tallerMaxs[3] = {64.0f, 64.0f, 128.0f};
+    size_t notRecorded = 0;
+    for (const auto& entry : reference) {
+        uint32_t row = table.Find(entry.first);
+        if (!table.UpdateRenderBounds(row, boundsMins, boundsMaxs) ||
+            table.UpdateRenderBounds(row, boundsMins, boundsMaxs)) {
+            notRecorded++;
+        }
+    }
+    CHECK(notRecorded == 0);
+
+    std::vector<int32_t> readded;
+    bool keep = true;
+    for (auto it = reference.begin(); it != reference.end();) {
+        if (keep) {
+            Reference& ref = it->second;
+            ref.x += 1.0f;
+            table.Set(it->first, ref.classId, ref.x, ref.y, ref.z, ref.handle);
+            ++it;
+        } else {
+            // Removing the other half shuffles rows under the kept entities
+            table.Remove(it->first);
+            readded.push_back(it->first);
+            it = reference.erase(it);
+        }
+        keep = !keep;
+    }
+    CHECK(RowsMatch(table, reference));
+
+    size_t lost = 0, stale = 0;
+    for (const auto& entry : reference) {
+        if (table.UpdateRenderBounds(table.Find(entry.first), boundsMins, boundsMaxs)) lost++;
+    }
+    for (int32_t index : readded) {
+        table.Set(index, 0, 0.0f, 0.0f, 0.0f, 0);
+        if (!table.UpdateRenderBounds(table.Find(index), boundsMins, boundsMaxs)) stale++;
+        table.Remove(index);
+    }
+    CHECK(lost == 0);
+    CHECK(stale == 0);
+
+    if (!reference.empty()) {
+        uint32_t row = table.Find(reference.begin()->first);
+        CHECK(table.UpdateRenderBounds(row, boundsMins, tallerMaxs));
+        table.InvalidateRenderBounds(row);
+        CHECK(table.UpdateRenderBounds(row, boundsMins, tallerMaxs));
+    }
+
+    // Handing an entity over forgets its recorded bounds and can happen
+    // before its first sync; removing it drops the flag
+    const int32_t unsynced = static_cast<int32_t>(count * 2 + 3);
+    table.SetBoundsManaged(unsynced, true);
+    table.Set(unsynced, 0, 0.0f, 0.0f, 0.0f, 0);
+    CHECK(table.IsBoundsManaged(unsynced));
+    CHECK(!table.IsBoundsManaged(unsynced + 1));
+    table.Remove(unsynced);
+    CHECK(!table.IsBoundsManaged(unsynced));
+
+    if (!reference.empty()) {
+        const int32_t index = reference.begin()->first;
+        table.SetBoundsManaged(index, true);
+        CHECK(table.IsBoundsManaged(index));
+        CHECK(table.UpdateRenderBounds(table.Find(index), boundsMins, boundsMaxs));
+        table.SetBoundsManaged(index, false);
+        CHECK(!table.IsBoundsManaged(index));
+    }
+
+    CHECK(RowsMatch(table, reference));
+
+    table.Clear();
+    CHECK(table.Size() == 0 && table.Find(reference.empty() ? 0 : reference.begin()->first) == EntityTable::kNoRow);
+}
+
+// Spread over a large map, clustered the way props and NPCs bunch up in
+// rooms, with every query centered on an entity like a player among them
+static void TestGridMatchesScan(size_t count, size_t queries) {
+    using Clock = std::chrono::high_resolution_clock;
+    auto elapsedMs = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> coord(-14000.0f, 14000.0f);
+    std::normal_distribution<float> spread(0.0f, 600.0f);
+    std::uniform_real_distribution<float> step(-24.0f, 24.0f);
+    std::vector<float> clusters(64 * 3);
+    for (float& c : clusters) c = coord(rng);
+
+    std::vector<float> positions(count * 3);
+    for (size_t i = 0; i < count; i++) {
+        const float* cluster = clusters.data() + (i % 64) * 3;
+        for (int axis = 0; axis < 3; axis++) positions[i * 3 + axis] = cluster[axis] + spread(rng);
+    }
+
+    EntityTable table;
+    auto start = Clock::now();
+    for (size_t i = 0; i < count; i++) {
+        table.Set(static_cast<int32_t>(i + 1), 0, positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2], 0);
+    }
+    double buildMs = elapsedMs(start);
+
+    // One sync where every entity moved a little
+    for (float& p : positions) p += step(rng);
+    start = Clock::now();
+    table.BeginSync();
+    for (size_t i = 0; i < count; i++) {
+        table.Set(static_cast<int32_t>(i + 1), 0, positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2], 0);
+    }
+    CHECK(table.EndSync() == 0);
+    double moveMs = elapsedMs(start);
+
+    const float radius = 2048.0f;
+    std::uniform_int_distribution<size_t> pick(0, count - 1);
+    std::vector<uint32_t> gridRows, scanRows;
+    double gridRadiusMs = 0.0, scanRadiusMs = 0.0, gridBoxMs = 0.0, scanBoxMs = 0.0, nearestMs = 0.0;
+    size_t hits = 0, radiusMismatches = 0, boxMismatches = 0, shortNearest = 0;
+
+    for (size_t q = 0; q < queries; q++) {
+        const float* center = positions.data() + pick(rng) * 3;
+
+        start = Clock::now();
+        table.QueryRadius(center, radius, gridRows);
+        gridRadiusMs += elapsedMs(start);
+
+        start = Clock::now();
+        table.ScanRadius(center, radius, scanRows);
+        scanRadiusMs += elapsedMs(start);
+
+        hits += gridRows.size();
+        std::sort(gridRows.begin(), gridRows.end());
+        if (gridRows != scanRows) radiusMismatches++;
+
+        const float mins[3] = {center[0] - radius, center[1] - radius, center[2] - 512.0f};
+        const float maxs[3] = {center[0] + radius, center[1] + radius, center[2] + 512.0f};
+
+        start = Clock::now();
+        table.QueryBox(mins, maxs, gridRows);
+        gridBoxMs += elapsedMs(start);
+
+        start = Clock::now();
+        table.ScanBox(mins, maxs, scanRows);
+        scanBoxMs += elapsedMs(start);
+
+        std::sort(gridRows.begin(), gridRows.end());
+        if (gridRows != scanRows) boxMismatches++;
+
+        start = Clock::now();
+        table.QueryNearest(center, 16, gridRows);
+        nearestMs += elapsedMs(start);
+        if (gridRows.size() != std::min<size_t>(16, count)) shortNearest++;
+    }
+    CHECK(radiusMismatches == 0);
+    CHECK(boxMismatches == 0);
+    CHECK(shortNearest == 0);
+
+    std::printf("%zu entities, %zu queries: build %.2f ms, move-all %.2f ms, radius grid %.2f ms / linear %.2f ms "
+                "(%.1f hits), box grid %.2f ms / linear %.2f ms, 16-nearest %.2f ms\n",
+                count, queries, buildMs, moveMs, gridRadiusMs, scanRadiusMs,
+                static_cast<double>(hits) / queries, gridBoxMs, scanBoxMs, nearestMs);
+}
+
+int main() {
+    TestQueries(4096);
+    TestSync(4096);
+    TestRenderBounds(4096);
+    TestGridMatchesScan(1000, 500);
+    TestGridMatchesScan(50000, 500);
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all entity table checks passed\n");
+    return 0;
+}
@@ -0,0 +1,191 @@
+// Standalone tests for MeshBuilder::MergeCoplanarFaces: a tiled synthetic
+// floor and wall must merge into fewer triangles while area, UV mapping,
+// winding and convexity survive. Exits non-zero on a failed check.
+#include "mesh_builder/face_merge.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace MeshBuilder;
+using Vec3 = BSPReader::Vec3;
+using Vertex = BSPReader::TriangleVertex;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+static Vec3 Sub(const Vec3& a, const Vec3& b) {
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+static Vec3 Cross(const Vec3& a, const Vec3& b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+static float Dot(const Vec3& a, const Vec3& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static double TriangleArea(const Vertex* tri) {
+    Vec3 n = Cross(Sub(tri[1].pos, tri[0].pos), Sub(tri[2].pos, tri[0].pos));
+    return 0.5 * std::sqrt(static_cast<double>(Dot(n, n)));
+}
+
+// Texture projection of the test faces; UV is linear in position
+struct Projection {
+    uint32_t texInfo;
+    Vec3 normal;
+    Vec3 s, t;
+};
+
+static void AddQuad(BSPReader::MaterialStream& stream, const Projection& projection, const Vec3 corners[4]) {
+    BSPReader::FaceRange range = {};
+    range.faceIndex = static_cast<uint32_t>(stream.faces.size());
+    range.texInfo = projection.texInfo;
+    range.firstVertex = static_cast<uint32_t>(stream.vertices.size());
+    range.vertexCount = 6;
+    range.mins = range.maxs = corners[0];
+    for (int c = 0; c < 4; c++) {
+        const Vec3& p = corners[c];
+        range.mins = {std::min(range.mins.x, p.x), std::min(range.mins.y, p.y), std::min(range.mins.z, p.z)};
+        range.maxs = {std::max(range.maxs.x, p.x), std::max(range.maxs.y, p.y), std::max(range.maxs.z, p.z)};
+    }
+
+    const int fan[6] = {0, 1, 2, 0, 2, 3};
+    for (int i : fan) {
+        Vertex v;
+        v.pos = corners[i];
+        v.normal = projection.normal;
+        v.u = Dot(v.pos, projection.s);
+        v.v = Dot(v.pos, projection.t);
+        stream.vertices.push_back(v);
+    }
+    stream.faces.push_back(range);
+}
+
+static bool SamePosition(const Vec3& a, const Vec3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+// A fan is v0 v1 v2, then v0 v(i) v(i+1); false when the triangles do not
+// chain that way or any corner of the polygon turns against the normal
+static bool IsConvexFan(const Vertex* vertices, size_t count, const Vec3& normal) {
+    if (count < 3 || count % 3 != 0) return false;
+    std::vector<Vec3> corners = {vertices[0].pos, vertices[1].pos, vertices[2].pos};
+    for (size_t t = 3; t < count; t += 3) {
+        if (!SamePosition(vertices[t].pos, corners[0]) || !SamePosition(vertices[t + 1].pos, corners.back())) {
+            return false;
+        }
+        corners.push_back(vertices[t + 2].pos);
+    }
+    for (size_t c = 0; c < corners.size(); c++) {
+        const Vec3& prev = corners[(c + corners.size() - 1) % corners.size()];
+        const Vec3& next = corners[(c + 1) % corners.size()];
+        if (Dot(Cross(Sub(corners[c], prev), Sub(next, corners[c])), normal) <= 0.0f) return false;
+    }
+    return true;
+}
+
+static void TestTiledFloorAndWall(size_t tiles) {
+    const float tile = 64.0f;
+    const Projection floor = {1, {0, 0, 1}, {1.0f / 128.0f, 0, 0}, {0, 1.0f / 128.0f, 0}};
+    const Projection shifted = {2, {0, 0, 1}, {1.0f / 128.0f, 0, 0}, {0, -1.0f / 96.0f, 0}};
+    const Projection wall = {3, {-1, 0, 0}, {0, 1.0f / 64.0f, 0}, {0, 0, 1.0f / 64.0f}};
+    const Projection projections[] = {floor, shifted, wall};
+
+    // A floor whose right third uses a second texinfo (must not merge across)
+    // and a wall on the x = 0 plane, both wound counter-clockwise around the normal
+    BSPReader::WorldGeometry world;
+    world.materials.resize(1);
+    BSPReader::MaterialStream& stream = world.materials[0];
+    stream.material = "test/face_merge";
+    for (size_t i = 0; i < tiles; i++) {
+        for (size_t j = 0; j < tiles; j++) {
+            float x = i * tile, y = j * tile;
+            Vec3 quad[4] = {{x, y, 0}, {x + tile, y, 0}, {x + tile, y + tile, 0}, {x, y + tile, 0}};
+            AddQuad(stream, i * 3 >= tiles * 2 ? shifted : floor, quad);
+
+            Vec3 side[4] = {{0, y, x}, {0, y, x + tile}, {0, y + tile, x + tile}, {0, y + tile, x}};
+            AddQuad(stream, wall, side);
+        }
+    }
+    world.faceCount = stream.faces.size();
+    world.triangleCount = stream.vertices.size() / 3;
+
+    double areaBefore[3] = {};
+    for (const auto& face : stream.faces) {
+        for (uint32_t v = 0; v < face.vertexCount; v += 3) {
+            areaBefore[face.texInfo - 1] += TriangleArea(&stream.vertices[face.firstVertex + v]);
+        }
+    }
+
+    FaceMergeOptions options;
+    options.maxExtent = tile * 16;
+    FaceMergeStats stats;
+    MergeCoplanarFaces(world, options, nullptr, &stats);
+
+    CHECK(stats.trianglesAfter < stats.trianglesBefore);
+    CHECK(world.faceCount == stats.facesAfter);
+    CHECK(world.triangleCount == stream.vertices.size() / 3);
+
+    double areaAfter[3] = {};
+    size_t oversized = 0, badWinding = 0, badUVs = 0, concave = 0;
+    for (const auto& face : stream.faces) {
+        CHECK(face.texInfo >= 1 && face.texInfo <= 3);
+        if (face.texInfo < 1 || face.texInfo > 3) continue;
+        const Projection& projection = projections[face.texInfo - 1];
+
+        if (face.maxs.x - face.mins.x > options.maxExtent || face.maxs.y - face.mins.y > options.maxExtent ||
+            face.maxs.z - face.mins.z > options.maxExtent) {
+            oversized++;
+        }
+
+        for (uint32_t v = 0; v < face.vertexCount; v += 3) {
+            const Vertex* tri = &stream.vertices[face.firstVertex + v];
+            areaAfter[face.texInfo - 1] += TriangleArea(tri);
+
+            // Winding kept, UVs still follow the face's own projection
+            Vec3 n = Cross(Sub(tri[1].pos, tri[0].pos), Sub(tri[2].pos, tri[0].pos));
+            if (Dot(n, projection.normal) <= 0.0f) badWinding++;
+            for (int c = 0; c < 3; c++) {
+                if (std::fabs(tri[c].u - Dot(tri[c].pos, projection.s)) >= 1e-5f ||
+                    std::fabs(tri[c].v - Dot(tri[c].pos, projection.t)) >= 1e-5f) {
+                    badUVs++;
+                }
+            }
+        }
+
+        if (!IsConvexFan(&stream.vertices[face.firstVertex], face.vertexCount, projection.normal)) concave++;
+    }
+    CHECK(oversized == 0);
+    CHECK(badWinding == 0);
+    CHECK(badUVs == 0);
+    CHECK(concave == 0);
+
+    for (int p = 0; p < 3; p++) {
+        CHECK(std::fabs(areaAfter[p] - areaBefore[p]) <= areaBefore[p] * 1e-6);
+    }
+
+    std::printf("%zu -> %zu faces, %zu -> %zu triangles, %zu corners dropped, %.2f ms\n", stats.facesBefore,
+                stats.facesAfter, stats.trianglesBefore, stats.trianglesAfter, stats.removedVertices,
+                stats.milliseconds);
+}
+
+int main() {
+    TestTiledFloorAndWall(2);
+    TestTiledFloorAndWall(32);
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all face merge checks passed\n");
+    return 0;
+}
@@ -0,0 +1,146 @@
+// Standalone tests for the on-disk chunk mesh cache: a written cache opens
+// again, and files whose checksum passes but whose indices point past the
+// vertices are rejected. Exits non-zero on a failed check.
+#include "mesh_builder/mesh_cache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace MeshBuilder;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+static const char* kCachePath = "mesh_cache_tests.dat";
+
+// Offsets into the file layout written by WriteChunkMeshCache
+static const size_t kHeaderSize = 48;
+static const size_t kPayloadCRCOffset = 40;
+static const size_t kMaterialRecordSize = 16;
+static const size_t kIndexOffsetInRecord = 72;
+static const size_t kLodOffsetInRecord = 96;
+
+static std::vector<uint8_t> ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void WriteFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+// Rewrites the payload checksum so only the range checks can catch a change
+static void ResealPayload(std::vector<uint8_t>& bytes) {
+    uint32_t crc = Crc32(bytes.data() + kHeaderSize, bytes.size() - kHeaderSize);
+    std::memcpy(&bytes[kPayloadCRCOffset], &crc, sizeof(crc));
+}
+
+static uint64_t ReadOffset(const std::vector<uint8_t>& bytes, size_t at) {
+    uint64_t offset;
+    std::memcpy(&offset, &bytes[at], sizeof(offset));
+    return offset;
+}
+
+// A welded quad with one LOD level
+static ChunkMesh MakeQuad() {
+    ChunkMesh mesh = {};
+    mesh.chunkKey = 7;
+    mesh.material = 0;
+    for (int i = 0; i < 4; i++) {
+        Vertex vert = {};
+        vert.pos = {static_cast<float>(i & 1), static_cast<float>(i >> 1), 0.0f};
+        vert.normal = {0.0f, 0.0f, 1.0f};
+        mesh.vertices.push_back(vert);
+    }
+    mesh.indices.Assign(std::vector<uint32_t>{0, 1, 2, 1, 3, 2}, mesh.vertices.size());
+    mesh.lods.resize(1);
+    mesh.lods[0].Assign(std::vector<uint32_t>{0, 1, 2}, mesh.vertices.size());
+    mesh.mins = {0.0f, 0.0f, 0.0f};
+    mesh.maxs = {1.0f, 1.0f, 0.0f};
+    return mesh;
+}
+
+static void TestTamperedIndices() {
+    ChunkCacheKey key;
+    key.mapCRC = 0x1234u;
+    key.mapSize = 4096;
+    key.paramsHash = HashChunkBuildOptions(ChunkBuildOptions());
+
+    const std::vector<CachedMaterial> materials = {{"DEV/FLOOR", 0}};
+    const std::vector<ChunkMesh> meshes = {MakeQuad()};
+
+    std::string error;
+    CHECK(WriteChunkMeshCache(kCachePath, key, materials, meshes, error));
+    const std::vector<uint8_t> written = ReadFile(kCachePath);
+    CHECK(written.size() > kHeaderSize);
+    if (written.size() <= kHeaderSize) return;
+
+    ChunkMeshCache cache;
+    CHECK(cache.Open(kCachePath, key, error));
+    CHECK(cache.Meshes().size() == 1);
+    if (cache.Meshes().size() == 1) {
+        const CachedChunkMesh& mesh = cache.Meshes()[0];
+        CHECK(mesh.vertexCount == 4 && mesh.indexCount == 6 && mesh.indexSize == 2);
+        CHECK(mesh.lodCount == 1 && mesh.lodIndexCounts[0] == 3);
+    }
+    cache.Close();
+
+    const size_t record = kHeaderSize + materials.size() * kMaterialRecordSize;
+    const uint64_t indexOffset = ReadOffset(written, record + kIndexOffsetInRecord);
+    const uint64_t lodOffset = ReadOffset(written, record + kLodOffsetInRecord);
+
+    // A main index one past the last vertex
+    std::vector<uint8_t> tampered = written;
+    const uint16_t pastEnd = 4;
+    std::memcpy(&tampered[indexOffset + 2 * sizeof(uint16_t)], &pastEnd, sizeof(pastEnd));
+    ResealPayload(tampered);
+    WriteFile(kCachePath, tampered);
+    CHECK(!cache.Open(kCachePath, key, error));
+    CHECK(error == "mesh indices are out of range");
+    CHECK(!cache.IsOpen() && cache.Meshes().empty());
+
+    // A LOD index far out of range
+    tampered = written;
+    const uint16_t far = 0xFFFF;
+    std::memcpy(&tampered[lodOffset], &far, sizeof(far));
+    ResealPayload(tampered);
+    WriteFile(kCachePath, tampered);
+    CHECK(!cache.Open(kCachePath, key, error));
+    CHECK(error == "mesh indices are out of range");
+
+    // Without resealing the checksum catches the same change first
+    tampered = written;
+    std::memcpy(&tampered[indexOffset], &pastEnd, sizeof(pastEnd));
+    WriteFile(kCachePath, tampered);
+    CHECK(!cache.Open(kCachePath, key, error));
+    CHECK(error == "cache checksum mismatch");
+
+    // The untouched file still opens
+    WriteFile(kCachePath, written);
+    CHECK(cache.Open(kCachePath, key, error));
+    cache.Close();
+
+    std::remove(kCachePath);
+}
+
+int main() {
+    TestTamperedIndices();
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all mesh cache checks passed\n");
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Standalone tests for MeshBuilder::SimplifyMesh: a rolling displacement-like
+// grid simplified to a quarter of its triangles must keep its borders,
+// winding, area and stay near the source surface. Exits non-zero on a
+// failed check.
+#include "mesh_builder/mesh_simplifier.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace MeshBuilder;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+static float Height(float x, float y) {
+    return 8.0f * std::sin(x * 0.0125f) * std::cos(y * 0.009375f);
+}
+
+static void TestRollingGrid(uint32_t n, float maxError) {
+    const float spacing = 16.0f;
+
+    // Open borders on all four sides
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y <= n; y++) {
+        for (uint32_t x = 0; x <= n; x++) {
+            Vertex vert;
+            vert.pos = {x * spacing, y * spacing, Height(x * spacing, y * spacing)};
+            vert.normal = {0, 0, 1};
+            vert.u = static_cast<float>(x) / n;
+            vert.v = static_cast<float>(y) / n;
+            vertices.push_back(vert);
+        }
+    }
+    for (uint32_t y = 0; y < n; y++) {
+        for (uint32_t x = 0; x < n; x++) {
+            uint32_t a = y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+            indices.insert(indices.end(), {a, b, d, a, d, c});
+        }
+    }
+
+    SimplifyOptions options;
+    options.targetIndexCount = indices.size() / 4;
+    options.maxError = maxError;
+    SimplifyStats stats;
+    std::vector<uint32_t> simplified(indices.size());
+    auto start = std::chrono::high_resolution_clock::now();
+    simplified.resize(SimplifyMesh(simplified.data(), indices.data(), indices.size(),
+                                   vertices.data(), vertices.size(), options, &stats));
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    CHECK(!simplified.empty() && simplified.size() < indices.size());
+    CHECK(simplified.size() % 3 == 0);
+    CHECK(stats.error <= maxError);
+    CHECK(stats.lockedVertices == 4 * n);
+
+    // Every border vertex must survive so neighbouring meshes still meet
+    std::vector<uint8_t> used(vertices.size(), 0);
+    for (uint32_t index : simplified) used[index] = 1;
+    size_t lostBorder = 0;
+    for (uint32_t i = 0; i <= n; i++) {
+        if (!used[i] || !used[n * (n + 1) + i] || !used[i * (n + 1)] || !used[i * (n + 1) + n]) lostBorder++;
+    }
+    CHECK(lostBorder == 0);
+
+    // No flipped triangles, the same projected area, and every triangle
+    // center stays near the source surface
+    double area = 0.0;
+    size_t flipped = 0, offSurface = 0;
+    for (size_t t = 0; t + 2 < simplified.size(); t += 3) {
+        const Vec3& a = vertices[simplified[t]].pos;
+        const Vec3& b = vertices[simplified[t + 1]].pos;
+        const Vec3& c = vertices[simplified[t + 2]].pos;
+        float crossZ = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (crossZ <= 0.0f) flipped++;
+        area += crossZ * 0.5;
+
+        float cx = (a.x + b.x + c.x) / 3.0f, cy = (a.y + b.y + c.y) / 3.0f, cz = (a.z + b.z + c.z) / 3.0f;
+        if (std::fabs(cz - Height(cx, cy)) > maxError * 4.0f) offSurface++;
+    }
+    CHECK(flipped == 0);
+    CHECK(offSurface == 0);
+
+    double expected = static_cast<double>(n * spacing) * (n * spacing);
+    CHECK(std::fabs(area - expected) <= expected * 1e-4);
+
+    std::printf("%ux%u grid: %zu -> %zu indices, %zu collapses, %zu locked, error %.3f units, %.2f ms\n", n, n,
+                indices.size(), simplified.size(), stats.collapses, stats.lockedVertices, stats.error, ms);
+}
+
+int main() {
+    TestRollingGrid(16, 2.0f);
+    TestRollingGrid(64, 2.0f);
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all mesh simplifier checks passed\n");
+    return 0;
+}
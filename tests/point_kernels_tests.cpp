@@ -0,0 +1,202 @@
+// Standalone tests for the batched point containment kernels: points placed
+// exactly on, one float step inside and one step outside the sphere and box
+// edges, non-finite points and ragged tails, then every SIMD level against
+// the scalar path over random points. Exits non-zero on a failed check.
+#include "math/point_kernels.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <initializer_list>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace RTXMath;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+// Expected verdict of an edge point; points built for one shape are only
+// checked against that shape
+enum Verdict : int8_t { DontCare = -1, Outside = 0, Inside = 1 };
+
+struct PointSet {
+    std::vector<float> x, y, z;
+    std::vector<int8_t> inSphere, inBox;
+
+    void Add(float px, float py, float pz, Verdict sphere, Verdict box) {
+        x.push_back(px);
+        y.push_back(py);
+        z.push_back(pz);
+        inSphere.push_back(sphere);
+        inBox.push_back(box);
+    }
+};
+
+// Power-of-two radius and a center in [0, radius): center + radius has the
+// same float spacing as radius, so points one step off the surface keep
+// that step through the subtraction and land on the right side
+static const float kCenter[3] = {512.0f, 256.0f, 64.0f};
+static const float kRadius = 1024.0f;
+static const float kMins[3] = {-1000.0f, -250.5f, 0.0f};
+static const float kMaxs[3] = {1500.25f, 3000.0f, 0.0f};  // Flat in z
+
+// Runs select and mask at every supported level; all of them must return
+// the scalar select result, which is left in sphereHits/boxHits
+static void CheckAllLevels(const PointSet& points, std::vector<uint32_t>& sphereHits,
+                           std::vector<uint32_t>& boxHits) {
+    const size_t count = points.x.size();
+    const size_t words = (count + 63) / 64;
+    const float *x = points.x.data(), *y = points.y.data(), *z = points.z.data();
+
+    std::vector<uint32_t> selected(count);
+    // One guard word past the end must be left alone
+    std::vector<uint64_t> mask(words + 1, ~0ull);
+    auto maskToIndices = [&]() {
+        std::vector<uint32_t> indices;
+        for (size_t w = 0; w < words; w++) {
+            for (int bit = 0; bit < 64; bit++) {
+                if ((mask[w] >> bit) & 1) indices.push_back(static_cast<uint32_t>(w * 64 + bit));
+            }
+        }
+        return indices;
+    };
+
+    for (int level = 0; level <= static_cast<int>(DetectSimdLevel()); level++) {
+        const SimdLevel simd = static_cast<SimdLevel>(level);
+
+        size_t n = SelectPointsInSphere(x, y, z, count, kCenter, kRadius, selected.data(), simd);
+        std::vector<uint32_t> sphere(selected.begin(), selected.begin() + n);
+        n = MaskPointsInSphere(x, y, z, count, kCenter, kRadius, mask.data(), simd);
+        CHECK(n == sphere.size());
+        CHECK(maskToIndices() == sphere);
+        CHECK(mask[words] == ~0ull);
+
+        n = SelectPointsInBox(x, y, z, count, kMins, kMaxs, selected.data(), simd);
+        std::vector<uint32_t> box(selected.begin(), selected.begin() + n);
+        n = MaskPointsInBox(x, y, z, count, kMins, kMaxs, mask.data(), simd);
+        CHECK(n == box.size());
+        CHECK(maskToIndices() == box);
+        CHECK(mask[words] == ~0ull);
+
+        if (level == 0) {
+            sphereHits = sphere;
+            boxHits = box;
+        } else {
+            CHECK(sphere == sphereHits);
+            CHECK(box == boxHits);
+        }
+    }
+}
+
+static bool MatchesVerdicts(const std::vector<int8_t>& verdicts, const std::vector<uint32_t>& hits) {
+    for (size_t i = 0, h = 0; i < verdicts.size(); i++) {
+        bool hit = h < hits.size() && hits[h] == i;
+        h += hit ? 1 : 0;
+        if (verdicts[i] != DontCare && hit != (verdicts[i] == Inside)) return false;
+    }
+    return true;
+}
+
+static void TestEdges() {
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    auto up = [inf](float v) { return std::nextafter(v, inf); };
+    auto down = [inf](float v) { return std::nextafter(v, -inf); };
+
+    PointSet edges;
+    for (int axis = 0; axis < 3; axis++) {
+        float p[3] = {kCenter[0], kCenter[1], kCenter[2]};
+        p[axis] = kCenter[axis] - kRadius;
+        edges.Add(p[0], p[1], p[2], Inside, DontCare);
+        p[axis] = kCenter[axis] + kRadius;
+        edges.Add(p[0], p[1], p[2], Inside, DontCare);
+        p[axis] = up(kCenter[axis] + kRadius);
+        edges.Add(p[0], p[1], p[2], Outside, DontCare);
+        p[axis] = down(kCenter[axis] + kRadius);
+        edges.Add(p[0], p[1], p[2], Inside, DontCare);
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        float p[3] = {0.0f, 0.0f, 0.0f};
+        p[axis] = kMins[axis];
+        edges.Add(p[0], p[1], p[2], DontCare, Inside);
+        p[axis] = kMaxs[axis];
+        edges.Add(p[0], p[1], p[2], DontCare, Inside);
+        p[axis] = down(kMins[axis]);
+        edges.Add(p[0], p[1], p[2], DontCare, Outside);
+        p[axis] = up(kMaxs[axis]);
+        edges.Add(p[0], p[1], p[2], DontCare, Outside);
+    }
+    edges.Add(kMins[0], kMins[1], kMins[2], DontCare, Inside);
+    edges.Add(kMaxs[0], kMaxs[1], kMaxs[2], DontCare, Inside);
+    edges.Add(kCenter[0], kCenter[1], kCenter[2], Inside, Outside);
+    edges.Add(-0.0f, -0.0f, -0.0f, Inside, Inside);
+    edges.Add(nan, kCenter[1], kCenter[2], Outside, Outside);
+    edges.Add(0.0f, nan, 0.0f, Outside, Outside);
+    edges.Add(inf, 0.0f, 0.0f, Outside, Outside);
+    edges.Add(0.0f, 0.0f, -inf, Outside, Outside);
+
+    // Prefixes of 1, 7, 9, 17 points and the full 32 exercise every tail length
+    for (size_t length : {size_t(1), size_t(7), size_t(9), size_t(17), edges.x.size()}) {
+        PointSet prefix;
+        for (size_t i = 0; i < length; i++) {
+            prefix.Add(edges.x[i], edges.y[i], edges.z[i], Verdict(edges.inSphere[i]), Verdict(edges.inBox[i]));
+        }
+        std::vector<uint32_t> sphereHits, boxHits;
+        CheckAllLevels(prefix, sphereHits, boxHits);
+        CHECK(MatchesVerdicts(prefix.inSphere, sphereHits));
+        CHECK(MatchesVerdicts(prefix.inBox, boxHits));
+    }
+
+    // A negative or NaN radius and an inverted box match nothing
+    const size_t edgeCount = edges.x.size();
+    std::vector<uint32_t> none(edgeCount);
+    const float inverted[3] = {1.0f, 1.0f, 1.0f}, origin[3] = {0.0f, 0.0f, 0.0f};
+    const float *x = edges.x.data(), *y = edges.y.data(), *z = edges.z.data();
+    CHECK(SelectPointsInSphere(x, y, z, edgeCount, kCenter, -1.0f, none.data()) == 0);
+    CHECK(SelectPointsInSphere(x, y, z, edgeCount, kCenter, nan, none.data()) == 0);
+    CHECK(SelectPointsInBox(x, y, z, edgeCount, inverted, origin, none.data()) == 0);
+}
+
+// Random points around the query shapes, every level timed on the same data
+static void TestRandomPoints(size_t count) {
+    std::mt19937 rng(8086);
+    std::uniform_real_distribution<float> coord(-4096.0f, 4096.0f);
+    PointSet random;
+    for (size_t i = 0; i < count; i++) random.Add(coord(rng), coord(rng), coord(rng), DontCare, DontCare);
+
+    std::vector<uint32_t> sphereHits, boxHits;
+    CheckAllLevels(random, sphereHits, boxHits);
+    CHECK(!sphereHits.empty());  // The box is flat, so random points miss it
+
+    double levelMs[3] = {};
+    std::vector<uint32_t> out(count);
+    for (int level = 0; level < 3; level++) {
+        if (level > static_cast<int>(DetectSimdLevel())) continue;
+        auto start = std::chrono::high_resolution_clock::now();
+        SelectPointsInSphere(random.x.data(), random.y.data(), random.z.data(), count, kCenter, kRadius,
+                             out.data(), static_cast<SimdLevel>(level));
+        levelMs[level] = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    std::printf("%zu points: scalar %.3f ms, SSE %.3f ms, AVX2 %.3f ms\n", count, levelMs[0], levelMs[1], levelMs[2]);
+}
+
+int main() {
+    TestEdges();
+    TestRandomPoints(100000);
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all point kernel checks passed\n");
+    return 0;
+}
@@ -0,0 +1,185 @@
+// Standalone tests for MeshBuilder::ClassifyRegions: the grid classifier
+// must produce the same partition as a brute-force pairwise union, and far
+// clusters must be flagged separate. Exits non-zero on a failed check.
+#include "mesh_builder/region_classifier.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace MeshBuilder;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+// A few clusters spread over the map, some far off like a skybox
+static std::vector<float> ClusteredBoxes(size_t faceCount) {
+    std::mt19937 rng(1337);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> extent(4.0f, 256.0f);
+    const float clusterCenters[][3] = {
+        {0, 0, 0}, {6000, 0, 0}, {0, -9000, 2000}, {-12000, 12000, -8000}, {14000, 14000, 14000}
+    };
+    const size_t clusterCount = sizeof(clusterCenters) / sizeof(clusterCenters[0]);
+
+    std::vector<float> boxes(faceCount * 6);
+    for (size_t f = 0; f < faceCount; f++) {
+        size_t cluster = f % 4 == 0 ? 1 + (f / 4) % (clusterCount - 1) : 0;
+        const float* c = clusterCenters[cluster];
+        float spread = cluster == 0 ? 4000.0f : 1200.0f;
+        float* box = boxes.data() + f * 6;
+        for (int axis = 0; axis < 3; axis++) {
+            float center = c[axis] + unit(rng) * spread;
+            float half = extent(rng);
+            box[axis] = center - half;
+            box[axis + 3] = center + half;
+        }
+    }
+    if (faceCount > 2) boxes[6] = NAN;  // One face with broken bounds
+    return boxes;
+}
+
+// Reference: faces whose half-gap expanded boxes cover a common grid cell
+// are unioned pairwise. Returns each face's root, or -1 for invalid bounds.
+static std::vector<int64_t> BruteForceRoots(const std::vector<float>& boxes, const RegionOptions& options) {
+    const size_t faceCount = boxes.size() / 6;
+    const float gap = std::max(options.gap, 64.0f);
+    std::vector<int32_t> cells(faceCount * 6);
+    std::vector<bool> valid(faceCount);
+    for (size_t f = 0; f < faceCount; f++) {
+        const float* box = boxes.data() + f * 6;
+        valid[f] = true;
+        for (int i = 0; i < 6; i++) valid[f] = valid[f] && std::isfinite(box[i]);
+        for (int i = 0; i < 6; i++) {
+            float edge = i < 3 ? box[i] - gap * 0.5f : box[i] + gap * 0.5f;
+            cells[f * 6 + i] = valid[f] ? static_cast<int32_t>(std::floor(edge / gap)) : 0;
+        }
+    }
+
+    std::vector<uint32_t> parent(faceCount);
+    for (size_t f = 0; f < faceCount; f++) parent[f] = static_cast<uint32_t>(f);
+    auto find = [&parent](uint32_t x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    };
+    for (size_t a = 0; a < faceCount; a++) {
+        if (!valid[a]) continue;
+        const int32_t* ca = cells.data() + a * 6;
+        for (size_t b = a + 1; b < faceCount; b++) {
+            if (!valid[b]) continue;
+            const int32_t* cb = cells.data() + b * 6;
+            if (ca[0] <= cb[3] && cb[0] <= ca[3] && ca[1] <= cb[4] && cb[1] <= ca[4] &&
+                ca[2] <= cb[5] && cb[2] <= ca[5]) {
+                parent[find(static_cast<uint32_t>(a))] = find(static_cast<uint32_t>(b));
+            }
+        }
+    }
+
+    std::vector<int64_t> roots(faceCount);
+    for (size_t f = 0; f < faceCount; f++) {
+        roots[f] = valid[f] ? static_cast<int64_t>(find(static_cast<uint32_t>(f))) : -1;
+    }
+    return roots;
+}
+
+static void TestMatchesBruteForce(size_t faceCount) {
+    const std::vector<float> boxes = ClusteredBoxes(faceCount);
+    RegionOptions options;
+    RegionClassification result;
+    ClassifyRegions(boxes.data(), faceCount, options, result);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const std::vector<int64_t> roots = BruteForceRoots(boxes, options);
+    double bruteMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    // Same partition: each reference set maps to exactly one region and back
+    CHECK(result.faceRegions.size() == faceCount);
+    if (result.faceRegions.size() != faceCount) return;
+
+    std::unordered_map<int64_t, uint32_t> rootToRegion;
+    std::unordered_map<uint32_t, int64_t> regionToRoot;
+    std::vector<uint32_t> counts(result.regions.size(), 0);
+    size_t mismatches = 0;
+    for (size_t f = 0; f < faceCount; f++) {
+        uint32_t region = result.faceRegions[f];
+        if (roots[f] < 0) {
+            CHECK(region == RegionClassification::InvalidRegion);
+            CHECK(!result.IsSeparate(f));
+            continue;
+        }
+        if (region >= result.regions.size()) {
+            mismatches++;
+            continue;
+        }
+        if (rootToRegion.emplace(roots[f], region).first->second != region ||
+            regionToRoot.emplace(region, roots[f]).first->second != roots[f]) {
+            mismatches++;
+        }
+        counts[region]++;
+    }
+    CHECK(mismatches == 0);
+
+    size_t separate = 0;
+    for (size_t i = 0; i < result.regions.size(); i++) {
+        CHECK(counts[i] == result.regions[i].faceCount);
+        CHECK(i == 0 || result.regions[i].faceCount <= result.regions[i - 1].faceCount);
+        separate += result.regions[i].separate ? 1 : 0;
+    }
+    CHECK(!result.regions.empty() && !result.regions[0].separate);
+    CHECK(separate > 0);
+
+    std::printf("%zu faces, %zu regions (%zu separate), grid %.2f ms, brute force %.2f ms\n", faceCount,
+                result.regions.size(), separate, result.milliseconds, bruteMs);
+}
+
+static void AddBox(std::vector<float>& boxes, float x, float y, float z, float half) {
+    boxes.insert(boxes.end(), {x - half, y - half, z - half, x + half, y + half, z + half});
+}
+
+static void TestSeparateIsland() {
+    // A row of touching faces and a small island far away
+    std::vector<float> boxes;
+    for (int i = 0; i < 20; i++) AddBox(boxes, i * 200.0f, 0.0f, 0.0f, 100.0f);
+    for (int i = 0; i < 3; i++) AddBox(boxes, 50000.0f + i * 10.0f, 0.0f, 0.0f, 5.0f);
+
+    RegionClassification result;
+    ClassifyRegions(boxes.data(), boxes.size() / 6, RegionOptions(), result);
+    CHECK(result.regions.size() == 2);
+    if (result.regions.size() != 2) return;
+    CHECK(result.regions[0].faceCount == 20 && !result.regions[0].separate);
+    CHECK(result.regions[1].faceCount == 3 && result.regions[1].separate);
+    CHECK(!result.IsSeparate(0) && !result.IsSeparate(19));
+    CHECK(result.IsSeparate(20) && result.IsSeparate(22));
+    CHECK(!result.IsSeparate(23));
+
+    // A larger separation distance keeps the island
+    RegionOptions wide;
+    wide.separationDistance = 100000.0f;
+    ClassifyRegions(boxes.data(), boxes.size() / 6, wide, result);
+    CHECK(result.regions.size() == 2 && !result.IsSeparate(20));
+
+    ClassifyRegions(nullptr, 0, RegionOptions(), result);
+    CHECK(result.regions.empty() && result.faceRegions.empty());
+}
+
+int main() {
+    TestMatchesBruteForce(4000);
+    TestSeparateIsland();
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all region classifier checks passed\n");
+    return 0;
+}
@@ -0,0 +1,277 @@
+// Headless tests for the direct Remix world mesh path: chunk meshes built
+// from a synthetic map are submitted through a recording fake of the Remix
+// interface, and every create, draw and destroy is checked, including
+// material sharing and the batched material release. Exits non-zero on a
+// failed check.
+#include "entity_manager/remix_world_meshes.hpp"
+#include "mesh_builder/chunk_builder.hpp"
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace EntityManager;
+
+// The module's global; the classes under test are always handed the fake
+remix::Interface* g_remix = nullptr;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+// Stand-in for the Remix runtime that hands out fake handles and records
+// every call, so the submission path can be checked without a GPU
+namespace {
+    struct RecordedMesh {
+        uint64_t hash;
+        uint32_t surfaces;
+        uint64_t vertices;
+        uint64_t indices;
+        bool indicesInRange;
+        remixapi_MaterialHandle material;
+    };
+
+    struct RemixCallRecorder {
+        std::unordered_map<remixapi_MeshHandle, RecordedMesh> live;
+        std::vector<remixapi_MeshHandle> created;
+        std::vector<remixapi_MeshHandle> destroyed;
+        std::vector<remixapi_MeshHandle> drawn;
+        std::unordered_map<remixapi_MaterialHandle, uint64_t> liveMaterials;  // Handle -> hash
+        size_t materialsCreated = 0;
+        size_t materialsDestroyed = 0;
+        size_t badMaterialDestroys = 0;
+        size_t badDestroys = 0;
+        size_t badDraws = 0;
+        size_t badTransforms = 0;
+        uintptr_t nextHandle = 0x1000;
+        bool failCreates = false;
+    };
+
+    RemixCallRecorder* s_recorder = nullptr;
+
+    remixapi_ErrorCode REMIXAPI_CALL RecordCreateMesh(const remixapi_MeshInfo* info, remixapi_MeshHandle* out) {
+        if (s_recorder->failCreates) return REMIXAPI_ERROR_CODE_GENERAL_FAILURE;
+        if (!info || info->sType != REMIXAPI_STRUCT_TYPE_MESH_INFO || !out) {
+            return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+        }
+
+        RecordedMesh mesh = {info->hash, info->surfaces_count, 0, 0, true, nullptr};
+        for (uint32_t s = 0; s < info->surfaces_count; s++) {
+            const remixapi_MeshInfoSurfaceTriangles& surface = info->surfaces_values[s];
+            mesh.material = surface.material;
+            mesh.vertices += surface.vertices_count;
+            mesh.indices += surface.indices_count;
+            for (uint64_t i = 0; i < surface.indices_count; i++) {
+                if (surface.indices_values[i] >= surface.vertices_count) mesh.indicesInRange = false;
+            }
+        }
+
+        remixapi_MeshHandle handle = reinterpret_cast<remixapi_MeshHandle>(s_recorder->nextHandle);
+        s_recorder->nextHandle += 0x10;
+        s_recorder->live[handle] = mesh;
+        s_recorder->created.push_back(handle);
+        *out = handle;
+        return REMIXAPI_ERROR_CODE_SUCCESS;
+    }
+
+    remixapi_ErrorCode REMIXAPI_CALL RecordDestroyMesh(remixapi_MeshHandle handle) {
+        if (s_recorder->live.erase(handle) == 0) {
+            s_recorder->badDestroys++;
+            return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+        }
+        s_recorder->destroyed.push_back(handle);
+        return REMIXAPI_ERROR_CODE_SUCCESS;
+    }
+
+    remixapi_ErrorCode REMIXAPI_CALL RecordCreateMaterial(const remixapi_MaterialInfo* info,
+                                                         remixapi_MaterialHandle* out) {
+        if (!info || info->sType != REMIXAPI_STRUCT_TYPE_MATERIAL_INFO || !info->pNext || !out) {
+            return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+        }
+
+        remixapi_MaterialHandle handle = reinterpret_cast<remixapi_MaterialHandle>(s_recorder->nextHandle);
+        s_recorder->nextHandle += 0x10;
+        s_recorder->liveMaterials[handle] = info->hash;
+        s_recorder->materialsCreated++;
+        *out = handle;
+        return REMIXAPI_ERROR_CODE_SUCCESS;
+    }
+
+    // Destroying a material a live mesh still uses counts as a bad destroy
+    remixapi_ErrorCode REMIXAPI_CALL RecordDestroyMaterial(remixapi_MaterialHandle handle) {
+        bool inUse = false;
+        for (const auto& [mesh, recorded] : s_recorder->live) {
+            inUse |= recorded.material == handle;
+        }
+        if (inUse || s_recorder->liveMaterials.erase(handle) == 0) {
+            s_recorder->badMaterialDestroys++;
+            return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+        }
+        s_recorder->materialsDestroyed++;
+        return REMIXAPI_ERROR_CODE_SUCCESS;
+    }
+
+    remixapi_ErrorCode REMIXAPI_CALL RecordDrawInstance(const remixapi_InstanceInfo* info) {
+        if (!info || s_recorder->live.find(info->mesh) == s_recorder->live.end()) {
+            s_recorder->badDraws++;
+            return REMIXAPI_ERROR_CODE_INVALID_ARGUMENTS;
+        }
+
+        bool identity = true;
+        for (int row = 0; row < 3; row++) {
+            for (int col = 0; col < 4; col++) {
+                identity &= info->transform.matrix[row][col] == (row == col ? 1.0f : 0.0f);
+            }
+        }
+        if (!identity) s_recorder->badTransforms++;
+
+        s_recorder->drawn.push_back(info->mesh);
+        return REMIXAPI_ERROR_CODE_SUCCESS;
+    }
+}
+
+static void TestSubmission(size_t faceCount) {
+    BSPReader::WorldGeometry synthetic;
+    MeshBuilder::GenerateSyntheticWorld(faceCount, 16, 1337, synthetic);
+
+    MeshBuilder::ChunkBuildOptions options;
+    options.chunkSize = 4096.0f;
+    options.weldVertices = true;
+    options.skipSkyMaterials = false;
+    options.skipSeparateRegions = false;
+    std::vector<MeshBuilder::ChunkMesh> chunks = MeshBuilder::BuildChunkMeshes(synthetic, options, nullptr);
+    CHECK(!chunks.empty());
+    if (chunks.empty()) return;
+
+    RemixCallRecorder recorder;
+    s_recorder = &recorder;
+
+    remix::Interface fake;
+    fake.m_CInterface.CreateMesh = RecordCreateMesh;
+    fake.m_CInterface.DestroyMesh = RecordDestroyMesh;
+    fake.m_CInterface.DrawInstance = RecordDrawInstance;
+    fake.m_CInterface.CreateMaterial = RecordCreateMaterial;
+    fake.m_CInterface.DestroyMaterial = RecordDestroyMaterial;
+
+    {
+        RemixMaterialCache materials(&fake);
+        RemixWorldMeshes meshes(&fake, &materials);
+        CHECK(meshes.IsAvailable());
+
+        size_t expectedVertices = 0, expectedIndices = 0;
+        std::unordered_set<uint64_t> hashes;
+        std::unordered_map<uint32_t, remixapi_MaterialHandle> streamMaterials;
+        for (size_t i = 0; i < chunks.size(); i++) {
+            const MeshBuilder::ChunkMesh& chunk = chunks[i];
+            const BSPReader::MaterialStream& stream = synthetic.materials[chunk.material];
+            uint64_t hash = ChunkMeshHash(chunk.chunkKey, chunk.material, chunk.part);
+            hashes.insert(hash);
+            CHECK(meshes.CreateChunkMesh(static_cast<uint32_t>(i), hash, chunk.vertices.data(),
+                                         chunk.vertices.size(), chunk.indices, stream.material,
+                                         (stream.surfaceFlags & BSPReader::SURF_TRANS) != 0));
+
+            const RecordedMesh& recorded = recorder.live[recorder.created.back()];
+            size_t indexCount = chunk.indices.Empty() ? chunk.vertices.size() : chunk.indices.Size();
+            CHECK(recorded.hash == hash && recorded.surfaces == 1);
+
+            // Every chunk of a material shares one handle whose hash is the name's
+            auto known = streamMaterials.emplace(chunk.material, recorded.material).first;
+            CHECK(recorded.material && known->second == recorded.material);
+            CHECK(recorder.liveMaterials[recorded.material] == RemixMaterialCache::HashName(stream.material));
+            CHECK(recorded.vertices == chunk.vertices.size() && recorded.indices == indexCount);
+            CHECK(recorded.indicesInRange);
+            expectedVertices += chunk.vertices.size();
+            expectedIndices += indexCount;
+        }
+        CHECK(hashes.size() == chunks.size());
+        CHECK(recorder.created.size() == chunks.size());
+        CHECK(meshes.GetStats().vertices == expectedVertices && meshes.GetStats().indices == expectedIndices);
+
+        // One material per name, every other lookup a hit
+        RemixMaterialCache::Stats materialStats = materials.GetStats();
+        CHECK(recorder.materialsCreated == streamMaterials.size());
+        CHECK(materialStats.misses == streamMaterials.size());
+        CHECK(materialStats.hits == chunks.size() - streamMaterials.size());
+
+        // Every other chunk plus an id without a mesh, which must be skipped
+        std::vector<uint32_t> list;
+        for (uint32_t i = 0; i < chunks.size(); i += 2) list.push_back(i);
+        list.push_back(static_cast<uint32_t>(chunks.size()) + 5);
+
+        recorder.drawn.clear();
+        size_t drawn = meshes.DrawChunks(list.data(), list.size());
+        CHECK(drawn == list.size() - 1 && recorder.drawn.size() == drawn);
+        for (size_t i = 0; i + 1 < list.size() && i < recorder.drawn.size(); i++) {
+            CHECK(recorder.drawn[i] == recorder.created[list[i]]);
+        }
+
+        recorder.drawn.clear();
+        CHECK(meshes.DrawAll() == chunks.size() && recorder.drawn.size() == chunks.size());
+
+        // Rejected creates must not leave a handle behind
+        recorder.failCreates = true;
+        const uint32_t extra = static_cast<uint32_t>(chunks.size());
+        CHECK(!meshes.CreateChunkMesh(extra, 1, chunks[0].vertices.data(), chunks[0].vertices.size(),
+                                      chunks[0].indices, synthetic.materials[chunks[0].material].material, false));
+        CHECK(!meshes.HasChunkMesh(extra) && meshes.GetStats().failed == 1);
+        recorder.failCreates = false;
+
+        // Replacing a chunk's mesh destroys the old one
+        const remixapi_MeshHandle replaced = recorder.created[0];
+        CHECK(meshes.CreateChunkMesh(0, 2, chunks[0].vertices.data(), chunks[0].vertices.size(),
+                                     chunks[0].indices, synthetic.materials[chunks[0].material].material, false));
+        CHECK(recorder.destroyed.size() == 1 && recorder.destroyed[0] == replaced);
+        CHECK(meshes.GetStats().meshes == chunks.size());
+
+        meshes.Clear();
+        CHECK(recorder.live.empty() && recorder.destroyed.size() == recorder.created.size());
+
+        // Released materials stay cached until the batch destroy
+        materialStats = materials.GetStats();
+        CHECK(recorder.materialsDestroyed == 0);
+        CHECK(materialStats.live == streamMaterials.size() && materialStats.referenced == 0);
+        CHECK(materials.DestroyUnused() == streamMaterials.size() && recorder.liveMaterials.empty());
+
+        recorder.drawn.clear();
+        CHECK(meshes.DrawAll() == 0 && recorder.drawn.empty());
+    }
+
+    CHECK(recorder.badDestroys == 0);
+    CHECK(recorder.badDraws == 0);
+    CHECK(recorder.badMaterialDestroys == 0);
+    CHECK(recorder.badTransforms == 0);
+    s_recorder = nullptr;
+
+    std::printf("%zu chunk meshes, %zu creates, %zu destroys, %zu materials\n", chunks.size(),
+                recorder.created.size(), recorder.destroyed.size(), recorder.materialsCreated);
+}
+
+// Without an interface nothing is created or drawn
+static void TestUnavailable() {
+    RemixWorldMeshes meshes;
+    CHECK(!meshes.IsAvailable());
+
+    BSPReader::TriangleVertex vertex = {};
+    MeshBuilder::IndexBuffer indices;
+    CHECK(!meshes.CreateChunkMesh(0, 1, &vertex, 1, indices, "DEV/FLOOR", false));
+    CHECK(!meshes.HasChunkMesh(0) && meshes.DrawAll() == 0);
+}
+
+int main() {
+    TestSubmission(20000);
+    TestUnavailable();
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all Remix world mesh checks passed\n");
+    return 0;
+}
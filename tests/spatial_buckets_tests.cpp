@@ -0,0 +1,135 @@
+// Standalone tests for RTXMath::BucketPointsByCell: the radix grouping must
+// match a map-based grouping of the same points, bucket for bucket and in
+// input order within a bucket. Exits non-zero on a failed check.
+#include "math/spatial_buckets.hpp"
+#include "math/chunk_key.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace RTXMath;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+static void TestChunkKeys() {
+    const int32_t coords[][3] = {
+        {0, 0, 0}, {-1, 0, 1}, {kMinChunkCoord, kMinChunkCoord, kMinChunkCoord},
+        {kMaxChunkCoord, kMaxChunkCoord, kMaxChunkCoord}, {12, -345, 6789}
+    };
+    for (const auto& c : coords) {
+        int32_t x, y, z;
+        UnpackChunkKey(PackChunkKey(c[0], c[1], c[2]), x, y, z);
+        CHECK(x == c[0] && y == c[1] && z == c[2]);
+    }
+
+    // Keys sort by x, then y, then z
+    CHECK(PackChunkKey(-1, 100, 100) < PackChunkKey(0, -100, -100));
+    CHECK(PackChunkKey(0, -1, 100) < PackChunkKey(0, 0, -100));
+    CHECK(PackChunkKey(0, 0, -1) < PackChunkKey(0, 0, 0));
+
+    int32_t coord = 0;
+    CHECK(ToChunkCoord(-0.5f, 1.0f, coord) && coord == -1);
+    CHECK(ToChunkCoord(4096.0f, 1.0f / 4096.0f, coord) && coord == 1);
+    CHECK(!ToChunkCoord(NAN, 1.0f, coord));
+    CHECK(!ToChunkCoord(static_cast<float>(kMaxChunkCoord + 1), 1.0f, coord));
+}
+
+static void TestMatchesMap(size_t count) {
+    using Clock = std::chrono::high_resolution_clock;
+
+    // Negative coordinates, points on cell edges, a NaN and a point whose
+    // cell has no key
+    std::mt19937 rng(1337);
+    std::uniform_real_distribution<float> coord(-16384.0f, 16384.0f);
+    const float cellSize = 4096.0f;
+    std::vector<float> points(count * 3);
+    for (size_t i = 0; i < points.size(); i++) {
+        points[i] = i % 7 == 0 ? std::floor(coord(rng) / cellSize) * cellSize : coord(rng);
+    }
+    points[3] = NAN;
+    points[6] = static_cast<float>(kMaxChunkCoord + 1) * cellSize;
+
+    auto start = Clock::now();
+    BucketResult result;
+    BucketPointsByCell(points.data(), count, cellSize, result);
+    double bucketMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    std::map<std::tuple<int, int, int>, std::vector<uint32_t>> reference;
+    for (size_t i = 0; i < count; i++) {
+        const float* p = points.data() + i * 3;
+        if (!std::isfinite(p[0]) || !std::isfinite(p[1]) || !std::isfinite(p[2])) continue;
+        double cell[3];
+        for (int axis = 0; axis < 3; axis++) cell[axis] = std::floor(static_cast<double>(p[axis]) / cellSize);
+        if (*std::min_element(cell, cell + 3) < kMinChunkCoord || *std::max_element(cell, cell + 3) > kMaxChunkCoord) {
+            continue;
+        }
+        reference[{static_cast<int>(cell[0]), static_cast<int>(cell[1]), static_cast<int>(cell[2])}]
+            .push_back(static_cast<uint32_t>(i));
+    }
+    double referenceMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    CHECK(result.skipped == 2);
+    CHECK(result.order.size() == count - 2);
+    CHECK(result.buckets.size() == reference.size());
+    if (result.buckets.size() != reference.size()) return;
+
+    // Both are ordered by x, y, z, so buckets line up one to one
+    size_t b = 0, mismatches = 0;
+    for (const auto& [cell, indices] : reference) {
+        const CellBucket& bucket = result.buckets[b++];
+        if (std::make_tuple(bucket.x, bucket.y, bucket.z) != cell || bucket.count != indices.size() ||
+            bucket.key != PackChunkKey(bucket.x, bucket.y, bucket.z)) {
+            mismatches++;
+            continue;
+        }
+        for (size_t i = 0; i < indices.size(); i++) {
+            if (result.order[bucket.first + i] != indices[i]) mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+
+    std::printf("%zu points, %zu cells, radix %.2f ms, map reference %.2f ms\n", count, result.buckets.size(),
+                bucketMs, referenceMs);
+}
+
+static void TestSmallInputs() {
+    BucketResult result;
+    BucketPointsByCell(nullptr, 0, 64.0f, result);
+    CHECK(result.order.empty() && result.buckets.empty() && result.skipped == 0);
+
+    // A cell size of zero falls back to unit cells
+    const float points[] = {0.5f, 0.5f, 0.5f, 1.5f, 0.0f, 0.0f, 0.25f, 0.75f, 0.0f};
+    BucketPointsByCell(points, 3, 0.0f, result);
+    CHECK(result.buckets.size() == 2);
+    if (result.buckets.size() != 2) return;
+    CHECK(result.buckets[0].x == 0 && result.buckets[0].count == 2);
+    CHECK(result.buckets[1].x == 1 && result.buckets[1].count == 1);
+    CHECK(result.order[0] == 0 && result.order[1] == 2 && result.order[2] == 1);
+}
+
+int main() {
+    TestChunkKeys();
+    TestMatchesMap(200000);
+    TestSmallInputs();
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all spatial bucket checks passed\n");
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Standalone tests for RTXMath::SpatialGrid: every query must agree with a
+// brute-force scan over random points, including moves, removals, points on
+// query edges and far outliers. Exits non-zero on a failed check.
+#include "math/spatial_grid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace RTXMath;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+static void TestMatchesScan(size_t count) {
+    std::mt19937 rng(2718);
+    std::uniform_real_distribution<float> coord(-16384.0f, 16384.0f);
+    std::uniform_real_distribution<float> jitter(-300.0f, 300.0f);
+    std::uniform_int_distribution<uint32_t> pickId(0, static_cast<uint32_t>(count * 2));
+
+    struct Point {
+        bool live = false;
+        float x, y, z;
+    };
+    std::vector<Point> reference(count * 2 + 8);
+    SpatialGrid grid(512.0f);
+
+    auto place = [&](uint32_t id, float x, float y, float z) {
+        grid.Update(id, x, y, z);
+        reference[id] = {true, x, y, z};
+    };
+
+    // Fill, then move some a little (mostly same cell), some far, and remove some
+    for (size_t i = 0; i < count; i++) place(pickId(rng), coord(rng), coord(rng), coord(rng));
+    for (size_t i = 0; i < count; i++) {
+        uint32_t id = pickId(rng);
+        if (!reference[id].live) continue;
+        switch (i % 4) {
+            case 0: place(id, reference[id].x + jitter(rng), reference[id].y + jitter(rng), reference[id].z); break;
+            case 1: place(id, coord(rng), coord(rng), coord(rng)); break;
+            case 2: CHECK(grid.Remove(id)); reference[id].live = false; break;
+            default: break;
+        }
+    }
+
+    // Exact edge cases: on a cell boundary, on the radius, past the key range, and a NaN
+    const float center[3] = {512.0f, -512.0f, 0.0f};
+    const float radius = 1536.0f;
+    const uint32_t extra = static_cast<uint32_t>(reference.size() - 8);
+    place(extra, center[0] + radius, center[1], center[2]);
+    place(extra + 1, 1024.0f, -1024.0f, 0.0f);
+    place(extra + 2, 1.0e12f, 0.0f, 0.0f);
+    place(extra + 3, -1.0e12f, -1.0e12f, 5.0f);
+    grid.Update(extra + 4, NAN, 0.0f, 0.0f);
+    CHECK(!grid.Contains(extra + 4));
+    CHECK(grid.Contains(extra + 2) && grid.Contains(extra + 3));
+
+    size_t live = 0;
+    for (const Point& point : reference) live += point.live ? 1 : 0;
+    CHECK(grid.Size() == live);
+
+    auto distanceSqr = [&](const Point& p) {
+        float dx = p.x - center[0], dy = p.y - center[1], dz = p.z - center[2];
+        return dx * dx + dy * dy + dz * dz;
+    };
+
+    std::vector<uint32_t> ids, expected;
+
+    grid.QueryRadius(center, radius, ids);
+    for (uint32_t id = 0; id < reference.size(); id++) {
+        if (reference[id].live && distanceSqr(reference[id]) <= radius * radius) expected.push_back(id);
+    }
+    std::sort(ids.begin(), ids.end());
+    CHECK(ids == expected);
+    CHECK(std::binary_search(ids.begin(), ids.end(), extra));
+
+    const float mins[3] = {-1024.0f, -1024.0f, -1.0e13f};
+    const float maxs[3] = {1024.0f, 4096.0f, 1.0e13f};
+    expected.clear();
+    grid.QueryBox(mins, maxs, ids);
+    for (uint32_t id = 0; id < reference.size(); id++) {
+        const Point& p = reference[id];
+        if (p.live && p.x >= mins[0] && p.x <= maxs[0] && p.y >= mins[1] && p.y <= maxs[1] &&
+            p.z >= mins[2] && p.z <= maxs[2]) {
+            expected.push_back(id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    CHECK(ids == expected);
+    CHECK(std::binary_search(ids.begin(), ids.end(), extra + 1));
+
+    // Nearest: plain, capped by distance, and more than there are points
+    std::vector<std::pair<float, uint32_t>> sorted;
+    for (uint32_t id = 0; id < reference.size(); id++) {
+        if (reference[id].live) sorted.push_back({distanceSqr(reference[id]), id});
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    const size_t ks[] = {1, 16, 100, live + 5};
+    for (size_t k : ks) {
+        for (float maxDistance : {FLT_MAX, 4000.0f}) {
+            expected.clear();
+            for (const auto& [distSqr, id] : sorted) {
+                if (expected.size() == k) break;
+                if (distSqr <= maxDistance * maxDistance) expected.push_back(id);
+            }
+            grid.QueryNearest(center, k, ids, maxDistance);
+            CHECK(ids == expected);
+        }
+    }
+
+    grid.Clear();
+    grid.QueryNearest(center, 4, ids);
+    CHECK(ids.empty());
+    CHECK(grid.Size() == 0 && grid.CellCount() == 0);
+}
+
+static void TestCellSize() {
+    // Invalid sizes fall back to the default; changing the size drops every point
+    SpatialGrid grid(0.0f);
+    CHECK(grid.CellSize() == 1024.0f);
+    grid.SetCellSize(NAN);
+    CHECK(grid.CellSize() == 1024.0f);
+
+    grid.Update(3, 10.0f, 10.0f, 10.0f);
+    CHECK(grid.Size() == 1);
+    grid.SetCellSize(256.0f);
+    CHECK(grid.CellSize() == 256.0f);
+    CHECK(grid.Size() == 0 && !grid.Contains(3));
+    CHECK(!grid.Remove(3));
+}
+
+int main() {
+    TestMatchesScan(20000);
+    TestCellSize();
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all spatial grid checks passed\n");
+    return 0;
+}
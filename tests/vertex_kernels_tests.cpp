@@ -0,0 +1,158 @@
+// Standalone tests for the SIMD vertex kernels: every level the CPU supports
+// must match the scalar reference bit for bit, including the unaligned tails
+// and aliased outputs. Prints per-level timings. Exits non-zero on a failed
+// check.
+#include "math/vertex_kernels.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace RTXMath;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+using Clock = std::chrono::high_resolution_clock;
+
+static const Matrix3x4 kMatrix = {{{0.8f, -0.6f, 0.0f, 128.0f}, {0.6f, 0.8f, 0.0f, -64.0f}, {0.0f, 0.0f, 1.0f, 32.0f}}};
+
+// Separate x/y/z arrays
+struct Points {
+    std::vector<float> x, y, z;
+
+    explicit Points(size_t count = 0) : x(count), y(count), z(count) {}
+    bool operator==(const Points& other) const { return x == other.x && y == other.y && z == other.z; }
+};
+
+// Runs every kernel of one level over xyz
+struct LevelOutput {
+    Points split, transformed, directions, normalized, aliased;
+    std::vector<float> joined;
+    float mins[3], maxs[3];
+};
+
+static LevelOutput RunKernels(const VertexKernels& kernels, const std::vector<float>& xyz) {
+    const size_t count = xyz.size() / 3;
+    LevelOutput out;
+    out.split = Points(count);
+    kernels.deinterleave(xyz.data(), count, out.split.x.data(), out.split.y.data(), out.split.z.data());
+
+    out.joined.resize(count * 3);
+    kernels.interleave(out.split.x.data(), out.split.y.data(), out.split.z.data(), count, out.joined.data());
+
+    out.transformed = Points(count);
+    kernels.transformPoints(kMatrix, out.split.x.data(), out.split.y.data(), out.split.z.data(), count,
+                            out.transformed.x.data(), out.transformed.y.data(), out.transformed.z.data());
+
+    out.directions = Points(count);
+    kernels.transformDirections(kMatrix, out.split.x.data(), out.split.y.data(), out.split.z.data(), count,
+                                out.directions.x.data(), out.directions.y.data(), out.directions.z.data());
+
+    out.aliased = out.split;
+    kernels.transformPoints(kMatrix, out.aliased.x.data(), out.aliased.y.data(), out.aliased.z.data(), count,
+                            out.aliased.x.data(), out.aliased.y.data(), out.aliased.z.data());
+
+    out.normalized = out.split;
+    kernels.renormalize(out.normalized.x.data(), out.normalized.y.data(), out.normalized.z.data(), count);
+
+    kernels.computeBounds(out.split.x.data(), out.split.y.data(), out.split.z.data(), count, out.mins, out.maxs);
+    return out;
+}
+
+static void TestLevelsMatchScalar() {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(-16384.0f, 16384.0f);
+
+    // Counts that leave every tail length for 4- and 8-wide loops
+    for (size_t count : {0, 1, 3, 7, 8, 9, 15, 1003}) {
+        std::vector<float> xyz(count * 3);
+        for (float& v : xyz) v = dist(gen);
+        // A zero vector renormalize must leave alone
+        if (count > 2) std::fill(xyz.begin() + 3, xyz.begin() + 6, 0.0f);
+
+        const LevelOutput reference = RunKernels(GetVertexKernels(SimdLevel::Scalar), xyz);
+        CHECK(reference.joined == xyz);
+        CHECK(reference.aliased == reference.transformed);
+        if (count > 2) CHECK(reference.normalized.x[1] == 0.0f && reference.normalized.z[1] == 0.0f);
+        if (count == 0) CHECK(reference.mins[0] == FLT_MAX && reference.maxs[2] == -FLT_MAX);
+
+        for (int level = 1; level <= static_cast<int>(DetectSimdLevel()); level++) {
+            const VertexKernels& kernels = GetVertexKernels(static_cast<SimdLevel>(level));
+            CHECK(kernels.level == static_cast<SimdLevel>(level));
+
+            const LevelOutput out = RunKernels(kernels, xyz);
+            CHECK(out.split == reference.split);
+            CHECK(out.joined == reference.joined);
+            CHECK(out.transformed == reference.transformed);
+            CHECK(out.directions == reference.directions);
+            CHECK(out.aliased == reference.aliased);
+            CHECK(out.normalized == reference.normalized);
+            CHECK(std::equal(out.mins, out.mins + 3, reference.mins));
+            CHECK(std::equal(out.maxs, out.maxs + 3, reference.maxs));
+        }
+    }
+
+    // Requests above the CPU's level are clamped
+    CHECK(GetVertexKernels(SimdLevel::AVX2).level == DetectSimdLevel());
+    CHECK(GetVertexKernels().level == DetectSimdLevel());
+}
+
+static void TestInterleavedHelpers() {
+    std::vector<float> xyz = {3.0f, 0.0f, 4.0f, 0.0f, 0.0f, 0.0f, -2.0f, 5.0f, 1.0f};
+    float mins[3], maxs[3];
+    ComputeBoundsInterleaved(xyz.data(), 3, mins, maxs);
+    CHECK(mins[0] == -2.0f && mins[1] == 0.0f && mins[2] == 0.0f);
+    CHECK(maxs[0] == 3.0f && maxs[1] == 5.0f && maxs[2] == 4.0f);
+
+    RenormalizeInterleaved(xyz.data(), 3);
+    CHECK(xyz[0] == 0.6f && xyz[2] == 0.8f);
+    CHECK(xyz[3] == 0.0f && xyz[4] == 0.0f && xyz[5] == 0.0f);
+}
+
+// Best of a few runs of transformPoints per level; informational only
+static void PrintTimings() {
+    const size_t count = 1000000;
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> dist(-16384.0f, 16384.0f);
+    Points in(count), out(count);
+    for (size_t i = 0; i < count; i++) {
+        in.x[i] = dist(gen);
+        in.y[i] = dist(gen);
+        in.z[i] = dist(gen);
+    }
+
+    for (int level = 0; level <= static_cast<int>(DetectSimdLevel()); level++) {
+        const VertexKernels& kernels = GetVertexKernels(static_cast<SimdLevel>(level));
+        double best = 1e30;
+        for (int run = 0; run < 5; run++) {
+            auto start = Clock::now();
+            kernels.transformPoints(kMatrix, in.x.data(), in.y.data(), in.z.data(), count,
+                                    out.x.data(), out.y.data(), out.z.data());
+            best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        std::printf("transformPoints %-6s %8.3f ms for %zu points\n", SimdLevelName(kernels.level), best, count);
+    }
+}
+
+int main() {
+    TestLevelsMatchScalar();
+    TestInterleavedHelpers();
+    PrintTimings();
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all vertex kernel checks passed\n");
+    return 0;
+}
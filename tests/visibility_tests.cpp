@@ -0,0 +1,178 @@
+// Standalone tests for BSPReader::Visibility against data/sample.bsp: tree
+// walks, PVS decoding and the leaf-data cross-check ValidateChunkPVS runs in
+// game. Exits non-zero on the first failed check.
+#include "bsp_reader/visibility.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifndef SAMPLE_BSP_PATH
+#define SAMPLE_BSP_PATH "data/sample.bsp"
+#endif
+
+using namespace BSPReader;
+
+static int s_failures = 0;
+
+#define CHECK(expr)                                                              \
+    do {                                                                         \
+        if (!(expr)) {                                                           \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            s_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+// The sample's rooms are 256 units wide along x; room k is cluster k
+static const int kRooms = 12;
+static const float kRoom = 256.0f;
+
+static void TestTree(const Visibility& vis) {
+    CHECK(vis.ClusterCount() == kRooms);
+    CHECK(vis.LeafCount() == kRooms + 1);
+    CHECK(vis.RowBytes() == 2);
+
+    for (int k = 0; k < kRooms; k++) {
+        int leaf = vis.FindLeaf({k * kRoom + 100.0f, 128.0f, 128.0f});
+        CHECK(leaf == k + 1);
+        CHECK(vis.LeafCluster(leaf) == k);
+
+        Vec3 mins, maxs;
+        vis.GetLeafBounds(leaf, mins, maxs);
+        CHECK(mins.x == k * kRoom && maxs.x == (k + 1) * kRoom && maxs.z == kRoom);
+    }
+
+    // Behind the first plane is solid
+    CHECK(vis.FindLeaf({-10.0f, 0.0f, 0.0f}) == 0);
+    CHECK(vis.LeafCluster(0) == -1);
+    CHECK(vis.LeafCluster(kRooms + 1) == -1);
+}
+
+static void TestPVS(const Visibility& vis) {
+    for (int from = 0; from < kRooms; from++) {
+        for (int to = 0; to < kRooms; to++) {
+            bool neighbour = to >= from - 1 && to <= from + 1;
+            CHECK(vis.IsClusterVisible(from, to) == neighbour);
+        }
+    }
+
+    // Unknown clusters may see and be seen by anything
+    CHECK(!vis.GetPVS(-1));
+    CHECK(vis.IsClusterVisible(-1, 5));
+    CHECK(vis.IsClusterVisible(0, kRooms));
+
+    const int far[] = {5, 9};
+    const int near[] = {9, 1};
+    CHECK(!vis.IsVisibleFrom(0, far, 2));
+    CHECK(vis.IsVisibleFrom(0, near, 2));
+    CHECK(vis.IsVisibleFrom(0, nullptr, 0));
+}
+
+static void TestClustersInBox(const Visibility& vis) {
+    std::vector<int> clusters;
+    vis.GetClustersInBox({600.0f, 10.0f, 10.0f}, {1100.0f, 20.0f, 20.0f}, clusters);
+    CHECK((clusters == std::vector<int>{2, 3, 4}));
+
+    // Boxes on a splitting plane descend both sides
+    vis.GetClustersInBox({512.0f, 0.0f, 0.0f}, {512.0f, 10.0f, 10.0f}, clusters);
+    CHECK((clusters == std::vector<int>{1, 2}));
+
+    vis.GetClustersInBox({-500.0f, 0.0f, 0.0f}, {-100.0f, 10.0f, 10.0f}, clusters);
+    CHECK(clusters.empty());
+}
+
+// Flattened tree-walk clusters for a set of boxes, as world_culling keeps them
+struct Boxes {
+    std::vector<Vec3> mins, maxs;
+    std::vector<uint32_t> clusterStart = {0};
+    std::vector<int> clusters;
+
+    void Add(const Visibility& vis, const Vec3& boxMins, const Vec3& boxMaxs) {
+        std::vector<int> walked;
+        vis.GetClustersInBox(boxMins, boxMaxs, walked);
+        mins.push_back(boxMins);
+        maxs.push_back(boxMaxs);
+        clusters.insert(clusters.end(), walked.begin(), walked.end());
+        clusterStart.push_back(static_cast<uint32_t>(clusters.size()));
+    }
+
+    PVSCheck Check(const Visibility& vis, int maxClusters) const {
+        return CheckBoxPVS(vis, mins.data(), maxs.data(), mins.size(), clusterStart.data(), clusters.data(),
+                           maxClusters);
+    }
+};
+
+static void TestCheckBoxPVS(const Map& map, const Visibility& vis) {
+    // The decoded world faces stand in for chunks, plus boxes spanning rooms
+    // and one entirely in solid
+    WorldGeometry world;
+    CHECK(map.DecodeWorld(world));
+
+    Boxes boxes;
+    for (const auto& stream : world.materials) {
+        for (const auto& face : stream.faces) boxes.Add(vis, face.mins, face.maxs);
+    }
+    boxes.Add(vis, {300.0f, 10.0f, 10.0f}, {1500.0f, 200.0f, 200.0f});
+    boxes.Add(vis, {0.0f, 0.0f, 0.0f}, {kRooms * kRoom, kRoom, kRoom});
+    boxes.Add(vis, {-600.0f, 0.0f, 0.0f}, {-300.0f, 10.0f, 10.0f});
+    CHECK(boxes.mins.size() == 15);
+
+    PVSCheck check = boxes.Check(vis, 256);
+    CHECK(check.Passed());
+    CHECK(check.compared == kRooms * boxes.mins.size());
+    CHECK(check.matching == check.compared);
+    CHECK(check.missingFromLeaves == 0);
+
+    // Sampling spreads the camera clusters over the map
+    check = boxes.Check(vis, 4);
+    CHECK(check.Passed());
+    CHECK(check.compared == 4 * boxes.mins.size());
+
+    // A walk that reports a far cluster for a box fails both ways
+    Boxes wrong;
+    wrong.mins = {{100.0f, 10.0f, 10.0f}};
+    wrong.maxs = {{200.0f, 20.0f, 20.0f}};
+    wrong.clusters = {7};
+    wrong.clusterStart = {0, 1};
+    check = wrong.Check(vis, 256);
+    CHECK(!check.Passed());
+    CHECK(check.missingFromLeaves == 1);
+    CHECK(check.looser == 3);   // Seen from 6..8 although room 0 is not
+    CHECK(check.tighter == 2);  // Hidden from 0 and 1 although room 0 is seen
+}
+
+int main(int argc, char** argv) {
+    const std::string path = argc > 1 ? argv[1] : SAMPLE_BSP_PATH;
+
+    Map map;
+    std::string error;
+    if (!map.Open(path, error)) {
+        std::printf("could not open %s: %s\n", path.c_str(), error.c_str());
+        return 1;
+    }
+
+    Visibility vis;
+    if (!vis.Load(map, error)) {
+        std::printf("could not load visibility: %s\n", error.c_str());
+        return 1;
+    }
+
+    TestTree(vis);
+    TestPVS(vis);
+    TestClustersInBox(vis);
+    TestCheckBoxPVS(map, vis);
+
+    // Everything is copied out of the map
+    map.Close();
+    CHECK(vis.IsLoaded() && vis.LeafCluster(3) == 2);
+
+    vis.Clear();
+    CHECK(!vis.IsLoaded());
+    CHECK(!vis.Load(map, error));
+
+    if (s_failures) {
+        std::printf("%d check(s) failed\n", s_failures);
+        return 1;
+    }
+    std::printf("all visibility checks passed\n");
+    return 0;
+}